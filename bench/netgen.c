@@ -0,0 +1,913 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   netgen.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Synthetic network generator for benchmarking the engine.
+//
+//   Writes a SWMM input file for a dynamic wave model of any size, from a
+//   thousand to a million nodes, so that the engine's speed and memory use
+//   can be compared across versions with swmmbench.c. The same arguments
+//   always produce the same file.
+//
+//   Command line:  netgen type nodes inpFile [options]
+//
+//   type     TREE   - a dendritic sewer draining to a single outfall
+//            GRID   - a looped grid of conduits draining to one corner
+//            TUNNEL - a deep tunnel of storage shafts fed by collector
+//                     sewers with storage tanks, dewatered by a pump
+//   nodes    number of nodes in the network (links are about as many)
+//   inpFile  name of the SWMM input file written
+//
+//   options  -sub n     number of subcatchments (default nodes/10); with
+//                       none, inflow hydrographs are put at every tenth
+//                       junction instead
+//            -pol n     number of pollutants (default 0)
+//            -rules n   number of RPN control rules (default 0); each one
+//                       throttles an orifice that replaces a conduit
+//            -hours h   duration of the simulation (default 6, max 720);
+//                       the design storm lasts 2 hours, so shorter runs
+//                       end with water still in the network
+//            -step s    routing time step in seconds (default 5)
+//            -seed n    seed for the random network layout (default 1)
+//            -report n  1 to save the results of every subcatchment, node
+//                       and link to the output file (default), 0 to save
+//                       only the system results
+//
+//   Conduits are sized for the flow draining to them so that the network
+//   carries its design storm with some surcharging. The input file's
+//   PROFILE_FILE option names a JSON file with the same name as the input
+//   file, from which swmmbench reads the dynamic wave iteration counts.
+//
+//   Build with any C compiler, e.g.:  cc -O2 -o netgen netgen.c -lm
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define  TRUE          1
+#define  FALSE         0
+#define  MAXFNAME      259            // max. characters in file name
+#define  MAXNODES      10000000       // max. nodes in a network
+#define  SLOPE         0.002          // conduit slope
+#define  ROUGHNESS     0.013          // Manning's n of conduits
+#define  SUB_AREA      5.0            // subcatchment area (acres)
+#define  SUB_FLOW      5.0            // design runoff per subcatchment (cfs)
+#define  HYD_FLOW      1.0            // peak of each inflow hydrograph (cfs)
+#define  MIN_DIAM      1.0            // smallest conduit diameter (ft)
+#define  MAX_DIAM      20.0           // largest conduit diameter (ft)
+#define  TUNNEL_DIAM   6.0            // smallest tunnel diameter (ft)
+#define  SHAFT_DEPTH   150.0          // depth of a tunnel's shafts (ft)
+#define  BRANCH_SIZE   9              // collector nodes per tunnel shaft
+
+enum  NetworkTypes {TREE, GRID, TUNNEL};
+enum  GenNodeTypes {GEN_JUNCTION, GEN_STORAGE, GEN_OUTFALL};
+enum  GenLinkTypes {GEN_CONDUIT, GEN_ORIFICE, GEN_PUMP};
+
+static char* NetworkWords[] = {"TREE", "GRID", "TUNNEL", NULL};
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int     type;             // junction, storage unit or outfall
+    int     down;             // index of next node towards the outfall
+    int     outLink;          // index of link to the down node
+    double  invert;           // invert elevation (ft)
+    double  depth;            // full depth (ft)
+    double  area;             // surface area of a storage unit (ft2)
+    int     load;             // loads (subcatchments or inflows) draining to it
+    char    hasInflow;        // TRUE if node receives an inflow hydrograph
+}  TGenNode;
+
+typedef struct
+{
+    int     type;             // conduit, orifice or pump
+    int     node1;            // upstream node
+    int     node2;            // downstream node
+    double  length;           // conduit length (ft)
+    double  diam;             // diameter (ft)
+    double  offset2;          // outlet offset (ft)
+}  TGenLink;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TGenNode* Nodes;              // nodes of the network
+static TGenLink* Links;              // links of the network
+static int       Nnodes;             // number of nodes
+static int       Nlinks;             // number of links
+static int       MaxNodes;           // number of nodes requested
+static int       Nshafts;            // number of tunnel shafts
+static int*      SubNode;            // node each subcatchment drains to
+
+static int       NetworkType;        // type of network generated
+static int       Nsubcatch;          // number of subcatchments
+static int       Npolluts;           // number of pollutants
+static int       Nrules;             // number of control rules
+static int       Hours;              // simulation duration (hours)
+static int       RouteStep;          // routing time step (sec)
+static int       ReportAll;          // TRUE if all objects are reported
+static unsigned long long Seed;      // state of random number generator
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int    readOptions(int argc, char* argv[]);
+static int    createNetwork(int nodes);
+static void   addLink(int type, int node1, int node2, double length);
+static void   buildTree(void);
+static void   buildGrid(void);
+static void   buildTunnel(void);
+static void   assignLoads(void);
+static void   setElevations(void);
+static void   sizeLinks(void);
+static void   addRegulators(void);
+static int    writeInpFile(char* fname);
+static void   writeOptions(FILE* f, char* fname);
+static void   writeNodes(FILE* f);
+static void   writeLinks(FILE* f);
+static void   writeSubcatchments(FILE* f);
+static void   writeQuality(FILE* f);
+static void   writeRules(FILE* f);
+static void   writeSeries(FILE* f);
+static void   nodeName(int i, char* s);
+static void   linkName(int j, char* s);
+static double randomValue(void);
+
+//=============================================================================
+
+int  main(int argc, char *argv[])
+//
+//  Input:   argc = number of command line arguments
+//           argv = array of command line arguments
+//  Output:  returns 0 if successful, 1 otherwise
+//  Purpose: generates a synthetic network and writes it to an input file.
+//
+{
+    int nodes;
+
+    if ( argc < 4 )
+    {
+        fprintf(stderr,
+            "\nUsage: netgen TREE|GRID|TUNNEL nodes inpFile [-sub n] [-pol n]"
+            "\n              [-rules n] [-hours h] [-step s] [-seed n] [-report n]\n");
+        return 1;
+    }
+    for (NetworkType = 0; NetworkWords[NetworkType]; NetworkType++)
+    {
+        if ( strcmp(argv[1], NetworkWords[NetworkType]) == 0 ) break;
+    }
+    nodes = atoi(argv[2]);
+    if ( NetworkWords[NetworkType] == NULL || nodes < 100 || nodes > MAXNODES )
+    {
+        fprintf(stderr, "\nnetgen: invalid network type or size.\n");
+        return 1;
+    }
+    if ( !readOptions(argc, argv) )
+    {
+        fprintf(stderr, "\nnetgen: invalid option.\n");
+        return 1;
+    }
+    if ( !createNetwork(nodes) )
+    {
+        fprintf(stderr, "\nnetgen: out of memory.\n");
+        return 1;
+    }
+
+    // --- lay out the network, then size its links for the flows
+    //     draining to them
+    switch ( NetworkType )
+    {
+      case TREE:   buildTree();   break;
+      case GRID:   buildGrid();   break;
+      case TUNNEL: buildTunnel(); break;
+    }
+    assignLoads();
+    setElevations();
+    sizeLinks();
+    addRegulators();
+
+    if ( !writeInpFile(argv[3]) )
+    {
+        fprintf(stderr, "\nnetgen: could not write %s.\n", argv[3]);
+        return 1;
+    }
+    printf("\n%s network written to %s: %d nodes, %d links, "
+           "%d subcatchments, %d pollutants, %d rules\n",
+           NetworkWords[NetworkType], argv[3], Nnodes, Nlinks, Nsubcatch,
+           Npolluts, Nrules);
+    free(Nodes);
+    free(Links);
+    free(SubNode);
+    return 0;
+}
+
+//=============================================================================
+
+int readOptions(int argc, char* argv[])
+//
+//  Input:   argc = number of command line arguments
+//           argv = array of command line arguments
+//  Output:  returns TRUE if all options are valid
+//  Purpose: reads the optional command line arguments.
+//
+{
+    int i, n;
+
+    Nsubcatch = atoi(argv[2]) / 10;
+    Npolluts = 0;
+    Nrules = 0;
+    Hours = 6;
+    RouteStep = 5;
+    Seed = 1;
+    ReportAll = TRUE;
+    for (i = 4; i < argc; i++)
+    {
+        if ( i + 1 >= argc ) return FALSE;
+        n = atoi(argv[i+1]);
+        if      ( strcmp(argv[i], "-sub") == 0 )   Nsubcatch = n;
+        else if ( strcmp(argv[i], "-pol") == 0 )   Npolluts = n;
+        else if ( strcmp(argv[i], "-rules") == 0 ) Nrules = n;
+        else if ( strcmp(argv[i], "-hours") == 0 ) Hours = n;
+        else if ( strcmp(argv[i], "-step") == 0 )  RouteStep = n;
+        else if ( strcmp(argv[i], "-seed") == 0 )  Seed = (unsigned)n;
+        else if ( strcmp(argv[i], "-report") == 0 ) ReportAll = ( n > 0 );
+        else return FALSE;
+        if ( n < 0 ) return FALSE;
+        i++;
+    }
+    if ( Hours < 1 || Hours > 720 || RouteStep < 1 ) return FALSE;
+    return TRUE;
+}
+
+//=============================================================================
+
+int createNetwork(int nodes)
+//
+//  Input:   nodes = number of nodes requested
+//  Output:  returns TRUE if memory was allocated
+//  Purpose: allocates the node and link arrays.
+//
+{
+    Nnodes = 0;
+    Nlinks = 0;
+    Nshafts = 0;
+    MaxNodes = nodes;
+    Nodes = (TGenNode *) calloc(nodes, sizeof(TGenNode));
+    Links = (TGenLink *) calloc(2 * nodes, sizeof(TGenLink));
+    SubNode = (int *) calloc(Nsubcatch + 1, sizeof(int));
+    return ( Nodes != NULL && Links != NULL && SubNode != NULL );
+}
+
+//=============================================================================
+
+void addLink(int type, int node1, int node2, double length)
+//
+//  Input:   type   = link type
+//           node1  = upstream node
+//           node2  = downstream node
+//           length = conduit length (ft)
+//  Output:  none
+//  Purpose: adds a link to the network.
+//
+{
+    TGenLink* link = &Links[Nlinks];
+    link->type = type;
+    link->node1 = node1;
+    link->node2 = node2;
+    link->length = length;
+    if ( node2 == Nodes[node1].down ) Nodes[node1].outLink = Nlinks;
+    Nlinks++;
+}
+
+//=============================================================================
+
+void buildTree()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lays out a dendritic network.
+//
+//  Note:    node 0 is the outfall, which only node 1 drains to. Each other
+//           node drains to a node with a lower index, picked at random so
+//           that branches vary in length.
+{
+    int i, n;
+
+    Nnodes = MaxNodes;
+    Nodes[0].type = GEN_OUTFALL;
+    Nodes[0].down = -1;
+    for (i = 1; i < Nnodes; i++)
+    {
+        Nodes[i].type = GEN_JUNCTION;
+
+        // --- most nodes join one of the last few nodes added, which makes
+        //     long branches; the rest start a new branch off any node
+        if ( i == 1 ) n = 0;
+        else if ( i < 5 || randomValue() < 0.25 )
+            n = 1 + (int)(randomValue() * (i - 1));
+        else n = i - 1 - (int)(randomValue() * 3.0);
+        Nodes[i].down = n;
+        addLink(GEN_CONDUIT, i, n, 200.0 + 200.0 * randomValue());
+    }
+}
+
+//=============================================================================
+
+void buildGrid()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lays out a looped grid network.
+//
+//  Note:    junction (r,c) is r rows and c columns away from the corner of
+//           the grid next to the outfall (node 0). Each junction drains
+//           towards the corner along its row and then along column 0;
+//           links along the other columns close the loops.
+{
+    int side, r, c, i;
+
+    side = (int)sqrt((double)(MaxNodes - 1));
+    Nnodes = side * side + 1;
+    Nodes[0].type = GEN_OUTFALL;
+    Nodes[0].down = -1;
+    for (r = 0; r < side; r++)
+    {
+        for (c = 0; c < side; c++)
+        {
+            i = 1 + r * side + c;
+            Nodes[i].type = GEN_JUNCTION;
+            if ( c > 0 )      Nodes[i].down = i - 1;
+            else if ( r > 0 ) Nodes[i].down = i - side;
+            else              Nodes[i].down = 0;
+            addLink(GEN_CONDUIT, i, Nodes[i].down, 300.0);
+            if ( r > 0 && c > 0 ) addLink(GEN_CONDUIT, i, i - side, 300.0);
+        }
+    }
+}
+
+//=============================================================================
+
+void buildTunnel()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lays out a deep tunnel network.
+//
+//  Note:    nodes 1 to m are the tunnel's drop shafts, node 1 being the
+//           one dewatered by a pump to the outfall (node 0). Each shaft
+//           collects a sewer branch, every third node of which is a
+//           storage tank.
+{
+    int m, k, b, i;
+
+    m = (MaxNodes - 1) / (BRANCH_SIZE + 1);
+    Nshafts = m;
+    Nnodes = 1 + m * (BRANCH_SIZE + 1);
+    Nodes[0].type = GEN_OUTFALL;
+    Nodes[0].down = -1;
+
+    // --- tunnel shafts
+    for (k = 1; k <= m; k++)
+    {
+        Nodes[k].type = GEN_STORAGE;
+        Nodes[k].area = 2000.0;
+        Nodes[k].down = k - 1;
+        if ( k == 1 ) addLink(GEN_PUMP, k, 0, 0.0);
+        else          addLink(GEN_CONDUIT, k, k - 1, 2000.0);
+    }
+
+    // --- collector sewers
+    i = m + 1;
+    for (k = 1; k <= m; k++)
+    {
+        for (b = 0; b < BRANCH_SIZE; b++)
+        {
+            Nodes[i].type = (b % 3 == 2) ? GEN_STORAGE : GEN_JUNCTION;
+            Nodes[i].area = 500.0;
+            Nodes[i].down = (b == 0) ? k : i - 1;
+            addLink(GEN_CONDUIT, i, Nodes[i].down,
+                    200.0 + 200.0 * randomValue());
+            i++;
+        }
+    }
+}
+
+//=============================================================================
+
+void assignLoads()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: spreads the subcatchments (or inflow hydrographs) evenly over
+//           the junctions and counts the loads draining to each node.
+//
+{
+    int  i, k, n;
+    int* junction;
+
+    // --- list the junctions
+    junction = (int *) calloc(Nnodes, sizeof(int));
+    if ( junction == NULL ) return;
+    n = 0;
+    for (i = 0; i < Nnodes; i++)
+    {
+        if ( Nodes[i].type == GEN_JUNCTION ) junction[n++] = i;
+    }
+
+    // --- attach subcatchments, or inflows at every tenth junction
+    if ( Nsubcatch > 0 )
+    {
+        for (k = 0; k < Nsubcatch; k++)
+        {
+            i = junction[(int)((double)k * n / Nsubcatch)];
+            SubNode[k] = i;
+            Nodes[i].load++;
+        }
+    }
+    else for (k = 0; k < n; k += 10)
+    {
+        Nodes[junction[k]].hasInflow = TRUE;
+        Nodes[junction[k]].load++;
+    }
+    free(junction);
+
+    // --- accumulate loads downstream (each node drains to a lower index)
+    for (i = Nnodes - 1; i > 0; i--) Nodes[Nodes[i].down].load += Nodes[i].load;
+}
+
+//=============================================================================
+
+void setElevations()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: sets node inverts so that conduits slope towards the outfall.
+//
+//  Note:    collector sewers enter a tunnel shaft near its top, and a
+//           tunnel's outfall is at ground level above the pumped shaft.
+{
+    int    i, j, n;
+    double z;
+
+    // --- each node sits above the node it drains to (nodes are visited
+    //     in index order, so that node's invert is already known)
+    Nodes[0].invert = (NetworkType == TUNNEL) ? SHAFT_DEPTH : 0.0;
+    for (i = 1; i < Nnodes; i++)
+    {
+        n = Nodes[i].down;
+        j = Nodes[i].outLink;
+        if ( Links[j].type == GEN_PUMP ) z = 0.0;
+        else if ( n >= 1 && n <= Nshafts && i > Nshafts )
+            z = Nodes[n].invert + SHAFT_DEPTH - 30.0;
+        else z = Nodes[n].invert + SLOPE * Links[j].length;
+        Nodes[i].invert = z;
+    }
+
+    // --- a link that ends above its downstream node's invert gets an
+    //     outlet offset
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type == GEN_PUMP ) continue;
+        z = Nodes[Links[j].node1].invert - SLOPE * Links[j].length -
+            Nodes[Links[j].node2].invert;
+        if ( z > 0.001 ) Links[j].offset2 = z;
+    }
+}
+
+//=============================================================================
+
+void sizeLinks()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: sizes each conduit to carry the design flow draining to it
+//           when flowing full, and sets node depths to suit.
+//
+{
+    int    j, i1, i2;
+    double q, d;
+
+    for (j = 0; j < Nlinks; j++)
+    {
+        // --- full flow of a circular conduit with n = 0.013 is
+        //     Q = 35.7 * D^(8/3) * S^0.5
+        i1 = Links[j].node1;
+        i2 = Links[j].node2;
+        q = Nodes[i1].load * (Nsubcatch > 0 ? SUB_FLOW : HYD_FLOW);
+        d = pow(q * ROUGHNESS / (0.4644 * sqrt(SLOPE)), 0.375);
+        d = ceil(2.0 * d) / 2.0;
+        if ( d < MIN_DIAM ) d = MIN_DIAM;
+        if ( d > MAX_DIAM ) d = MAX_DIAM;
+        if ( i1 <= Nshafts && d < TUNNEL_DIAM ) d = TUNNEL_DIAM;
+        Links[j].diam = d;
+        if ( Nodes[i1].depth < d + 4.0 ) Nodes[i1].depth = d + 4.0;
+        if ( Nodes[i2].depth < d + 4.0 ) Nodes[i2].depth = d + 4.0;
+    }
+    for (i1 = 1; i1 < Nnodes; i1++)
+    {
+        if ( i1 <= Nshafts ) Nodes[i1].depth = SHAFT_DEPTH;
+        else if ( Nodes[i1].type == GEN_STORAGE && Nodes[i1].depth < 12.0 )
+            Nodes[i1].depth = 12.0;
+    }
+}
+
+//=============================================================================
+
+void addRegulators()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: replaces conduits spread evenly through the network with
+//           orifices, one for each control rule.
+//
+{
+    int j, k, n, nCandidates;
+
+    // --- conduits that don't discharge to the outfall can be replaced
+    nCandidates = 0;
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type == GEN_CONDUIT && Links[j].node2 != 0 )
+            nCandidates++;
+    }
+    if ( Nrules > nCandidates ) Nrules = nCandidates;
+    if ( Nrules == 0 ) return;
+
+    // --- the k-th orifice replaces candidate (k + 0.5) * nCandidates / Nrules
+    k = 0;
+    n = 0;
+    for (j = 0; j < Nlinks && k < Nrules; j++)
+    {
+        if ( Links[j].type != GEN_CONDUIT || Links[j].node2 == 0 ) continue;
+        if ( n == (int)((k + 0.5) * nCandidates / Nrules) )
+        {
+            Links[j].type = GEN_ORIFICE;
+            k++;
+        }
+        n++;
+    }
+}
+
+//=============================================================================
+
+int writeInpFile(char* fname)
+//
+//  Input:   fname = name of input file
+//  Output:  returns TRUE if the file was written
+//  Purpose: writes the network to a SWMM input file.
+//
+{
+    FILE* f;
+    int   ok;
+
+    f = fopen(fname, "wt");
+    if ( f == NULL ) return FALSE;
+    writeOptions(f, fname);
+    writeNodes(f);
+    writeLinks(f);
+    writeSubcatchments(f);
+    writeQuality(f);
+    writeRules(f);
+    writeSeries(f);
+    ok = !ferror(f);
+    if ( fclose(f) != 0 ) ok = FALSE;
+    return ok;
+}
+
+//=============================================================================
+
+void writeOptions(FILE* f, char* fname)
+//
+//  Input:   f = input file
+//           fname = name of input file
+//  Output:  none
+//  Purpose: writes the title, options and report sections.
+//
+{
+    char  jsonName[MAXFNAME+6];
+    char* s;
+
+    // --- the profile file has the input file's name with a .json extension
+    strncpy(jsonName, fname, MAXFNAME);
+    jsonName[MAXFNAME] = '\0';
+    s = strrchr(jsonName, '.');
+    if ( s && strpbrk(s, "/\\") == NULL ) *s = '\0';
+    strcat(jsonName, ".json");
+
+    fprintf(f, "[TITLE]\nSynthetic %s network: %d nodes, %d subcatchments, "
+        "%d pollutants, %d rules, seed %llu\n\n", NetworkWords[NetworkType],
+        Nnodes, Nsubcatch, Npolluts, Nrules, Seed);
+    fprintf(f, "[OPTIONS]\n"
+        "FLOW_UNITS           CFS\n"
+        "INFILTRATION         HORTON\n"
+        "FLOW_ROUTING         DYNWAVE\n"
+        "START_DATE           01/01/2020\n"
+        "START_TIME           00:00:00\n"
+        "REPORT_START_DATE    01/01/2020\n"
+        "REPORT_START_TIME    00:00:00\n"
+        "END_DATE             01/%02d/2020\n"
+        "END_TIME             %02d:00:00\n"
+        "WET_STEP             00:05:00\n"
+        "DRY_STEP             01:00:00\n"
+        "REPORT_STEP          00:15:00\n"
+        "ROUTING_STEP         %d\n"
+        "INERTIAL_DAMPING     PARTIAL\n"
+        "NORMAL_FLOW_LIMITED  BOTH\n"
+        "MIN_SURFAREA         12.566\n"
+        "PROFILE_FILE         \"%s\"\n\n",
+        1 + Hours / 24, Hours % 24, RouteStep, jsonName);
+    fprintf(f, "[REPORT]\nINPUT NO\nCONTROLS NO\n");
+    if ( ReportAll )
+        fprintf(f, "SUBCATCHMENTS ALL\nNODES ALL\nLINKS ALL\n");
+    fprintf(f, "\n");
+}
+
+//=============================================================================
+
+void writeNodes(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes the junction, storage unit and outfall sections.
+//
+{
+    int  i;
+    char name[16];
+
+    fprintf(f, "[JUNCTIONS]\n");
+    for (i = 0; i < Nnodes; i++)
+    {
+        if ( Nodes[i].type != GEN_JUNCTION ) continue;
+        nodeName(i, name);
+        fprintf(f, "%s %.3f %.1f 0 0 0\n", name, Nodes[i].invert,
+            Nodes[i].depth);
+    }
+    fprintf(f, "\n[STORAGE]\n");
+    for (i = 0; i < Nnodes; i++)
+    {
+        if ( Nodes[i].type != GEN_STORAGE ) continue;
+        nodeName(i, name);
+        fprintf(f, "%s %.3f %.1f 0 FUNCTIONAL %.0f 0 0 0 0\n", name,
+            Nodes[i].invert, Nodes[i].depth, Nodes[i].area);
+    }
+
+    // --- a tunnel's outfall is at ground level, above the pumped shaft
+    fprintf(f, "\n[OUTFALLS]\n");
+    fprintf(f, "O0 %.3f FREE NO\n\n",
+        (NetworkType == TUNNEL) ? Nodes[1].invert + SHAFT_DEPTH : 0.0);
+}
+
+//=============================================================================
+
+void writeLinks(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes the conduit, orifice, pump, cross section and curve
+//           sections.
+//
+{
+    int  j;
+    char name[16], n1[16], n2[16];
+
+    fprintf(f, "[CONDUITS]\n");
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type != GEN_CONDUIT ) continue;
+        linkName(j, name);
+        nodeName(Links[j].node1, n1);
+        nodeName(Links[j].node2, n2);
+        fprintf(f, "%s %s %s %.1f %.3f 0 %.3f 0 0\n", name, n1, n2,
+            Links[j].length, ROUGHNESS, Links[j].offset2);
+    }
+    fprintf(f, "\n[ORIFICES]\n");
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type != GEN_ORIFICE ) continue;
+        linkName(j, name);
+        nodeName(Links[j].node1, n1);
+        nodeName(Links[j].node2, n2);
+        fprintf(f, "%s %s %s SIDE 0 0.65 NO\n", name, n1, n2);
+    }
+    fprintf(f, "\n[PUMPS]\n");
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type != GEN_PUMP ) continue;
+        linkName(j, name);
+        nodeName(Links[j].node1, n1);
+        nodeName(Links[j].node2, n2);
+        fprintf(f, "%s %s %s Dewater ON 0 0\n", name, n1, n2);
+    }
+    fprintf(f, "\n[XSECTIONS]\n");
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type == GEN_PUMP ) continue;
+        linkName(j, name);
+        fprintf(f, "%s CIRCULAR %.1f 0 0 0 1\n", name, Links[j].diam);
+    }
+
+    // --- the dewatering pump's capacity grows with depth in the shaft up
+    //     to twice the design flow draining to it
+    if ( NetworkType == TUNNEL )
+    {
+        fprintf(f, "\n[CURVES]\n");
+        fprintf(f, "Dewater Pump4 0 0\nDewater %.1f %.1f\n", SHAFT_DEPTH,
+            2.0 * Nodes[1].load * (Nsubcatch > 0 ? SUB_FLOW : HYD_FLOW));
+    }
+    fprintf(f, "\n");
+}
+
+//=============================================================================
+
+void writeSubcatchments(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes the rain gage, subcatchment and inflow sections.
+//
+{
+    int  i, k;
+    char name[16];
+
+    if ( Nsubcatch > 0 )
+    {
+        fprintf(f, "[RAINGAGES]\nG1 INTENSITY 0:30 1.0 TIMESERIES Storm\n\n");
+        fprintf(f, "[SUBCATCHMENTS]\n");
+        for (k = 0; k < Nsubcatch; k++)
+        {
+            nodeName(SubNode[k], name);
+            fprintf(f, "S%d G1 %s %.1f %.0f 500 0.5 0\n", k + 1, name,
+                SUB_AREA, 40.0 + 40.0 * randomValue());
+        }
+        fprintf(f, "\n[SUBAREAS]\n");
+        for (k = 0; k < Nsubcatch; k++)
+        {
+            fprintf(f, "S%d 0.015 0.24 0.06 0.3 25 OUTLET\n", k + 1);
+        }
+        fprintf(f, "\n[INFILTRATION]\n");
+        for (k = 0; k < Nsubcatch; k++)
+        {
+            fprintf(f, "S%d 3.0 0.5 4 7 0\n", k + 1);
+        }
+        fprintf(f, "\n");
+        return;
+    }
+
+    // --- without subcatchments, junctions receive inflow hydrographs
+    fprintf(f, "[INFLOWS]\n");
+    for (i = 0; i < Nnodes; i++)
+    {
+        if ( !Nodes[i].hasInflow ) continue;
+        nodeName(i, name);
+        fprintf(f, "%s FLOW Hydrograph FLOW 1.0 1.0\n", name);
+        for (k = 0; k < Npolluts; k++)
+        {
+            fprintf(f, "%s P%d \"\" CONCEN 1.0 1.0 %.1f\n", name, k + 1,
+                10.0 * (k + 1));
+        }
+    }
+    fprintf(f, "\n");
+}
+
+//=============================================================================
+
+void writeQuality(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes the pollutant section.
+//
+{
+    int k;
+
+    if ( Npolluts == 0 ) return;
+    fprintf(f, "[POLLUTANTS]\n");
+    for (k = 0; k < Npolluts; k++)
+    {
+        fprintf(f, "P%d MG/L %.1f 0 0 %.2f\n", k + 1, 5.0 * (k + 1),
+            0.1 * (k % 3));
+    }
+    fprintf(f, "\n");
+}
+
+//=============================================================================
+
+void writeRules(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes an RPN control rule for each orifice.
+//
+//  Note:    each rule opens its orifice in proportion to the room left in
+//           the node downstream of it (1 - depth / full depth), closing it
+//           to 10% when that node is nearly full. Every other rule uses the
+//           node's depth of 5 minutes earlier.
+{
+    int  j, k;
+    char name[16], node[16];
+
+    if ( Nrules == 0 ) return;
+    fprintf(f, "[CONTROLS]\n");
+    k = 0;
+    for (j = 0; j < Nlinks; j++)
+    {
+        if ( Links[j].type != GEN_ORIFICE ) continue;
+        k++;
+        linkName(j, name);
+        nodeName(Links[j].node2, node);
+        fprintf(f, "RULE Throttle%d\n", k);
+        if ( k % 2 ) fprintf(f, "IF NODE %s DEPTH [Enter] ---\n", node);
+        else         fprintf(f, "IF NODE %s DEPTH [BACK] 300\n", node);
+        fprintf(f,
+            "AND STACK OP [Enter] %.1f\n"
+            "AND STACK OP [/] ---\n"
+            "AND STACK OP [CHS] ---\n"
+            "AND STACK OP [Enter] 1\n"
+            "AND STACK OP [+] ---\n"
+            "AND STACK OP [Enter] 0.1\n"
+            "AND STACK OP [X<Y] ---\n"
+            "AND STACK OP [POP] ---\n"
+            "THEN ORIFICE %s SETTING = STACK RESULT\n"
+            "ELSE ORIFICE %s SETTING = 0.1\n\n",
+            Nodes[Links[j].node2].depth, name, name);
+    }
+}
+
+//=============================================================================
+
+void writeSeries(FILE* f)
+//
+//  Input:   f = input file
+//  Output:  none
+//  Purpose: writes the design storm and inflow hydrograph time series.
+//
+{
+    fprintf(f, "[TIMESERIES]\n");
+    fprintf(f, "Storm 0:00 0.0\nStorm 0:30 0.5\nStorm 1:00 2.0\n"
+               "Storm 1:30 0.5\nStorm 2:00 0.0\n");
+    fprintf(f, "Hydrograph 0:00 0.0\nHydrograph 1:00 %.1f\n"
+               "Hydrograph 3:00 0.0\n", HYD_FLOW);
+}
+
+//=============================================================================
+
+void nodeName(int i, char* s)
+//
+//  Input:   i = node index
+//  Output:  s = node's ID name
+//  Purpose: names a node by its type and index.
+//
+{
+    if      ( Nodes[i].type == GEN_OUTFALL ) sprintf(s, "O%d", i);
+    else if ( Nodes[i].type == GEN_STORAGE ) sprintf(s, "T%d", i);
+    else                                     sprintf(s, "J%d", i);
+}
+
+//=============================================================================
+
+void linkName(int j, char* s)
+//
+//  Input:   j = link index
+//  Output:  s = link's ID name
+//  Purpose: names a link by its type and index.
+//
+{
+    if      ( Links[j].type == GEN_ORIFICE ) sprintf(s, "R%d", j + 1);
+    else if ( Links[j].type == GEN_PUMP )    sprintf(s, "P%d", j + 1);
+    else                                     sprintf(s, "C%d", j + 1);
+}
+
+//=============================================================================
+
+double randomValue()
+//
+//  Input:   none
+//  Output:  returns a random number between 0 and 1
+//  Purpose: generates the same sequence of random numbers on every
+//           platform for a given seed.
+//
+{
+    Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(Seed >> 11) / 9007199254740992.0;
+}
+
+//=============================================================================
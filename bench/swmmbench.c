@@ -0,0 +1,533 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   swmmbench.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Benchmark driver for the engine.
+//
+//   Runs a model through swmm_open, swmm_start, swmm_step and swmm_end and
+//   reports its routing steps per second, dynamic wave (Picard) iterations
+//   per step, peak memory use and the rate at which results were written to
+//   the binary output file. It can then check that the results match those
+//   of a reference run, such as one made with an earlier build of the
+//   engine, within a tolerance.
+//
+//   Command line:  swmmbench inpFile [-ref refOutFile] [-tol tolerance]
+//
+//   The report and binary output files are written next to the input file
+//   with .rpt and .out extensions. Iterations per step are read from the
+//   JSON profile named by the model's PROFILE_FILE option when it has the
+//   input file's name with a .json extension (as netgen.c writes it).
+//
+//   A result differs from its reference value when
+//   |value - reference| > tolerance * max(1, |reference|); the default
+//   tolerance is 1.0e-4. Both runs must report the same objects at the same
+//   times. The program returns 0 if the run succeeded and its results match,
+//   1 if the run failed and 2 if its results differ.
+//
+//   Build by compiling the engine's sources as a library (with SOL defined)
+//   together with this file and, on Windows, linking psapi.lib, e.g.:
+//      cl /O2 /TP /openmp /DSOL /I..\src swmmbench.c ..\src\*.c psapi.lib
+//   See README.md for the stand-ins the engine needs to build with g++.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+#define _FILE_OFFSET_BITS 64
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "swmm5.h"
+
+#ifdef _WIN32
+#define FSEEK _fseeki64
+#define FTELL _ftelli64
+#else
+#define FSEEK fseeko
+#define FTELL ftello
+#endif
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define  TRUE          1
+#define  FALSE         0
+#define  MAXFNAME      259            // max. characters in file name
+#define  MAGICNUMBER   516114522      // first & last value of an output file
+#define  EPILOGUE_SIZE 24             // bytes in output file's epilogue
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct                        // layout of a binary output file
+{
+    FILE*     file;                   // the file
+    int       nObjects[3];            // subcatchments, nodes & links
+    int       nVars[4];               // variables per subcatch., node, link
+                                      // & for the system
+    int       nPeriods;               // number of reporting periods
+    int       errorCode;              // error code of the run
+    long long idStart;                // file position of the ID names
+    long long outputStart;            // file position of the first period
+}  TOutFile;
+
+static char* ObjectWords[] = {"Subcatchment", "Node", "Link", "System"};
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static void      setFileName(char* fname, char* inpFile, char* ext);
+static double    getClock(void);
+static double    getPeakMemory(void);
+static long long getFileSize(char* fname);
+static double    getIterationsPerStep(char* jsonFile);
+static int       compareResults(char* outFile, char* refFile, double tol);
+static int       openOutFile(TOutFile* out, char* fname);
+static int       readInts(FILE* f, int* x, int n);
+static void      readObjectID(TOutFile* out, int type, int index, char* id);
+
+//=============================================================================
+
+int  main(int argc, char *argv[])
+//
+//  Input:   argc = number of command line arguments
+//           argv = array of command line arguments
+//  Output:  returns 0 if successful, 1 if the run failed and 2 if its
+//           results differ from the reference run's
+//  Purpose: runs and times a model, then checks its results.
+//
+{
+    char   rptFile[MAXFNAME+5], outFile[MAXFNAME+5], jsonFile[MAXFNAME+6];
+    char*  refFile = NULL;
+    double tol = 1.0e-4;
+    double elapsedTime = 0.0;
+    double t0, t1, t2, t3;
+    double stepTime, iters, outBytes;
+    float  runoffErr, flowErr, qualErr;
+    long   steps = 0;
+    int    i, err;
+
+    // --- read command line
+    if ( argc < 2 )
+    {
+        fprintf(stderr,
+            "\nUsage: swmmbench inpFile [-ref refOutFile] [-tol tolerance]\n");
+        return 1;
+    }
+    for (i = 2; i + 1 < argc; i += 2)
+    {
+        if      ( strcmp(argv[i], "-ref") == 0 ) refFile = argv[i+1];
+        else if ( strcmp(argv[i], "-tol") == 0 ) tol = atof(argv[i+1]);
+    }
+    setFileName(rptFile, argv[1], ".rpt");
+    setFileName(outFile, argv[1], ".out");
+    setFileName(jsonFile, argv[1], ".json");
+
+    // --- run the model one routing step at a time
+    t0 = getClock();
+    err = swmm_open(argv[1], rptFile, outFile);
+    t1 = getClock();
+    if ( !err ) err = swmm_start(TRUE);
+    t2 = getClock();
+    while ( !err )
+    {
+        err = swmm_step(&elapsedTime);
+        steps++;
+        if ( elapsedTime <= 0.0 ) break;
+    }
+    t3 = getClock();
+    swmm_end();
+    swmm_getMassBalErr(&runoffErr, &flowErr, &qualErr);
+    swmm_report();
+    swmm_close();
+    if ( err )
+    {
+        fprintf(stderr, "\nswmmbench: run failed with error %d (see %s).\n",
+            err, rptFile);
+        return 1;
+    }
+
+    // --- report performance
+    stepTime = t3 - t2;
+    outBytes = (double)getFileSize(outFile);
+    iters = getIterationsPerStep(jsonFile);
+    printf("\n  Model ........................ %s", argv[1]);
+    printf("\n  Open time (sec) .............. %12.3f", t1 - t0);
+    printf("\n  Start time (sec) ............. %12.3f", t2 - t1);
+    printf("\n  Step time (sec) .............. %12.3f", stepTime);
+    printf("\n  Steps ........................ %12ld", steps);
+    printf("\n  Steps per Second ............. %12.1f",
+        stepTime > 0.0 ? steps / stepTime : 0.0);
+    if ( iters > 0.0 )
+        printf("\n  Iterations per Step .......... %12.2f", iters);
+    else
+        printf("\n  Iterations per Step .......... %12s", "n/a");
+    printf("\n  Peak Memory (MB) ............. %12.1f",
+        getPeakMemory() / 1048576.0);
+    printf("\n  Output Size (MB) ............. %12.1f", outBytes / 1048576.0);
+    printf("\n  Output MB per Second ......... %12.2f",
+        stepTime > 0.0 ? outBytes / 1048576.0 / stepTime : 0.0);
+    printf("\n  Runoff Continuity Error (%%) .. %12.3f", runoffErr);
+    printf("\n  Flow Continuity Error (%%) .... %12.3f", flowErr);
+    printf("\n  Quality Continuity Error (%%) . %12.3f\n", qualErr);
+
+    // --- check results against the reference run
+    if ( refFile == NULL ) return 0;
+    return compareResults(outFile, refFile, tol) ? 0 : 2;
+}
+
+//=============================================================================
+
+void setFileName(char* fname, char* inpFile, char* ext)
+//
+//  Input:   inpFile = name of input file
+//           ext = file extension
+//  Output:  fname = name of input file with extension replaced by ext
+//  Purpose: names a file that accompanies the input file.
+//
+{
+    char* s;
+
+    strncpy(fname, inpFile, MAXFNAME);
+    fname[MAXFNAME] = '\0';
+    s = strrchr(fname, '.');
+    if ( s && strpbrk(s, "/\\") == NULL ) *s = '\0';
+    strcat(fname, ext);
+}
+
+//=============================================================================
+
+double getClock()
+//
+//  Input:   none
+//  Output:  returns wall clock time (sec)
+//  Purpose: reads a high resolution wall clock.
+//
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + 1.0e-6 * (double)tv.tv_usec;
+#endif
+}
+
+//=============================================================================
+
+double getPeakMemory()
+//
+//  Input:   none
+//  Output:  returns peak resident memory used by the process (bytes)
+//  Purpose: finds the process's peak working set size.
+//
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if ( !GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) )
+        return 0.0;
+    return (double)pmc.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) != 0 ) return 0.0;
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss;
+#else
+    return 1024.0 * (double)usage.ru_maxrss;
+#endif
+#endif
+}
+
+//=============================================================================
+
+long long getFileSize(char* fname)
+//
+//  Input:   fname = name of a file
+//  Output:  returns size of file in bytes (0 if it can't be opened)
+//  Purpose: finds the size of a file.
+//
+{
+    FILE*     f;
+    long long size = 0;
+
+    f = fopen(fname, "rb");
+    if ( f == NULL ) return 0;
+    if ( FSEEK(f, 0, SEEK_END) == 0 ) size = FTELL(f);
+    fclose(f);
+    return size;
+}
+
+//=============================================================================
+
+double getIterationsPerStep(char* jsonFile)
+//
+//  Input:   jsonFile = name of the run's JSON profile file
+//  Output:  returns average number of dynamic wave iterations per routing
+//           step (0 if not available)
+//  Purpose: reads the histogram of iterations per step from the profile.
+//
+//  Note:    entry i of the histogram is the number of steps that used i+1
+//           iterations.
+{
+    FILE*  f;
+    char   line[1024];
+    char*  s;
+    char*  end;
+    double count, steps = 0.0, iters = 0.0;
+    int    i;
+
+    f = fopen(jsonFile, "rt");
+    if ( f == NULL ) return 0.0;
+    while ( fgets(line, sizeof(line), f) )
+    {
+        s = strstr(line, "\"iterations\": [");
+        if ( s == NULL ) continue;
+        s = strchr(s, '[') + 1;
+        for (i = 1; ; i++)
+        {
+            count = strtod(s, &end);
+            if ( end == s ) break;
+            steps += count;
+            iters += i * count;
+            s = end;
+            while ( *s == ',' || *s == ' ' ) s++;
+        }
+        break;
+    }
+    fclose(f);
+    return steps > 0.0 ? iters / steps : 0.0;
+}
+
+//=============================================================================
+
+int compareResults(char* outFile, char* refFile, double tol)
+//
+//  Input:   outFile = name of binary output file of the run
+//           refFile = name of binary output file of the reference run
+//           tol = relative tolerance
+//  Output:  returns TRUE if all results match within the tolerance
+//  Purpose: compares every reported result of two runs.
+//
+{
+    TOutFile out, ref;
+    int      i, k, n, nValues, nBad = 0, ok = TRUE;
+    int      worstPeriod = -1, worstIndex = 0, type, index, var;
+    double   date1, date2, e, maxErr = 0.0;
+    float*   x = NULL;
+    float*   y = NULL;
+    char     id[MAXFNAME+1];
+
+    // --- both files must hold the same results
+    memset(&out, 0, sizeof(TOutFile));
+    memset(&ref, 0, sizeof(TOutFile));
+    if ( !openOutFile(&out, outFile) || !openOutFile(&ref, refFile) )
+    {
+        printf("\n  Reference check .............. could not read %s\n",
+            out.file ? refFile : outFile);
+        ok = FALSE;
+    }
+    else if ( memcmp(out.nObjects, ref.nObjects, sizeof(out.nObjects)) ||
+              memcmp(out.nVars, ref.nVars, sizeof(out.nVars)) ||
+              out.nPeriods != ref.nPeriods )
+    {
+        printf("\n  Reference check .............. objects or periods "
+               "differ from %s\n", refFile);
+        ok = FALSE;
+    }
+
+    // --- compare each period's date and values
+    nValues = 0;
+    for (k = 0; k < 3; k++) nValues += out.nObjects[k] * out.nVars[k];
+    nValues += out.nVars[3];
+    if ( ok )
+    {
+        x = (float *) malloc(nValues * sizeof(float));
+        y = (float *) malloc(nValues * sizeof(float));
+        ok = ( x != NULL && y != NULL );
+        FSEEK(out.file, out.outputStart, SEEK_SET);
+        FSEEK(ref.file, ref.outputStart, SEEK_SET);
+    }
+    for (n = 0; ok && n < out.nPeriods; n++)
+    {
+        if ( fread(&date1, sizeof(double), 1, out.file) != 1 ||
+             fread(&date2, sizeof(double), 1, ref.file) != 1 ||
+             fread(x, sizeof(float), nValues, out.file) != (size_t)nValues ||
+             fread(y, sizeof(float), nValues, ref.file) != (size_t)nValues )
+        {
+            printf("\n  Reference check .............. output file is "
+                   "incomplete\n");
+            ok = FALSE;
+            break;
+        }
+        if ( date1 != date2 )
+        {
+            printf("\n  Reference check .............. reporting times "
+                   "differ\n");
+            ok = FALSE;
+            break;
+        }
+        for (i = 0; i < nValues; i++)
+        {
+            e = fabs((double)x[i] - (double)y[i]) /
+                fmax(1.0, fabs((double)y[i]));
+            if ( e > tol ) nBad++;
+            if ( e > maxErr )
+            {
+                maxErr = e;
+                worstPeriod = n;
+                worstIndex = i;
+            }
+        }
+    }
+
+    // --- report the largest difference
+    if ( ok )
+    {
+        printf("\n  Values Compared .............. %12.0f",
+            (double)nValues * out.nPeriods);
+        printf("\n  Values Outside Tolerance ..... %12d", nBad);
+        printf("\n  Largest Difference ........... %12.3e", maxErr);
+        if ( worstPeriod >= 0 )
+        {
+            index = worstIndex;
+            for (type = 0; type < 3; type++)
+            {
+                if ( index < out.nObjects[type] * out.nVars[type] ) break;
+                index -= out.nObjects[type] * out.nVars[type];
+            }
+            var = index % out.nVars[type];
+            index = index / out.nVars[type];
+            readObjectID(&out, type, index, id);
+            printf("\n    at %s %s, variable %d, period %d",
+                ObjectWords[type], id, var, worstPeriod + 1);
+        }
+        printf("\n  Reference check .............. %s\n",
+            nBad == 0 ? "PASSED" : "FAILED");
+        ok = ( nBad == 0 );
+    }
+    free(x);
+    free(y);
+    if ( out.file ) fclose(out.file);
+    if ( ref.file ) fclose(ref.file);
+    return ok;
+}
+
+//=============================================================================
+
+int openOutFile(TOutFile* out, char* fname)
+//
+//  Input:   fname = name of a binary output file
+//  Output:  out = layout of the file; returns TRUE if the file is valid
+//  Purpose: opens a binary output file and reads where its results are.
+//
+//  Note:    the file holds a header with the number of objects reported
+//           on, their ID names and input values, the variables saved for
+//           each type of object, the results of each reporting period and
+//           an epilogue with the file positions of these sections.
+{
+    int  header[7], epilogue[6], n, k;
+    FILE* f;
+
+    f = fopen(fname, "rb");
+    out->file = f;
+    if ( f == NULL ) return FALSE;
+
+    // --- read header & epilogue
+    if ( !readInts(f, header, 7) || header[0] != MAGICNUMBER ) return FALSE;
+    if ( FSEEK(f, -EPILOGUE_SIZE, SEEK_END) != 0 ||
+         !readInts(f, epilogue, 6) || epilogue[5] != MAGICNUMBER )
+        return FALSE;
+    out->nObjects[0] = header[3];
+    out->nObjects[1] = header[4];
+    out->nObjects[2] = header[5];
+    out->nPeriods = epilogue[3];
+    out->errorCode = epilogue[4];
+    out->idStart = epilogue[0];
+    out->outputStart = epilogue[2];
+
+    // --- skip the input values of each object (preceded by the number
+    //     and codes of the values saved) to reach the result variables
+    FSEEK(f, epilogue[1], SEEK_SET);
+    for (k = 0; k < 3; k++)
+    {
+        if ( !readInts(f, &n, 1) ) return FALSE;
+        FSEEK(f, (long long)n * 4 + (long long)out->nObjects[k] * n * 4,
+              SEEK_CUR);
+    }
+
+    // --- read the number of variables saved for each type of object
+    for (k = 0; k < 4; k++)
+    {
+        if ( !readInts(f, &out->nVars[k], 1) ) return FALSE;
+        FSEEK(f, (long long)out->nVars[k] * 4, SEEK_CUR);
+    }
+    return ( out->errorCode == 0 );
+}
+
+//=============================================================================
+
+int readInts(FILE* f, int* x, int n)
+//
+//  Input:   f = binary file
+//           n = number of 4-byte integers to read
+//  Output:  x = integers read; returns TRUE if all were read
+//  Purpose: reads integers from a binary output file.
+//
+{
+    return ( fread(x, sizeof(int), n, f) == (size_t)n );
+}
+
+//=============================================================================
+
+void readObjectID(TOutFile* out, int type, int index, char* id)
+//
+//  Input:   out = layout of a binary output file
+//           type = type of object (subcatchment, node, link or system)
+//           index = index of object
+//  Output:  id = ID name of the object
+//  Purpose: reads an object's ID name from a binary output file.
+//
+{
+    int i, n, len;
+
+    // --- the system has no name
+    sprintf(id, "%d", index + 1);
+    if ( type > 2 ) return;
+
+    // --- names are stored by type of object, each one as its length
+    //     followed by its characters
+    n = index;
+    for (i = 0; i < type; i++) n += out->nObjects[i];
+    FSEEK(out->file, out->idStart, SEEK_SET);
+    for (i = 0; i <= n; i++)
+    {
+        if ( !readInts(out->file, &len, 1) || len < 0 ) return;
+        if ( i < n ) FSEEK(out->file, len, SEEK_CUR);
+    }
+    if ( len > MAXFNAME ) return;
+    if ( fread(id, 1, len, out->file) == (size_t)len ) id[len] = '\0';
+    else sprintf(id, "%d", index + 1);
+}
+
+//=============================================================================
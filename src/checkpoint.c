@@ -0,0 +1,508 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   checkpoint.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Periodic checkpoints of long continuous simulations.
+//
+//   When the CHECKPOINT option is used, an image of the simulation's state
+//   (see snapshot.c) is written to a checkpoint file every so many days of
+//   simulated time. If a run is stopped before it finishes, running the
+//   same project again resumes it from its last checkpoint, producing the
+//   same results as a run that was never interrupted. The checkpoint file
+//   is deleted once a run finishes.
+//
+//   A checkpoint file holds a header identifying the project and the point
+//   reached in the run, the state image (which keeps every variable at full
+//   precision), the text added to the report file since the run started
+//   (the report file is re-created when the run resumes) and a checksum.
+//   The image is copied in memory and then written by a background thread
+//   to a temporary file that replaces the previous checkpoint file only
+//   once it is complete, so a crash can't leave a partly written checkpoint
+//   behind. The binary output file is flushed to disk first, and a resumed
+//   run re-opens it without discarding the results it already holds.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "headers.h"
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define CHECKPOINT_VERSION 1      // version of checkpoint file format
+
+static const char Magic[8] = "SWMMCKP";
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    char       magic[8];          // identifies a checkpoint file
+    int        version;           // checkpoint file format version
+    int        engineVersion;     // version of engine that wrote the file
+    int        counts[MAX_OBJ_TYPES]; // number of each type of object
+    unsigned long long inpHash;   // hash of project's input file
+    double     elapsedTime;       // routing time reached (msec)
+    long long  outPos;            // bytes of binary output file written
+    long long  rptStart;          // report file position at start of run
+    long long  rptSize;           // bytes of report written during run
+    long long  imageSize;         // bytes of state image
+}  TCheckpointHeader;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static int       Active;          // TRUE if checkpoints are written
+static int       Resuming;        // TRUE if run resumes from a checkpoint
+static double    NextTime;        // routing time of next checkpoint (msec)
+static long long RptStart;        // report file position at start of run
+static unsigned long long InpHash;// hash of project's input file
+static TCheckpointHeader Header;  // header of checkpoint read or written
+static char*     Image;           // state image read or written
+static char*     RptText;         // report text read from checkpoint file
+static int       Writing;         // TRUE if writer thread is running
+static int       WriteFailed;     // TRUE if last checkpoint wasn't written
+
+#ifdef _WIN32
+static HANDLE    Writer;          // thread writing a checkpoint
+#else
+static pthread_t Writer;
+#endif
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  checkpoint_open        (called by swmm_start)
+//  checkpoint_isResuming  (called by output_openOutFile, runoff_open and
+//                          openFileForOutput in iface.c)
+//  checkpoint_resume      (called by swmm_start)
+//  checkpoint_step        (called by swmm_step)
+//  checkpoint_close       (called by swmm_end)
+
+//-----------------------------------------------------------------------------
+//  Function declarations
+//-----------------------------------------------------------------------------
+static int  readCheckpoint(void);
+static int  writeCheckpoint(void);
+static void startWriter(void);
+static void waitForWriter(void);
+static unsigned long long hashFile(char* fname);
+static long long getFileSize(char* fname);
+static void syncFile(FILE* f);
+
+#ifdef _WIN32
+static unsigned __stdcall writerThread(void* arg);
+#else
+static void* writerThread(void* arg);
+#endif
+
+//=============================================================================
+
+void checkpoint_open()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: checks if a run should resume from a checkpoint file.
+//
+//  Note:    called before any results files are opened, so that they can
+//           be re-opened without losing the results they already hold.
+{
+    Active = FALSE;
+    Resuming = FALSE;
+    Writing = FALSE;
+    WriteFailed = FALSE;
+    Image = NULL;
+    RptText = NULL;
+    if ( CheckpointDays <= 0.0 ) return;
+
+    // --- a run can't resume without the results saved before it stopped
+    if ( strlen(Fout.name) == 0 || Fout.mode == SCRATCH_FILE )
+    {
+        report_writeWarningMsg(WARN11, "");
+        return;
+    }
+    Active = TRUE;
+    InpHash = hashFile(Finp.name);
+    Resuming = readCheckpoint();
+}
+
+//=============================================================================
+
+int checkpoint_isResuming()
+//
+//  Input:   none
+//  Output:  returns TRUE if the run resumes from a checkpoint
+//  Purpose: tells the modules that open results files to keep their
+//           contents.
+//
+{
+    return Resuming;
+}
+
+//=============================================================================
+
+void checkpoint_resume()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: restores the state saved in a checkpoint file once a run has
+//           been started.
+//
+{
+    long long i;
+    double    step;
+
+    if ( !Active ) return;
+    RptStart = _ftelli64(Frpt.file);
+    if ( Resuming )
+    {
+        // --- put back the report text written before the checkpoint
+        for (i = 0; i < Header.rptSize; i++)
+        {
+            if ( RptText[i] != '\r' ) fputc(RptText[i], Frpt.file);
+        }
+        if ( !snapshot_restoreImage(Image, (size_t)Header.imageSize) )
+        {
+            report_writeErrorMsg(ERR_SNAPSHOT, CheckpointFile);
+        }
+        FREE(Image);
+        FREE(RptText);
+        Resuming = FALSE;
+        sprintf(Msg, "\n o  Resuming from checkpoint at day %.2f",
+                NewRoutingTime / MSECperDAY);
+        writecon(Msg);
+    }
+
+    // --- checkpoints fall on whole multiples of the interval
+    step = CheckpointDays * MSECperDAY;
+    NextTime = (floor(NewRoutingTime / step) + 1.0) * step;
+}
+
+//=============================================================================
+
+void checkpoint_step()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes a checkpoint file if one is due.
+//
+{
+    char*  data;
+    size_t size;
+    double step;
+
+    if ( !Active || ErrorCode ) return;
+    if ( NewRoutingTime < NextTime || NewRoutingTime >= TotalDuration ) return;
+    step = CheckpointDays * MSECperDAY;
+    while ( NextTime <= NewRoutingTime ) NextTime += step;
+
+    // --- the image is re-used, so the last one must have been written
+    waitForWriter();
+    if ( ErrorCode ) return;
+
+    // --- results saved so far must reach the files before the checkpoint
+    //     that refers to them
+    fflush(Fout.file);
+    fflush(Frpt.file);
+    if ( snapshot_saveImage(&data, &size) ) return;
+    Image = data;
+
+    memcpy(Header.magic, Magic, sizeof(Magic));
+    Header.version = CHECKPOINT_VERSION;
+    Header.engineVersion = VERSION;
+    memcpy(Header.counts, Nobjects, sizeof(Header.counts));
+    Header.inpHash = InpHash;
+    Header.elapsedTime = NewRoutingTime;
+    Header.outPos = _ftelli64(Fout.file);
+    Header.rptStart = RptStart;
+    Header.rptSize = _ftelli64(Frpt.file) - RptStart;
+    Header.imageSize = size;
+    startWriter();
+}
+
+//=============================================================================
+
+void checkpoint_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: finishes writing checkpoints at the end of a run.
+//
+{
+    if ( !Active ) return;
+    waitForWriter();
+
+    // --- the image belongs to snapshot.c unless it was read from a file
+    if ( Resuming ) FREE(Image);
+    Image = NULL;
+    FREE(RptText);
+
+    // --- a finished run has no further use for its checkpoint file
+    if ( !ErrorCode && NewRoutingTime >= TotalDuration )
+    {
+        remove(CheckpointFile);
+    }
+    Active = FALSE;
+    Resuming = FALSE;
+}
+
+//=============================================================================
+
+int readCheckpoint()
+//
+//  Input:   none
+//  Output:  returns TRUE if a checkpoint of the current project was read
+//  Purpose: reads the contents of an existing checkpoint file.
+//
+{
+    FILE*  f;
+    int    ok;
+    unsigned long long checksum = 0;
+    TCheckpointHeader* h = &Header;
+
+    // --- no checkpoint file means the run starts from the beginning
+    f = fopen(CheckpointFile, "rb");
+    if ( f == NULL ) return FALSE;
+
+    // --- check that the file was written by this version for this project
+    ok = fread(h, sizeof(TCheckpointHeader), 1, f) == 1 &&
+         memcmp(h->magic, Magic, sizeof(Magic)) == 0 &&
+         h->version == CHECKPOINT_VERSION &&
+         h->engineVersion == VERSION &&
+         h->inpHash == InpHash &&
+         memcmp(h->counts, Nobjects, sizeof(h->counts)) == 0 &&
+         h->imageSize > 0 && h->rptSize >= 0 &&
+         getFileSize(Fout.name) >= h->outPos;
+
+    // --- read the image and report text and check that they are complete
+    if ( ok )
+    {
+        Image = (char *) malloc((size_t)h->imageSize);
+        RptText = (char *) malloc((size_t)h->rptSize + 1);
+        ok = Image != NULL && RptText != NULL &&
+             fread(Image, 1, (size_t)h->imageSize, f) ==
+                 (size_t)h->imageSize &&
+             fread(RptText, 1, (size_t)h->rptSize, f) ==
+                 (size_t)h->rptSize &&
+             fread(&checksum, sizeof(checksum), 1, f) == 1 &&
+             checksum == hashBytes(hashBytes(FNV_OFFSET, Image,
+                 (size_t)h->imageSize), RptText, (size_t)h->rptSize);
+    }
+    fclose(f);
+    if ( !ok )
+    {
+        FREE(Image);
+        FREE(RptText);
+        report_writeWarningMsg(WARN12, CheckpointFile);
+    }
+    return ok;
+}
+
+//=============================================================================
+
+int writeCheckpoint()
+//
+//  Input:   none
+//  Output:  returns TRUE if the checkpoint file was written
+//  Purpose: writes the current image to the checkpoint file.
+//
+//  Note:    runs in its own thread while the simulation carries on, so it
+//           only reads the report and output files up to where they had
+//           been flushed when the image was taken.
+{
+    FILE*     f;
+    FILE*     rpt;
+    char      tmpName[MAXFNAME+5];
+    char      buf[4096];
+    size_t    n;
+    long long left;
+    int       ok;
+    unsigned long long checksum;
+
+    // --- the output file must hold all results the checkpoint refers to
+    syncFile(Fout.file);
+
+    sprintf(tmpName, "%s.tmp", CheckpointFile);
+    f = fopen(tmpName, "wb");
+    if ( f == NULL ) return FALSE;
+    ok = fwrite(&Header, sizeof(TCheckpointHeader), 1, f) == 1 &&
+         fwrite(Image, 1, (size_t)Header.imageSize, f) ==
+             (size_t)Header.imageSize;
+    checksum = hashBytes(FNV_OFFSET, Image, (size_t)Header.imageSize);
+
+    // --- copy the report text written since the run started
+    rpt = fopen(Frpt.name, "rb");
+    if ( rpt == NULL ) ok = FALSE;
+    else
+    {
+        _fseeki64(rpt, Header.rptStart, SEEK_SET);
+        left = Header.rptSize;
+        while ( ok && left > 0 )
+        {
+            n = fread(buf, 1, (size_t)MIN(left, (long long)sizeof(buf)), rpt);
+            if ( n == 0 ) ok = FALSE;
+            else ok = fwrite(buf, 1, n, f) == n;
+            checksum = hashBytes(checksum, buf, n);
+            left -= n;
+        }
+        fclose(rpt);
+    }
+    if ( ok ) ok = fwrite(&checksum, sizeof(checksum), 1, f) == 1;
+    if ( ok ) ok = fflush(f) == 0;
+    if ( ok ) syncFile(f);
+    fclose(f);
+
+    // --- only a complete file replaces the previous checkpoint
+    if ( ok ) ok = replaceFile(CheckpointFile, tmpName);
+    if ( !ok ) remove(tmpName);
+    return ok;
+}
+
+//=============================================================================
+
+void startWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: starts a thread that writes the current image to the
+//           checkpoint file.
+//
+{
+#ifdef _WIN32
+    Writer = (HANDLE) _beginthreadex(NULL, 0, writerThread, NULL, 0, NULL);
+    Writing = ( Writer != 0 );
+#else
+    Writing = ( pthread_create(&Writer, NULL, writerThread, NULL) == 0 );
+#endif
+
+    // --- write the checkpoint here if no thread could be started
+    if ( !Writing ) WriteFailed = !writeCheckpoint();
+}
+
+//=============================================================================
+
+void waitForWriter()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: waits for the last checkpoint to be written.
+//
+{
+    if ( Writing )
+    {
+#ifdef _WIN32
+        WaitForSingleObject(Writer, INFINITE);
+        CloseHandle(Writer);
+#else
+        pthread_join(Writer, NULL);
+#endif
+        Writing = FALSE;
+    }
+    if ( WriteFailed )
+    {
+        WriteFailed = FALSE;
+        report_writeErrorMsg(ERR_CHECKPOINT_FILE, CheckpointFile);
+    }
+}
+
+//=============================================================================
+
+#ifdef _WIN32
+unsigned __stdcall writerThread(void* arg)
+#else
+void* writerThread(void* arg)
+#endif
+//
+//  Input:   arg = not used
+//  Output:  none
+//  Purpose: body of the thread that writes a checkpoint file.
+//
+{
+    (void)arg;
+    WriteFailed = !writeCheckpoint();
+    return 0;
+}
+
+//=============================================================================
+
+unsigned long long hashFile(char* fname)
+//
+//  Input:   fname = name of a file
+//  Output:  returns hash of the file's contents
+//  Purpose: identifies the project a checkpoint belongs to.
+//
+{
+    FILE*  f;
+    char   buf[4096];
+    size_t n;
+    unsigned long long h = FNV_OFFSET;
+
+    f = fopen(fname, "rb");
+    if ( f == NULL ) return h;
+    while ( (n = fread(buf, 1, sizeof(buf), f)) > 0 ) h = hashBytes(h, buf, n);
+    fclose(f);
+    return h;
+}
+
+//=============================================================================
+
+long long getFileSize(char* fname)
+//
+//  Input:   fname = name of a file
+//  Output:  returns size of the file in bytes (-1 if it can't be opened)
+//  Purpose: finds the size of a file.
+//
+{
+    FILE*     f;
+    long long size;
+
+    f = fopen(fname, "rb");
+    if ( f == NULL ) return -1;
+    _fseeki64(f, 0, SEEK_END);
+    size = _ftelli64(f);
+    fclose(f);
+    return size;
+}
+
+//=============================================================================
+
+void syncFile(FILE* f)
+//
+//  Input:   f = an open file
+//  Output:  none
+//  Purpose: makes sure that what has been written to a file is on disk.
+//
+{
+    if ( f == NULL ) return;
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+//=============================================================================
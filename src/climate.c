@@ -8,6 +8,10 @@
 //   Author:  L. Rossman
 //
 //   Climate related functions.
+//
+//   A climate file's daily values are kept in a binary cache file (the
+//   climate file's name with ".cache" added) that is re-used by later runs
+//   as long as the climate file is unchanged.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -34,6 +38,11 @@ enum   WindSpeedType  {WDMV, AWND};                                            /
 static char* ClimateVarWords[] = {"TMIN", "TMAX", "EVAP", "WDMV", "AWND",      //(5.1.007)
                                   NULL};
 
+// These constants are used for the climate file's cache.
+#define MAXCACHEMONTHS 12000                // max. months held in a cache
+static const char CacheStamp[] = "SWMM5-CLIM";  // stamp of a cache file
+static const char CacheExtension[] = ".cache";  // added to climate file name
+
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
@@ -69,6 +78,19 @@ static int      FileFieldPos[4];       // start of data fields for file record /
 static int      FileDateFieldPos;      // start of date field for file record  //(5.1.007)
 static int      FileWindType;          // wind speed type;                     //(5.1.007)
 
+// Climate file cache variables
+static int      CacheYear;             // year of first month in cache
+static int      CacheMonth;            // first month of year in cache
+static int      CacheCount;            // number of months in cache
+static char*    CachePresent;          // TRUE if file has data for a month
+static double*  CacheData;             // each cached month's FileData values
+static int      CacheBuilding;         // TRUE while cache is being built
+static int      CacheFailed;           // TRUE if file can't be cached
+
+// Current date variables
+static DateTime StateDay;              // day when StateMonth was found
+static int      StateMonth;            // month of year of current date
+
 //-----------------------------------------------------------------------------
 //  External functions (defined in funcs.h)
 //-----------------------------------------------------------------------------
@@ -76,9 +98,11 @@ static int      FileWindType;          // wind speed type;                     /
 //  climate_readEvapParams             // called by input_parseLine
 //  climate_validate                   // called by project_validate
 //  climate_openFile                   // called by runoff_open
+//  climate_closeFile                  // called by runoff_close
 //  climate_initState                  // called by project_init
 //  climate_setState                   // called by runoff_execute
 //  climate_getNextEvap                // called by runoff_getTimeStep
+//  climate_snapshot                   // called by copyState in snapshot.c
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -92,7 +116,7 @@ static void readFileValues(void);
 static void setFileValues(int param);
 static void setEvap(DateTime theDate);
 static void setTemp(DateTime theDate);
-static void setWind(DateTime theDate);
+static void setWind(void);
 static void updateTempTimes(int day);
 static double getTempEvap(int day);
 static void updateFileValues(DateTime theDate);
@@ -105,6 +129,18 @@ static int  isGhcndFormat(char* line);                                         /
 static void readGhcndFileLine(int *year, int *month);                          //(5.1.007)
 static void parseGhcndFileLine(void);                                          //(5.1.007)
 
+static void readFileError(void);
+static void parseFileLine(void);
+static void openFileCache(void);
+static int  buildFileCache(void);
+static void storeCacheMonth(void);
+static int  addCacheMonth(int* capacity);
+static int  findCacheMonth(int y, int m);
+static int  readFileCache(char* fname, unsigned long long hash);
+static void writeFileCache(char* fname, unsigned long long hash);
+static void freeFileCache(void);
+static unsigned long long hashClimateFile(void);
+
 //=============================================================================
 
 int  climate_readParams(char* tok[], int ntoks)
@@ -141,6 +177,7 @@ int  climate_readParams(char* tok[], int ntoks)
         // --- record the time series as being the data source for temperature
         Temp.dataSource = TSERIES_TEMP;
         Temp.tSeries = i;
+        Temp.tsCursor = 0;
         Tseries[i].refersTo = TSERIES_TEMP;
         break;
 
@@ -430,7 +467,7 @@ void climate_openFile()
 //  Purpose: opens a climate file and reads in first set of values.
 //
 {
-    int i, m, y;
+    int i, k, m, y;
 
     // --- open the file
     if ( (Fclimate.file = fopen(Fclimate.name, "rt")) == NULL )
@@ -454,6 +491,10 @@ void climate_openFile()
         return;
     }
 
+    // --- load the file's daily values from its cache (building the
+    //     cache if it doesn't match the file)
+    openFileCache();
+
     // --- position file to begin reading climate file at either user-specified
     //     month/year or at start of simulation period.
     rewind(Fclimate.file);
@@ -462,16 +503,29 @@ void climate_openFile()
         datetime_decodeDate(StartDate, &FileYear, &FileMonth, &FileDay); 
     else
         datetime_decodeDate(Temp.fileStartDate, &FileYear, &FileMonth, &FileDay);
-    while ( !feof(Fclimate.file) )
+    if ( CacheData )
     {
-        strcpy(FileLine, "");
-        readFileLine(&y, &m);
-        if ( y == FileYear && m == FileMonth ) break;
+        // --- starting month must appear in the file
+        k = findCacheMonth(FileYear, FileMonth);
+        if ( k < 0 || !CachePresent[k] )
+        {
+            report_writeErrorMsg(ERR_CLIMATE_END_OF_FILE, Fclimate.name);
+            return;
+        }
     }
-    if ( feof(Fclimate.file) )
+    else
     {
-        report_writeErrorMsg(ERR_CLIMATE_END_OF_FILE, Fclimate.name);
-        return;
+        while ( !feof(Fclimate.file) )
+        {
+            strcpy(FileLine, "");
+            readFileLine(&y, &m);
+            if ( y == FileYear && m == FileMonth ) break;
+        }
+        if ( feof(Fclimate.file) )
+        {
+            report_writeErrorMsg(ERR_CLIMATE_END_OF_FILE, Fclimate.name);
+            return;
+        }
     }
     
     // --- initialize file dates and current climate variable values 
@@ -490,6 +544,20 @@ void climate_openFile()
 
 //=============================================================================
 
+void climate_closeFile()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: closes the climate file and frees its cached values.
+//
+{
+    if ( Fclimate.file ) fclose(Fclimate.file);
+    Fclimate.file = NULL;
+    freeFileCache();
+}
+
+//=============================================================================
+
 void climate_initState()
 //
 //  Input:   none
@@ -498,6 +566,7 @@ void climate_initState()
 //
 {
     LastDay = NO_DATE;
+    StateDay = NO_DATE;
     Temp.tmax = MISSING;
     Snow.removed = 0.0;
     NextEvapDate = StartDate;
@@ -516,11 +585,18 @@ void climate_setState(DateTime theDate)
 //  Purpose: sets climate variables for current date.
 //
 {
+    // --- find month of year only when a new day begins
+    if ( floor(theDate) != StateDay )
+    {
+        StateDay = floor(theDate);
+        StateMonth = datetime_monthOfYear(theDate);
+    }
+
     if ( Fclimate.mode == USE_FILE ) updateFileValues(theDate);
     if ( Temp.dataSource != NO_TEMP ) setTemp(theDate);
     setEvap(theDate);
-    setWind(theDate);
-    Adjust.rainFactor = Adjust.rain[datetime_monthOfYear(theDate)-1];          //(5.1.007)
+    setWind();
+    Adjust.rainFactor = Adjust.rain[StateMonth-1];                             //(5.1.007)
 }
 
 //=============================================================================
@@ -578,6 +654,41 @@ DateTime climate_getNextEvap(DateTime days)
 
 //=============================================================================
 
+void climate_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of the climate processor in a
+//           simulation state snapshot.
+//
+{
+    snapshot_copy(&Tmin, sizeof(Tmin));
+    snapshot_copy(&Tmax, sizeof(Tmax));
+    snapshot_copy(&Trng, sizeof(Trng));
+    snapshot_copy(&Trng1, sizeof(Trng1));
+    snapshot_copy(&Tave, sizeof(Tave));
+    snapshot_copy(&Hrsr, sizeof(Hrsr));
+    snapshot_copy(&Hrss, sizeof(Hrss));
+    snapshot_copy(&Hrday, sizeof(Hrday));
+    snapshot_copy(&Dhrdy, sizeof(Dhrdy));
+    snapshot_copy(&Dydif, sizeof(Dydif));
+    snapshot_copy(&LastDay, sizeof(LastDay));
+    snapshot_copy(&NextEvapDate, sizeof(NextEvapDate));
+    snapshot_copy(&NextEvapRate, sizeof(NextEvapRate));
+
+    // --- position within the climate file
+    snapshot_copy(&FileYear, sizeof(FileYear));
+    snapshot_copy(&FileMonth, sizeof(FileMonth));
+    snapshot_copy(&FileDay, sizeof(FileDay));
+    snapshot_copy(&FileLastDay, sizeof(FileLastDay));
+    snapshot_copy(&FileElapsedDays, sizeof(FileElapsedDays));
+    snapshot_copy(FileValue, sizeof(FileValue));
+    snapshot_copy(FileData, sizeof(FileData));
+    snapshot_copyFilePos(Fclimate.file);
+}
+
+//=============================================================================
+
 void updateFileValues(DateTime theDate)
 //
 //  Input:   theDate = current simulation date
@@ -642,7 +753,7 @@ void setTemp(DateTime theDate)
     double   tmp;                      // temporary temperature
 
     // --- see if a new day has started
-    mon = datetime_monthOfYear(theDate);                                       //(5.1.007)
+    mon = StateMonth;                                                          //(5.1.007)
     theDay = floor(theDate);
     if ( theDay > LastDay )
     {
@@ -694,7 +805,8 @@ void setTemp(DateTime theDate)
         k = Temp.tSeries;
         if ( k >= 0)
         {
-            Temp.ta = table_tseriesLookup(&Tseries[k], theDate, TRUE);
+            Temp.ta = table_tseriesCursorLookup(&Tseries[k], &Temp.tsCursor,
+                                                theDate, TRUE);
 
             // --- convert from deg. C to deg. F if need be
             if ( UnitSystem == SI )
@@ -721,7 +833,7 @@ void setEvap(DateTime theDate)
 //
 {
     int k;
-    int mon = datetime_monthOfYear(theDate);                                   //(5.1.007)
+    int mon = StateMonth;                                                      //(5.1.007)
 
     switch ( Evap.type )
     {
@@ -764,20 +876,17 @@ void setEvap(DateTime theDate)
 
 //=============================================================================
 
-void setWind(DateTime theDate)
+void setWind()
 //
-//  Input:   theDate = simulation date
+//  Input:   none
 //  Output:  none
-//  Purpose: sets wind speed (mph) for a specified date.
+//  Purpose: sets wind speed (mph) for the current month or day.
 //
 {
-    int yr, mon, day;
-
     switch ( Wind.type )
     {
       case MONTHLY_WIND:
-        datetime_decodeDate(theDate, &yr, &mon, &day);
-        Wind.ws = Wind.aws[mon-1] / UCF(WINDSPEED);
+        Wind.ws = Wind.aws[StateMonth-1] / UCF(WINDSPEED);
         break;
 
       case FILE_WIND:
@@ -934,7 +1043,7 @@ void readUserFileLine(int* y, int* m)
     n = sscanf(FileLine, "%s %d %d", staID, y, m);
     if ( n < 3 )
     {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+        readFileError();
     }
 }
 
@@ -957,7 +1066,7 @@ void readTD3200FileLine(int* y, int* m)
     len = strlen(FileLine);
     if ( len < 30 )
     {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+        readFileError();
         return;
     }
 
@@ -965,7 +1074,7 @@ void readTD3200FileLine(int* y, int* m)
     sstrncpy(recdType, FileLine, 3);
     if ( strcmp(recdType, "DLY") != 0 )
     {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+        readFileError();
         return;
     }
 
@@ -994,7 +1103,7 @@ void readDLY0204FileLine(int* y, int* m)
     len = strlen(FileLine);
     if ( len < 16 )
     {
-        report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+        readFileError();
         return;
     }
 
@@ -1014,7 +1123,7 @@ void readFileValues()
 //  Purpose: reads next month's worth of data from climate file.
 //
 {
-    int  i, j;
+    int  i, j, k;
     int  y, m;
 
     // --- initialize FileData array to missing values
@@ -1023,6 +1132,15 @@ void readFileValues()
         for (j=0; j<MAXDAYSPERMONTH; j++) FileData[i][j] = MISSING;
     }
 
+    // --- copy the month's values from the file's cache if it's in use
+    if ( CacheData )
+    {
+        k = findCacheMonth(FileYear, FileMonth);
+        if ( k >= 0 ) memcpy(FileData,
+            &CacheData[k * MAXCLIMATEVARS * MAXDAYSPERMONTH], sizeof(FileData));
+        return;
+    }
+
     while ( !ErrorCode )
     {
         // --- return when date on line is after current file date
@@ -1031,19 +1149,45 @@ void readFileValues()
         if ( y > FileYear || m > FileMonth ) return;
 
         // --- parse climate values from file line
-        switch (FileFormat)
-        {
-        case  USER_PREPARED: parseUserFileLine();   break;
-        case  TD3200:        parseTD3200FileLine();  break;
-        case  DLY0204:       parseDLY0204FileLine(); break;
-        case  GHCND:         parseGhcndFileLine();   break;                    //(5.1.007)
-        }
+        parseFileLine();
         strcpy(FileLine, "");
     }
 }
 
 //=============================================================================
 
+void parseFileLine()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: parses climate values from the current line of the climate file.
+//
+{
+    switch (FileFormat)
+    {
+    case  USER_PREPARED: parseUserFileLine();   break;
+    case  TD3200:        parseTD3200FileLine();  break;
+    case  DLY0204:       parseDLY0204FileLine(); break;
+    case  GHCND:         parseGhcndFileLine();   break;                        //(5.1.007)
+    }
+}
+
+//=============================================================================
+
+void readFileError()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: reports an error in a line of the climate file (or notes that
+//           the file can't be cached if its cache is being built).
+//
+{
+    if ( CacheBuilding ) CacheFailed = TRUE;
+    else report_writeErrorMsg(ERR_CLIMATE_FILE_READ, Fclimate.name);
+}
+
+//=============================================================================
+
 void parseUserFileLine()
 //
 //  Input:   none
@@ -1380,3 +1524,305 @@ void parseGhcndFileLine()
 }
 
 //=============================================================================
+
+void openFileCache()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: loads a climate file's daily values from its cache file,
+//           building the cache if it doesn't match the climate file.
+//
+//  Note:    CacheData is left NULL (and the climate file is read line by
+//           line) if the file's lines are out of date order or have errors,
+//           so that these are handled exactly as before.
+{
+    char fname[MAXFNAME+8];
+    unsigned long long hash;
+
+    freeFileCache();
+    hash = hashClimateFile();
+    if ( hash == 0 ) return;
+    sstrncpy(fname, Fclimate.name, MAXFNAME);
+    strcat(fname, CacheExtension);
+    if ( readFileCache(fname, hash) ) return;
+    freeFileCache();
+    if ( buildFileCache() ) writeFileCache(fname, hash);
+    else freeFileCache();
+}
+
+//=============================================================================
+
+int buildFileCache()
+//
+//  Input:   none
+//  Output:  returns TRUE if the climate file's values were cached
+//  Purpose: reads each month's daily values from the climate file into
+//           the cache.
+//
+{
+    int y, m;
+    int capacity = 0;
+    int started = FALSE;
+
+    CacheBuilding = TRUE;
+    CacheFailed = FALSE;
+    CacheCount = 0;
+    rewind(Fclimate.file);
+    strcpy(FileLine, "");
+    while ( !CacheFailed )
+    {
+        // --- read next line (quitting at end of file)
+        y = 0;
+        m = 0;
+        readFileLine(&y, &m);
+        if ( strlen(FileLine) == 0 || CacheFailed ) break;
+
+        // --- a line without a valid month (e.g., a GHCND line for another
+        //     station) is skipped before the first month starts and is
+        //     otherwise parsed into the current month, as readFileValues does
+        if ( m < 1 || m > 12 )
+        {
+            if ( !started )
+            {
+                strcpy(FileLine, "");
+                continue;
+            }
+            if ( y > FileYear || m > FileMonth )
+            {
+                CacheFailed = TRUE;
+                break;
+            }
+        }
+
+        // --- start the first month
+        else if ( !started )
+        {
+            started = TRUE;
+            CacheYear = FileYear = y;
+            CacheMonth = FileMonth = m;
+            if ( !addCacheMonth(&capacity) ) break;
+            CachePresent[0] = TRUE;
+        }
+
+        // --- start a later month (adding any months missing from the file)
+        else if ( y != FileYear || m != FileMonth )
+        {
+            // --- months must appear in date order
+            if ( y < FileYear || (y == FileYear && m < FileMonth) )
+            {
+                CacheFailed = TRUE;
+                break;
+            }
+            while ( y != FileYear || m != FileMonth )
+            {
+                storeCacheMonth();
+                FileMonth++;
+                if ( FileMonth > 12 )
+                {
+                    FileMonth = 1;
+                    FileYear++;
+                }
+                if ( !addCacheMonth(&capacity) ) break;
+            }
+            if ( CacheFailed ) break;
+            CachePresent[CacheCount-1] = TRUE;
+        }
+
+        // --- parse climate values from file line
+        parseFileLine();
+        strcpy(FileLine, "");
+    }
+    if ( started && !CacheFailed ) storeCacheMonth();
+    CacheBuilding = FALSE;
+    return started && !CacheFailed;
+}
+
+//=============================================================================
+
+void storeCacheMonth()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: copies the values read for the current month into the cache.
+//
+{
+    memcpy(&CacheData[(CacheCount-1) * MAXCLIMATEVARS * MAXDAYSPERMONTH],
+        FileData, sizeof(FileData));
+}
+
+//=============================================================================
+
+int addCacheMonth(int* capacity)
+//
+//  Input:   capacity = number of months the cache has room for
+//  Output:  returns FALSE if the cache can't grow
+//  Purpose: adds a month without any values to the end of the cache.
+//
+{
+    int     i, j;
+    int     n = MAXCLIMATEVARS * MAXDAYSPERMONTH;
+    char*   present;
+    double* data;
+
+    // --- grow the cache when it's full
+    if ( CacheCount == *capacity )
+    {
+        if ( CacheCount >= MAXCACHEMONTHS )
+        {
+            CacheFailed = TRUE;
+            return FALSE;
+        }
+        *capacity = (*capacity == 0) ? 120 : 2 * (*capacity);
+        present = (char *) realloc(CachePresent, *capacity * sizeof(char));
+        if ( present ) CachePresent = present;
+        data = (double *) realloc(CacheData, *capacity * n * sizeof(double));
+        if ( data ) CacheData = data;
+        if ( present == NULL || data == NULL )
+        {
+            CacheFailed = TRUE;
+            return FALSE;
+        }
+    }
+
+    // --- start the month with missing values
+    CachePresent[CacheCount] = FALSE;
+    CacheCount++;
+    for ( i=0; i<MAXCLIMATEVARS; i++)
+    {
+        for (j=0; j<MAXDAYSPERMONTH; j++) FileData[i][j] = MISSING;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int findCacheMonth(int y, int m)
+//
+//  Input:   y = year
+//           m = month of year
+//  Output:  returns index of month in the cache (-1 if not cached)
+//  Purpose: locates a month's values in the climate file cache.
+//
+{
+    int k = (y - CacheYear) * 12 + m - CacheMonth;
+    if ( k < 0 || k >= CacheCount ) return -1;
+    return k;
+}
+
+//=============================================================================
+
+int readFileCache(char* fname, unsigned long long hash)
+//
+//  Input:   fname = name of cache file
+//           hash = hash of the climate file
+//  Output:  returns TRUE if the cache file was read
+//  Purpose: reads a climate file's daily values from a cache file saved
+//           by an earlier run.
+//
+{
+    FILE*  f;
+    char   stamp[sizeof(CacheStamp)];
+    int    n = MAXCLIMATEVARS * MAXDAYSPERMONTH;
+    int    result = FALSE;
+    unsigned long long fileHash;
+
+    f = fopen(fname, "rb");
+    if ( f == NULL ) return FALSE;
+    if ( fread(stamp, sizeof(stamp), 1, f) == 1 &&
+         memcmp(stamp, CacheStamp, sizeof(stamp)) == 0 &&
+         fread(&fileHash, sizeof(fileHash), 1, f) == 1 &&
+         fileHash == hash &&
+         fread(&CacheYear, sizeof(int), 1, f) == 1 &&
+         fread(&CacheMonth, sizeof(int), 1, f) == 1 &&
+         fread(&CacheCount, sizeof(int), 1, f) == 1 &&
+         CacheCount > 0 && CacheCount <= MAXCACHEMONTHS )
+    {
+        CachePresent = (char *) malloc(CacheCount * sizeof(char));
+        CacheData = (double *) malloc(CacheCount * n * sizeof(double));
+        result = CachePresent && CacheData &&
+            fread(CachePresent, sizeof(char), CacheCount, f) ==
+                (size_t)CacheCount &&
+            fread(CacheData, n * sizeof(double), CacheCount, f) ==
+                (size_t)CacheCount;
+    }
+    fclose(f);
+    return result;
+}
+
+//=============================================================================
+
+void writeFileCache(char* fname, unsigned long long hash)
+//
+//  Input:   fname = name of cache file
+//           hash = hash of the climate file
+//  Output:  none
+//  Purpose: saves the cached daily values so that later runs can skip
+//           reading the climate file.
+//
+//  Note:    the cache is written to a temporary file that then replaces
+//           any existing cache file, so that a run that stops part way
+//           never leaves a partial cache behind; the cache file is simply
+//           not saved if it can't be written.
+{
+    FILE*  f;
+    char   tmpName[MAXFNAME+13];
+    int    n = MAXCLIMATEVARS * MAXDAYSPERMONTH;
+    int    ok;
+
+    sprintf(tmpName, "%s.tmp", fname);
+    f = fopen(tmpName, "wb");
+    if ( f == NULL ) return;
+    ok = fwrite(CacheStamp, sizeof(CacheStamp), 1, f) == 1 &&
+         fwrite(&hash, sizeof(hash), 1, f) == 1 &&
+         fwrite(&CacheYear, sizeof(int), 1, f) == 1 &&
+         fwrite(&CacheMonth, sizeof(int), 1, f) == 1 &&
+         fwrite(&CacheCount, sizeof(int), 1, f) == 1 &&
+         fwrite(CachePresent, sizeof(char), CacheCount, f) ==
+             (size_t)CacheCount &&
+         fwrite(CacheData, n * sizeof(double), CacheCount, f) ==
+             (size_t)CacheCount;
+    if ( fclose(f) != 0 ) ok = FALSE;
+    if ( ok ) ok = replaceFile(fname, tmpName);
+    if ( !ok ) remove(tmpName);
+}
+
+//=============================================================================
+
+void freeFileCache()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used by the climate file cache.
+//
+{
+    FREE(CachePresent);
+    FREE(CacheData);
+    CacheCount = 0;
+}
+
+//=============================================================================
+
+unsigned long long hashClimateFile()
+//
+//  Input:   none
+//  Output:  returns hash of the climate file & how it is read
+//           (0 if the file can't be read)
+//  Purpose: identifies the daily values a climate file's cache must hold.
+//
+{
+    FILE*  f;
+    char   buf[16384];
+    size_t n;
+    unsigned long long h = FNV_OFFSET;
+
+    f = fopen(Fclimate.name, "rb");
+    if ( f == NULL ) return 0;
+    h = hashBytes(h, &FileFormat, sizeof(int));
+    h = hashBytes(h, &UnitSystem, sizeof(int));
+    while ( (n = fread(buf, 1, sizeof(buf), f)) > 0 ) h = hashBytes(h, buf, n);
+    fclose(f);
+    if ( h == 0 ) h = 1;
+    return h;
+}
+
+//=============================================================================
@@ -46,6 +46,7 @@
 #define   GRAVITY            32.2           // accel. of gravity in US units
 #define   SI_GRAVITY         9.81           // accel of gravity in SI units
 //2014-11-10:EMNET ------------ #define   MAXFILESIZE        2147483647L    // largest file size in bytes
+#define   FNV_OFFSET         14695981039346656037ULL  // Initial hashBytes() value
 #define   MAXFILESIZE        9223372036854775807LL    //2014-11-10:EMNET: largest file size in bytes, using LONG LONG = INT8 = fpos_t 
 
 //-----------------------------
@@ -28,6 +28,7 @@
 #define MAX_STACK  1000			//2014-09-02:EMNET
 #define BIG_NUMBER 1e32			//2014-09-04:EMNET
 #define EPSILON    1e-20		//2014-09-04:EMNET
+#define N_PID_VARS 13                  // number of real-valued PID bank arrays
 
 #include <malloc.h>
 #include <math.h>
@@ -38,7 +39,7 @@
 //  Constants
 //-----------------------------------------------------------------------------
 enum RuleState   {r_RULE, r_IF, r_AND, r_OR, r_THEN, r_ELSE, r_PRIORITY,
-                  r_ERROR};
+                  r_EVERY, r_ERROR};
 enum RuleObject  {r_NODE, r_LINK, r_CONDUIT, r_PUMP, r_ORIFICE, r_WEIR,
 	              r_OUTLET, r_SIMULATION, r_STACK};								//2014-08-28:EMNET: added r_STACK
 enum RuleAttrib  {r_DEPTH, r_HEAD, r_INFLOW, r_FLOW, r_STATUS, r_SETTING,
@@ -91,6 +92,7 @@ struct  TPremise
    int      attribute;
    int      operand;
    double   value;
+   double   lastInput;                 // input value at last evaluation
    struct   TPremise *next;
 };
 
@@ -102,9 +104,12 @@ struct  TAction
    int     attribute;
    int     curve;
    int     tseries;
+   int     tsCursor;           // time bracket in action's time series
    double  value;
    double  kp, ki, kd;
-   double  e1, e2, e3;			//2014-09-23:EMNET: added e3 for the PID3 derivative term
+   double  sMin, sMax;         // limits on PID setting
+   double  rateMax;            // max. change in PID setting per minute
+   int     pid;                // index in PID controller bank (-1 if none)
    struct  TAction *next;
 };
 
@@ -124,6 +129,34 @@ struct  TRule
    struct   TPremise* lastPremise;     // Pointer to last premise of rule
    struct   TAction*  thenActions;     // Linked list of actions if true
    struct   TAction*  elseActions;     // Linked list of actions if false
+   double   interval;                  // Evaluation interval (days)
+   double   lastTime;                  // Elapsed time of last evaluation (days)
+   double   nextTime;                  // Elapsed time of next evaluation (days)
+   int      canSkip;                   // TRUE if skipped when inputs unchanged
+   int      usesStack;                 // TRUE if a premise uses the stack
+   int      result;                    // Last premise result (-1 if none yet)
+};
+
+// Bank of PID controllers, one entry per PID/PID2/PID3 action, stored as
+// contiguous arrays so that all controllers are updated in a single pass
+struct  TPidBank
+{
+   int      count;             // number of PID controllers
+   char*    active;            // TRUE if controller's action was selected
+   int*     link;              // index of controlled link
+   int*     form;              // r_PID, r_PID2 or r_PID3
+   double*  kp;                // gain coefficient
+   double*  ki;                // integral time (minutes)
+   double*  kd;                // derivative time (minutes)
+   double*  sMin, *sMax;       // limits on controller setting
+   double*  rateMax;           // max. change in setting per minute
+   double*  antiWindup;        // 1 if integral term held at setting limits
+   double*  e1, *e2, *e3;      // errors 1, 2 & 3 time steps ago
+   double*  setPoint;          // current controller set point
+   double*  controlValue;      // current value of controlled variable
+   double*  dt;                // current time step (minutes)
+   double*  block;             // memory block holding the real arrays
+   struct   TAction** action;  // action that each controller belongs to
 };
 
 //-----------------------------------------------------------------------------
@@ -135,6 +168,7 @@ int    InputState;                     // State of rule interpreter
 int    RuleCount;                      // Total number of rules
 double ControlValue;                   // Value of controller variable
 double SetPoint;                       // Value of controller setpoint
+struct TPidBank     PidBank;           // Bank of PID controllers
 
 double Control_Stack[MAX_STACK] = { NAN };		//2014-09-02: EMNET CONTROL STACK VALUES
 int    Stack_Index;	      						//2014-09-02: EMNET CONTROL STACK INDEX: increments UP from 0
@@ -158,6 +192,7 @@ extern REAL4* LinkResults;             //  "
 //     controls_delete
 //     controls_addRuleClause
 //     controls_evaluate
+//     controls_snapshot
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -169,6 +204,11 @@ int    evaluatePremise(struct TPremise* p, DateTime theDate, DateTime theTime,
 int    checkTimeValue(struct TPremise* p, double tStart, double tStep);
 int    checkValue(struct TPremise* p, double x);
 void   updateActionList(struct TAction* a);
+int    isRuleDue(int r, DateTime elapsedTime);
+int    inputsHaveChanged(int r, DateTime theDate);
+void   saveRuleInputs(int r, DateTime theDate);
+double getPremiseInput(struct TPremise* p, DateTime theDate);
+void   carryOverActions(int r);
 int    executeActionList(DateTime currentTime);
 void   clearActionList(void);
 void   deleteActionList(void);
@@ -177,10 +217,9 @@ int    findExactMatch(char *s, char *keyword[]);
 int    setActionSetting(char* tok[], int nToks, int* curve, int* tseries,
        int* attrib, double* value);
 void   updateActionValue(struct TAction* a, DateTime currentTime, double dt);
-double getPIDSetting(struct TAction* a, double dt);
-
-double getPID2_Setting(struct TAction* a, double dt);
-double getPID3_Setting(struct TAction* a, double dt);
+int    createPidBank(void);
+void   deletePidBank(void);
+void   updatePidBank(void);
 
 void Stack_Push(double TopValue);
 double Stack_Pop_value();
@@ -200,6 +239,8 @@ int  controls_create(int n)
    ActionList = NULL;
    InputState = r_PRIORITY;
    RuleCount = n;
+   PidBank.count = 0;
+   PidBank.block = NULL;
    if ( n == 0 ) return 0;
    Rules = (struct TRule *) calloc(RuleCount, sizeof(struct TRule));
    if (Rules == NULL) return ERR_MEMORY;
@@ -211,6 +252,12 @@ int  controls_create(int n)
        Rules[r].thenActions = NULL;
        Rules[r].elseActions = NULL;
        Rules[r].priority = 0.0;    
+       Rules[r].interval = 0.0;
+       Rules[r].lastTime = 0.0;
+       Rules[r].nextTime = 0.0;
+       Rules[r].canSkip = TRUE;
+       Rules[r].usesStack = FALSE;
+       Rules[r].result = -1;
    }
    return 0;
 }
@@ -226,6 +273,7 @@ void controls_delete(void)
 {
    if ( RuleCount == 0 ) return;
    deleteActionList();
+   deletePidBank();
    deleteRules();
 }
 
@@ -276,11 +324,23 @@ int  controls_addRuleClause(int r, int keyword, char* tok[], int nToks)
         return addAction(r, tok, nToks);
 
       case r_PRIORITY:
-        if ( InputState != r_THEN && InputState != r_ELSE ) return ERR_RULE;
+        if ( InputState != r_THEN && InputState != r_ELSE &&
+             InputState != r_EVERY ) return ERR_RULE;
         InputState = r_PRIORITY;
         if ( !getDouble(tok[1], &Rules[r].priority) ) return ERR_NUMBER;
         if ( nToks > 2 ) return ERR_RULE;
         return 0;
+
+      // --- evaluation interval (seconds) for the rule
+      case r_EVERY:
+        if ( InputState != r_THEN && InputState != r_ELSE &&
+             InputState != r_PRIORITY ) return ERR_RULE;
+        InputState = r_EVERY;
+        if ( !getDouble(tok[1], &Rules[r].interval) ) return ERR_NUMBER;
+        if ( Rules[r].interval < 0.0 ) return ERR_NUMBER;
+        Rules[r].interval /= SECperDAY;
+        if ( nToks > 2 ) return ERR_RULE;
+        return 0;
     }
     return 0;
 }
@@ -298,6 +358,7 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 {
     int    r;                          // control rule index
     int    result;                     // TRUE if rule premises satisfied
+    double dt;                         // time since rule last evaluated (days)
     struct TPremise* p;                // pointer to rule premise clause
     struct TAction*  a;                // pointer to rule action clause
     DateTime theDate = floor(currentTime);
@@ -305,12 +366,38 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 
     // --- evaluate each rule
     if ( RuleCount == 0 ) return 0;
+    if ( PidBank.count > 0 && PidBank.block == NULL )
+    {
+        if ( !createPidBank() ) return 0;
+    }
     clearActionList();
 
 	Clear_Stack();			//2014-09-02:EMNET
 
     for (r=0; r<RuleCount; r++)
     {
+        // --- re-use rule's previous actions if it is not yet due for
+        //     evaluation or if none of its premise inputs have changed
+        if ( !isRuleDue(r, elapsedTime) ||
+             ( Rules[r].canSkip && !inputsHaveChanged(r, theDate) ) )
+        {
+            carryOverActions(r);
+            continue;
+        }
+
+        // --- rules with an evaluation interval use the time elapsed
+        //     since their last evaluation as their time step
+        dt = tStep;
+        if ( Rules[r].interval > 0.0 && Rules[r].result >= 0 )
+        {
+            dt = MAX(tStep, elapsedTime - Rules[r].lastTime);
+        }
+        Rules[r].lastTime = elapsedTime;
+        if ( Rules[r].interval > 0.0 )
+        {
+            Rules[r].nextTime = elapsedTime + Rules[r].interval;
+        }
+
         // --- evaluate rule's premises
         result = TRUE;
         p = Rules[r].firstPremise;
@@ -320,16 +407,18 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
             {
                 if ( result == FALSE )
                     result = evaluatePremise(p, theDate, theTime,
-                                 elapsedTime, tStep);
+                                 elapsedTime, dt);
             }
             else
             {
                 if ( result == FALSE ) break;
                 result = evaluatePremise(p, theDate, theTime, 
-                             elapsedTime, tStep);
+                             elapsedTime, dt);
             }
             p = p->next;
         }    
+        Rules[r].result = result;
+        if ( Rules[r].canSkip ) saveRuleInputs(r, theDate);
 
         // --- if premises true, add THEN clauses to action list
         //     else add ELSE clauses to action list
@@ -337,12 +426,15 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
         else                  a = Rules[r].elseActions;
         while (a)
         {
-            updateActionValue(a, currentTime, tStep);
+            updateActionValue(a, currentTime, dt);
             updateActionList(a);
             a = a->next;
         }
     }
 
+    // --- find new settings for all PID controllers whose actions were selected
+    if ( PidBank.count > 0 ) updatePidBank();
+
     // --- execute actions on action list
     if ( ActionList ) return executeActionList(currentTime);
     else return 0;
@@ -350,6 +442,43 @@ int controls_evaluate(DateTime currentTime, DateTime elapsedTime, double tStep)
 
 //=============================================================================
 
+void controls_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of the control rules in a
+//           simulation state snapshot.
+//
+//  Note:    action values are included since a rule skipped because its
+//           inputs are unchanged re-uses the values from its last evaluation.
+//           The PID bank's arrays (incl. its integrators) are copied whole.
+{
+    int r;
+    struct TPremise* p;
+    struct TAction*  a;
+
+    for (r = 0; r < RuleCount; r++)
+    {
+        snapshot_copy(&Rules[r].lastTime, sizeof(Rules[r].lastTime));
+        snapshot_copy(&Rules[r].nextTime, sizeof(Rules[r].nextTime));
+        snapshot_copy(&Rules[r].result, sizeof(Rules[r].result));
+        for (p = Rules[r].firstPremise; p; p = p->next)
+            snapshot_copy(&p->lastInput, sizeof(p->lastInput));
+        for (a = Rules[r].thenActions; a; a = a->next)
+            snapshot_copy(&a->value, sizeof(a->value));
+        for (a = Rules[r].elseActions; a; a = a->next)
+            snapshot_copy(&a->value, sizeof(a->value));
+    }
+    if ( PidBank.count > 0 )
+    {
+        snapshot_copy(PidBank.block, N_PID_VARS * PidBank.count *
+                      sizeof(double));
+        snapshot_copy(PidBank.active, PidBank.count * sizeof(char));
+    }
+}
+
+//=============================================================================
+
 int  addPremise(int r, int type, char* tok[], int nToks)
 //
 //  Input:   r = control rule index
@@ -520,7 +649,18 @@ int  addPremise(int r, int type, char* tok[], int nToks)
     p->attribute = attrib;
     p->operand   = op;
     p->value     = value;		//<----------------NORMAL SWMM LINE OF CODE
+    p->lastInput = MISSING;
+
+    // --- premises on time or on the stack must be evaluated every time
+    if ( attrib == r_TIME || attrib == r_CLOCKTIME ||
+         attrib == r_STACK_RESULT || attrib == r_STACK_OPER ||
+         op > GE ) Rules[r].canSkip = FALSE;
 
+    // --- stack premises, and node or link premises with a stack operand,
+    //     update the shared Control_Stack, so later rules depend on them
+    //     being evaluated at every step
+    if ( attrib == r_STACK_RESULT || attrib == r_STACK_OPER || op > GE )
+        Rules[r].usesStack = TRUE;
 
     p->next      = NULL;
     if ( Rules[r].firstPremise == NULL )
@@ -550,7 +690,7 @@ int  addAction(int r, char* tok[], int nToks)
     int    curve = -1, tseries = -1;
     int    n;
     int    err;
-    double values[] = {1.0, 0.0, 0.0};
+    double values[] = {1.0, 0.0, 0.0, 0.0, MISSING, 0.0};
 
     struct TAction* a;
 
@@ -642,6 +782,8 @@ int  addAction(int r, char* tok[], int nToks)
     n = 6;
     if ( curve >= 0 || tseries >= 0 ) n = 7;
 	if ((attrib == r_PID) || (attrib == r_PID2) || (attrib == r_PID3)) n = 9;			//2014-09-10:EMNET: added  || (attrib == r_PID2) ... and r_PID3 
+    if ( n == 9 ) while ( n < nToks && n < 12 &&
+                          findExactMatch(tok[n], RuleKeyWords) < 0 ) n++;
 	if (n < nToks && findExactMatch(tok[n], RuleKeyWords) >= 0) return ERR_RULE;			//2014-08-13:EMNET: this was just findmatch() before
 
     // --- create the action object
@@ -652,16 +794,33 @@ int  addAction(int r, char* tok[], int nToks)
     a->attribute = attrib;
     a->curve     = curve;
     a->tseries   = tseries;
+    a->tsCursor  = 0;
     a->value     = values[0];
+    a->pid       = -1;
 	if ((attrib == r_PID) || (attrib == r_PID2) || (attrib == r_PID3))			//2014-09-10:EMNET: added  || (attrib == r_PID2) ... and r_PID3
     {
         a->kp = values[0];
         a->ki = values[1];
         a->kd = values[2];
-        a->e1 = 0.0;
-        a->e2 = 0.0;
-		a->e3 = 0.0;		//2014-09-23:EMNET: for PID3 function
+
+        // --- optional setting limits (sMax is MISSING if not supplied)
+        a->sMin = values[3];
+        a->sMax = values[4];
+        if ( a->sMax != MISSING && a->sMax < a->sMin )
+        {
+            free(a);
+            return error_setInpError(ERR_NUMBER, tok[10]);
+        }
+        a->rateMax = values[5];
+        a->pid = PidBank.count;
+        PidBank.count++;
     }
+
+    // --- actions with time varying or stateful settings must be
+    //     updated every time their rule is evaluated
+    if ( tseries >= 0 || curve == -999 || attrib == r_PID ||
+         attrib == r_PID2 || attrib == r_PID3 ) Rules[r].canSkip = FALSE;
+
     if ( InputState == r_THEN )
     {
         a->next = Rules[r].thenActions;
@@ -728,6 +887,16 @@ int  setActionSetting(char* tok[], int nToks, int* curve, int* tseries,
                 return error_setInpError(ERR_NUMBER, tok[m]);
         }
 
+        // --- optional min. & max. settings and max. rate of change
+        //     (the min. setting and rate can't be negative)
+        for (m=9; m<nToks && m<=11; m++)
+        {
+            if ( findExactMatch(tok[m], RuleKeyWords) >= 0 ) break;
+            if ( !getDouble(tok[m], &values[m-6]) ||
+                 ( m != 10 && values[m-6] < 0.0 ) )
+                return error_setInpError(ERR_NUMBER, tok[m]);
+        }
+
 		//2014-10-15:EMNET: NOTE: EPA line of code below replaces what was an "R_SETTING" code by "R_PID".  
 		//But that ends up using one of the "RuleSetting" codes instead of one from the "RuleAttrib" list, 
 		//and that led to cross-over problems when the lists were updated with new commands.
@@ -770,20 +939,18 @@ void  updateActionValue(struct TAction* a, DateTime currentTime, double dt)
     }
     else if ( a->tseries >= 0 )
     {
-        a->value = table_tseriesLookup(&Tseries[a->tseries], currentTime, TRUE);
+        a->value = table_tseriesCursorLookup(&Tseries[a->tseries],
+                                             &a->tsCursor, currentTime, TRUE);
     }
-    else if ( a->attribute == r_PID )
+    else if ( a->pid >= 0 )
     {
-        a->value = getPIDSetting(a, dt);
+        // --- save controller's inputs; its new setting is found
+        //     later in updatePidBank()
+        PidBank.active[a->pid] = TRUE;
+        PidBank.setPoint[a->pid] = SetPoint;
+        PidBank.controlValue[a->pid] = ControlValue;
+        PidBank.dt[a->pid] = dt * 1440.0;
     }
-	else if (a->attribute == r_PID2)			//2014-09-10:EMNET
-	{
-		a->value = getPID2_Setting(a, dt);		//2014-09-10:EMNET
-	}
-	else if (a->attribute == r_PID3)			//2014-09-23:EMNET
-	{
-		a->value = getPID3_Setting(a, dt);		//2014-09-23:EMNET
-	}
 
 
 	else if ((a->curve == -999) && (a->tseries == -999)) {			//2014-10-10: new way of flagging r_STACKRESULT_ACTION
@@ -796,199 +963,189 @@ void  updateActionValue(struct TAction* a, DateTime currentTime, double dt)
 
 //=============================================================================
 
-double getPIDSetting(struct TAction* a, double dt)
+int createPidBank(void)
 //
-//  Input:   a = an action object
-//           dt = current time step (days)
-//  Output:  returns a new link setting 
-//  Purpose: computes a new setting for a link subject to a PID controller.
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: gathers the parameters of all PID actions into the
+//           PID controller bank.
 //
-//  Note:    a->kp = gain coefficient,
-//           a->ki = integral time (minutes)
-//           a->k2 = derivative time (minutes)
-//           a->e1 = error from previous time step
-//           a->e2 = error from two time steps ago
 {
-    double e0, setting;
-	double p, i, d, update;
-	double tolerance = 0.0001;
-
-	// --- convert time step from days to minutes
-	dt *= 1440.0;
+    int    r, k, n = PidBank.count;
+    int    kind;
+    double* x;
+    struct TAction* a;
 
-    // --- determine relative error in achieving controller set point
-    e0 = SetPoint - ControlValue;
-    if ( fabs(e0) > TINY )
+    // --- allocate memory for the bank's arrays
+    PidBank.block = (double *) calloc(N_PID_VARS * n, sizeof(double));
+    PidBank.active = (char *) calloc(n, sizeof(char));
+    PidBank.link = (int *) calloc(n, sizeof(int));
+    PidBank.form = (int *) calloc(n, sizeof(int));
+    PidBank.action = (struct TAction **) calloc(n, sizeof(struct TAction *));
+    if ( !PidBank.block || !PidBank.active || !PidBank.link ||
+         !PidBank.form || !PidBank.action )
     {
-        if ( SetPoint != 0.0 ) e0 = e0/SetPoint;
-        else                   e0 = e0/ControlValue;
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
     }
-
-	// --- reset previous errors to 0 if controller gets stuck
-	if (fabs(e0 - a->e1) < tolerance)
-	{
-		a->e2 = 0.0;
-		a->e1 = 0.0;
-	}
-
-    // --- use the recursive form of the PID controller equation to
-    //     determine the new setting for the controlled link
-	p = (e0 - a->e1);
-	if ( a->ki == 0.0 ) i = 0.0;
-	else i = e0 * dt / a->ki;
-	d = a->kd * (e0 - 2.0*a->e1 + a->e2) / dt;
-	update = a->kp * (p + i + d);
-	if ( fabs(update) < tolerance ) update = 0.0;
-	setting = Link[a->link].targetSetting + update;
-
-	// --- update previous errors
-    a->e2 = a->e1;
-    a->e1 = e0;
-
-    // --- check that new setting lies within feasible limits
-    if ( setting < 0.0 ) setting = 0.0;
-    if (Link[a->link].type != PUMP && setting > 1.0 ) setting = 1.0;
-    return setting;
+    x = PidBank.block;
+    PidBank.kp = x;            x += n;
+    PidBank.ki = x;            x += n;
+    PidBank.kd = x;            x += n;
+    PidBank.sMin = x;          x += n;
+    PidBank.sMax = x;          x += n;
+    PidBank.rateMax = x;       x += n;
+    PidBank.antiWindup = x;    x += n;
+    PidBank.e1 = x;            x += n;
+    PidBank.e2 = x;            x += n;
+    PidBank.e3 = x;            x += n;
+    PidBank.setPoint = x;      x += n;
+    PidBank.controlValue = x;  x += n;
+    PidBank.dt = x;
+
+    // --- transfer parameters of each PID action to the bank
+    for (r = 0; r < RuleCount; r++)
+    {
+        for (kind = 0; kind < 2; kind++)
+        {
+            if ( kind == 0 ) a = Rules[r].thenActions;
+            else             a = Rules[r].elseActions;
+            for ( ; a; a = a->next )
+            {
+                if ( a->pid < 0 ) continue;
+                k = a->pid;
+                PidBank.action[k] = a;
+                PidBank.link[k] = a->link;
+                PidBank.form[k] = a->attribute;
+                PidBank.kp[k] = a->kp;
+                PidBank.ki[k] = a->ki;
+                PidBank.kd[k] = a->kd;
+
+                // --- setting limits (non-pump settings can't exceed 1);
+                //     anti-windup applies only to user-supplied limits
+                PidBank.sMin[k] = a->sMin;
+                if ( a->sMax == MISSING ) PidBank.sMax[k] = BIG;
+                else                      PidBank.sMax[k] = a->sMax;
+                if ( Link[a->link].type != PUMP )
+                    PidBank.sMax[k] = MIN(PidBank.sMax[k], 1.0);
+                if ( a->sMin > 0.0 || a->sMax != MISSING )
+                    PidBank.antiWindup[k] = 1.0;
+                if ( a->rateMax > 0.0 ) PidBank.rateMax[k] = a->rateMax;
+                else                    PidBank.rateMax[k] = BIG;
+                PidBank.dt[k] = 1.0;
+            }
+        }
+    }
+    return TRUE;
 }
 
 //=============================================================================
-//=============================================================================
-//=============================================================================
-//=============================================================================
-//
-// 2014-09-10:EMNET ... special PID function, with KP applied to only the Proportional Term
-//
-double getPID2_Setting(struct TAction* a, double dt)
+
+void deletePidBank(void)
 //
-//  Input:   a = an action object
-//           dt = current time step (days)
-//  Output:  returns a new link setting 
-//  Purpose: computes a new setting for a link subject to a PID controller.
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used by the PID controller bank.
 //
-//  Note:    a->kp = gain coefficient,
-//           a->ki = integral time (minutes)
-//           a->k2 = derivative time (minutes)
-//           a->e1 = error from previous time step
-//           a->e2 = error from two time steps ago
 {
-	double e0, setting;
-	double p, i, d, update;
-	double tolerance = 0.0001;
-
-	// --- convert time step from days to minutes
-	dt *= 1440.0;
-
-	// --- determine relative error in achieving controller set point
-	e0 = SetPoint - ControlValue;
-	if (fabs(e0) > TINY)
-	{
-		if (SetPoint != 0.0) e0 = e0 / SetPoint;
-		else                   e0 = e0 / ControlValue;
-	}
-
-	// --- reset previous errors to 0 if controller gets stuck
-	if (fabs(e0 - a->e1) < tolerance)
-	{
-		a->e2 = 0.0;
-		a->e1 = 0.0;
-	}
-
-	// --- use the recursive form of the PID controller equation to
-	//     determine the new setting for the controlled link
-	p = (e0 - a->e1);
-	if (a->ki == 0.0) i = 0.0;
-	else i = e0 * dt / a->ki;
-	d = a->kd * (e0 - 2.0*a->e1 + a->e2) / dt;
-	//2014-09-10:EMNET -- this was the standard EPA SWMM PID equation, the original getPID_Setting() function:
-	/////////////////////update = a->kp * (p + i + d);
-	update = (a->kp * p) + i + d;			//2014-09-10:EMNET -- PID2 equation, with KP multiplied only times the Proportional Term
-	if (fabs(update) < tolerance) update = 0.0;
-	setting = Link[a->link].targetSetting + update;
-
-	// --- update previous errors
-	a->e2 = a->e1;
-	a->e1 = e0;
-
-	// --- check that new setting lies within feasible limits
-	if (setting < 0.0) setting = 0.0;
-	if (Link[a->link].type != PUMP && setting > 1.0) setting = 1.0;
-	return setting;
+    FREE(PidBank.block);
+    FREE(PidBank.active);
+    FREE(PidBank.link);
+    FREE(PidBank.form);
+    FREE(PidBank.action);
+    PidBank.count = 0;
 }
 
+//=============================================================================
 
-
-
-//
-// 2014-09-23:EMNET ... special PID function, with KP applied to only the Proportional Term
-//
-double getPID3_Setting(struct TAction* a, double dt)
+void updatePidBank(void)
 //
-//  Input:   a = an action object
-//           dt = current time step (days)
-//  Output:  returns a new link setting 
-//  Purpose: computes a new setting for a link subject to a PID controller.
+//  Input:   none
+//  Output:  none
+//  Purpose: computes new settings for all PID controllers whose actions
+//           were selected at the current time step.
 //
-//  Note:    a->kp = gain coefficient,
-//           a->ki = integral time (minutes)
-//           a->k2 = derivative time (minutes)
-//           a->e1 = error from previous time step
-//           a->e2 = error from two time steps ago
-//           a->e3 = error from 3 time steps ago			//2014-09-23:EMNET
+//  Note:    Uses the recursive form of the PID controller equation:
+//             PID:  update = kp * (p + i + d)
+//             PID2: update = (kp * p) + i + d
+//             PID3: same as PID2 with d found from errors e0 through e3
+//           where kp = gain coefficient, ki = integral time (minutes),
+//           kd = derivative time (minutes), e0 = current relative error in
+//           achieving the controller set point and e1, e2, e3 = errors from
+//           1, 2 & 3 time steps ago. Each controller's inputs were saved
+//           when its action was selected; controllers not selected keep
+//           their previous errors.
 {
-	double e0, setting;
-	double p, i, d, update;
-	double tolerance = 0.0001;
+    int    k, n = PidBank.count;
+    double tolerance = 0.0001;
+    double sp, cv, e0, e1, e2, e3, dt;
+    double p, i, d, update, s0, setting;
+    double holdI;
 
-	// --- convert time step from days to minutes
-	dt *= 1440.0;
-
-	// --- determine relative error in achieving controller set point
-	e0 = SetPoint - ControlValue;
-	if (fabs(e0) > TINY)
-	{
-		if (SetPoint != 0.0) e0 = e0 / SetPoint;
-		else                   e0 = e0 / ControlValue;
-	}
-
-	// --- reset previous errors to 0 if controller gets stuck
-	if (fabs(e0 - a->e1) < tolerance)
-	{
-		a->e3 = 0.0;		//2014-09-10:EMNET
-		a->e2 = 0.0;
-		a->e1 = 0.0;
-	}
+    for (k = 0; k < n; k++)
+    {
+        sp = PidBank.setPoint[k];
+        cv = PidBank.controlValue[k];
+        dt = PidBank.dt[k];
+        s0 = Link[PidBank.link[k]].targetSetting;
+
+        // --- determine relative error in achieving controller set point
+        e0 = sp - cv;
+        e0 = ( fabs(e0) > TINY ) ? e0 / ((sp != 0.0) ? sp : cv) : e0;
+
+        // --- reset previous errors to 0 if controller gets stuck
+        e1 = PidBank.e1[k];
+        e2 = PidBank.e2[k];
+        e3 = PidBank.e3[k];
+        if ( fabs(e0 - e1) < tolerance )
+        {
+            e1 = 0.0;
+            e2 = 0.0;
+            e3 = 0.0;
+        }
 
-	// --- use the recursive form of the PID controller equation to
-	//     determine the new setting for the controlled link
-	p = (e0 - a->e1);
-	if (a->ki == 0.0) i = 0.0;
-	else i = e0 * dt / a->ki;
-	
-	//2014-09-23:EMNET -- this was the standard EPA SWMM derivative term:
-	/////////////////////d = a->kd * (e0 - 2.0*a->e1 + a->e2) / dt;
-
-	d = a->kd * (e0 - ((3.0*a->e1) - (2.0*a->e2) - (1.0*a->e3))) / dt;		//2014-09-24:EmNet: triple-sample derivative filter
-
-	//2014-09-10:EMNET -- this was the standard EPA SWMM PID equation, the original getPID_Setting() function:
-	/////////////////////update = a->kp * (p + i + d);
-	update = (a->kp * p) + i + d;			//2014-09-10:EMNET -- PID2 equation, with KP multiplied only times the Proportional Term
-	if (fabs(update) < tolerance) update = 0.0;
-	setting = Link[a->link].targetSetting + update;
-
-	// --- update previous errors
-	a->e3 = a->e2;				//2014-09-10:EMNET
-	a->e2 = a->e1;
-	a->e1 = e0;
-
-	// --- check that new setting lies within feasible limits
-	if (setting < 0.0) setting = 0.0;
-	if (Link[a->link].type != PUMP && setting > 1.0) setting = 1.0;
-
-	return setting;
+        // --- proportional, integral & derivative terms (PID3 uses a
+        //     triple-sample derivative filter)
+        p = e0 - e1;
+        if ( PidBank.ki[k] == 0.0 ) i = 0.0;
+        else i = e0 * dt / PidBank.ki[k];
+        if ( PidBank.form[k] == r_PID3 )
+            d = PidBank.kd[k] * (e0 - ((3.0*e1) - (2.0*e2) - (1.0*e3))) / dt;
+        else
+            d = PidBank.kd[k] * (e0 - 2.0*e1 + e2) / dt;
+
+        // --- anti-windup: hold integral term when setting is at a
+        //     limit and the term would push it further past that limit
+        holdI = PidBank.antiWindup[k] *
+                ((s0 >= PidBank.sMax[k] && i > 0.0) ||
+                 (s0 <= PidBank.sMin[k] && i < 0.0));
+        i *= 1.0 - holdI;
+
+        // --- standard PID applies kp to all terms while PID2 & PID3
+        //     apply it only to the proportional term
+        if ( PidBank.form[k] == r_PID ) update = PidBank.kp[k] * (p + i + d);
+        else update = (PidBank.kp[k] * p) + i + d;
+        update = ( fabs(update) < tolerance ) ? 0.0 : update;
+
+        // --- apply rate of change and setting limits
+        update = MIN(update, PidBank.rateMax[k] * dt);
+        update = MAX(update, -PidBank.rateMax[k] * dt);
+        setting = s0 + update;
+        setting = MAX(setting, PidBank.sMin[k]);
+        setting = MIN(setting, PidBank.sMax[k]);
+
+        // --- update previous errors of active controllers
+        if ( PidBank.active[k] )
+        {
+            PidBank.e3[k] = e2;
+            PidBank.e2[k] = e1;
+            PidBank.e1[k] = e0;
+            PidBank.action[k]->value = setting;
+            PidBank.active[k] = FALSE;
+        }
+    }
 }
-//=============================================================================
-//=============================================================================
-//=============================================================================
+
 //=============================================================================
 
 void updateActionList(struct TAction* a)
@@ -1029,6 +1186,133 @@ void updateActionList(struct TAction* a)
 
 //=============================================================================
 
+int isRuleDue(int r, DateTime elapsedTime)
+//
+//  Input:   r = control rule index
+//           elapsedTime = decimal days since start of simulation
+//  Output:  returns TRUE if rule should be evaluated at current time
+//  Purpose: checks if a rule with an evaluation interval is due to be
+//           re-evaluated.
+//
+//  Note:    a rule with stack premises or stack operands is always due
+//           (its EVERY clause is ignored) since skipping it would leave
+//           the shared stack in a different state for the rules that
+//           follow it.
+//
+{
+    if ( Rules[r].usesStack ) return TRUE;
+    if ( Rules[r].interval <= 0.0 || Rules[r].result < 0 ) return TRUE;
+    return ( elapsedTime >= Rules[r].nextTime );
+}
+
+//=============================================================================
+
+double getPremiseInput(struct TPremise* p, DateTime theDate)
+//
+//  Input:   p = a control rule premise condition
+//           theDate = the current simulation date
+//  Output:  returns current value of the quantity tested by a premise
+//  Purpose: finds the value of the node, link or date attribute that
+//           a premise depends on.
+//
+{
+    int i = p->node;
+    int j = p->link;
+
+    switch ( p->attribute )
+    {
+      case r_DATE:    return theDate;
+      case r_DAY:     return datetime_dayOfWeek(theDate);
+      case r_MONTH:   return datetime_monthOfYear(theDate);
+
+      case r_STATUS:
+      case r_SETTING:
+        if ( j >= 0 ) return Link[j].setting;
+        break;
+
+      case r_FLOW:
+        if ( j >= 0 ) return Link[j].direction*Link[j].newFlow;
+        break;
+
+      case r_DEPTH:
+        if ( j >= 0 ) return Link[j].newDepth;
+        if ( i >= 0 ) return Node[i].newDepth;
+        break;
+
+      case r_HEAD:
+        if ( i >= 0 ) return Node[i].newDepth;
+        break;
+
+      case r_INFLOW:
+        if ( i >= 0 ) return Node[i].newLatFlow;
+        break;
+    }
+    return MISSING;
+}
+
+//=============================================================================
+
+int inputsHaveChanged(int r, DateTime theDate)
+//
+//  Input:   r = control rule index
+//           theDate = the current simulation date
+//  Output:  returns TRUE if any premise input changed since last evaluation
+//  Purpose: checks if a rule's premises need to be re-evaluated.
+//
+{
+    struct TPremise* p;
+
+    if ( Rules[r].result < 0 ) return TRUE;
+    p = Rules[r].firstPremise;
+    while (p)
+    {
+        if ( getPremiseInput(p, theDate) != p->lastInput ) return TRUE;
+        p = p->next;
+    }
+    return FALSE;
+}
+
+//=============================================================================
+
+void saveRuleInputs(int r, DateTime theDate)
+//
+//  Input:   r = control rule index
+//           theDate = the current simulation date
+//  Output:  none
+//  Purpose: saves the current values of the inputs to a rule's premises.
+//
+{
+    struct TPremise* p = Rules[r].firstPremise;
+    while (p)
+    {
+        p->lastInput = getPremiseInput(p, theDate);
+        p = p->next;
+    }
+}
+
+//=============================================================================
+
+void carryOverActions(int r)
+//
+//  Input:   r = control rule index
+//  Output:  none
+//  Purpose: adds the actions selected at a rule's last evaluation
+//           to the list of actions to be taken, using their last values.
+//
+{
+    struct TAction* a;
+
+    if ( Rules[r].result == TRUE ) a = Rules[r].thenActions;
+    else                           a = Rules[r].elseActions;
+    while (a)
+    {
+        updateActionList(a);
+        a = a->next;
+    }
+}
+
+//=============================================================================
+
 int executeActionList(DateTime currentTime)
 //
 //  Input:   currentTime = current date/time of the simulation
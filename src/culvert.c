@@ -11,10 +11,17 @@
 //   Computes flow reduction in a culvert-type conduit due to
 //   inlet control using equations from the FHWA HEC-5 circular.
 //
+//   The parameters of each culvert that don't change during a run are
+//   computed once, shared by culverts with the same inlet type, cross
+//   section and slope. When CULVERT_TABLES is on, unsubmerged flows for
+//   Form 1 inlets (whose equation must be solved iteratively) are
+//   interpolated from a table of flow versus inlet depth.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <math.h>
+#include <stdlib.h>
 #include "findroot.h"
 #include "headers.h"
 
@@ -23,6 +30,11 @@
 //-----------------------------------------------------------------------------
 enum CulvertParam {FORM, K, M, C, Y};
 static const int    MAX_CULVERT_CODE = 57;
+static const double TBL_XACC   = 1.0e-7;   // tolerance in tabulated critical depth
+                                           // (fraction of yFull)
+static const double TBL_TOL    = 0.0001;   // interpolation error (fraction of q1)
+static const int    TBL_MIN    = 17;       // min. entries in a Form 1 flow table
+static const int    TBL_MAX    = 1025;     // max. entries in a Form 1 flow table
 static const double Params[58][5] = {
 
 //   FORM   K       M     C        Y  
@@ -146,10 +158,38 @@ typedef struct
     TXsect* xsect;                  // Pointer to culvert cross section
 } TCulvert;
 
+//-----------------------------------------------------------------------------
+//  Inlet data shared by culverts with the same code, cross section & slope
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int     code;                   // culvert type code number
+    int     link;                   // first culvert using the inlet
+    double  yFull;                  // full depth of culvert (ft)
+    double  scf;                    // slope correction factor
+    double  ad;                     // aFull * sqrt(yFull)
+    double  y1;                     // unsubmerged depth limit (ft)
+    double  y2;                     // submerged depth limit (ft)
+    double  q1;                     // unsubmerged flow at y1 (cfs)
+    double  q2;                     // submerged flow at y2 (cfs)
+    int     nTbl;                   // number of entries in qTbl
+    double* qTbl;                   // Form 1 flows at depths spaced evenly
+                                    // between 0 and y1 (cfs)
+} TCulvertInlet;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TCulvertInlet* Inlets;       // distinct culvert inlets
+static int            InletCount;   // number of distinct inlets
+static int*           LinkInlet;    // inlet used by each link (-1 if none)
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
-//  double culvert_getInflow
+//  culvert_createInlets  (called by project_validate)
+//  culvert_deleteInlets  (called by deleteObjects)
+//  culvert_getInflow     (called by dwflow_execute)
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -159,12 +199,94 @@ static double getSubmergedFlow(int code, double h, TCulvert* culvert);
 static double getTransitionFlow(int code, double h, double h1, double h2,
 	          TCulvert* culvert);
 static double getForm1Flow(double h, TCulvert* culvert);
+static double solveForm1Flow(double h, double xacc, TCulvert* culvert);
 static double form1Eqn(double yc, void* p);
+static void   setCulvertParams(int j, int code, TCulvert* culvert);
+static int    findInlet(int j, int code, double scf);
+static void   createForm1Table(TCulvertInlet* inlet, TCulvert* culvert);
+static double getTableFlow(TCulvertInlet* inlet, double h);
 
 static void report_CulvertControl(int j, double q0, double q, int condition,
 	        double yRatio);                                                  //for debugging only
 
 
+//=============================================================================
+
+void culvert_createInlets()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: computes the fixed inlet parameters of each culvert, sharing
+//           them between culverts with the same inlet type, cross section
+//           and slope.
+//
+//  Note:    if memory runs out the culverts' parameters are simply computed
+//           each time inlet control is checked.
+{
+    int            i, j, code;
+    TCulvert       culvert;
+    TCulvertInlet* inlet;
+
+    culvert_deleteInlets();
+    if ( RouteModel != DW || Nobjects[LINK] == 0 ) return;
+    LinkInlet = (int *) malloc(Nobjects[LINK] * sizeof(int));
+    Inlets = (TCulvertInlet *) calloc(Nobjects[LINK], sizeof(TCulvertInlet));
+    if ( LinkInlet == NULL || Inlets == NULL )
+    {
+        culvert_deleteInlets();
+        return;
+    }
+
+    for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        LinkInlet[j] = -1;
+        if ( Link[j].type != CONDUIT ) continue;
+        code = Link[j].xsect.culvertCode;
+        if ( code <= 0 || code > MAX_CULVERT_CODE ) continue;
+        culvert.xsect = &Link[j].xsect;
+        setCulvertParams(j, code, &culvert);
+
+        // --- add a new inlet if no identical one exists
+        i = findInlet(j, code, culvert.scf);
+        if ( i < 0 )
+        {
+            i = InletCount;
+            InletCount++;
+            inlet = &Inlets[i];
+            inlet->code = code;
+            inlet->link = j;
+            inlet->yFull = culvert.yFull;
+            inlet->scf = culvert.scf;
+            inlet->ad = culvert.ad;
+            inlet->y1 = 0.95 * culvert.yFull;
+            inlet->y2 = culvert.yFull * (16.0 * Params[code][C] +
+                        Params[code][Y] - culvert.scf);
+            inlet->q1 = getUnsubmergedFlow(code, inlet->y1, &culvert);
+            inlet->q2 = getSubmergedFlow(code, inlet->y2, &culvert);
+            if ( CulvertTables && Params[code][FORM] == 1.0 )
+                createForm1Table(inlet, &culvert);
+        }
+        LinkInlet[j] = i;
+    }
+}
+
+//=============================================================================
+
+void culvert_deleteInlets()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the shared culvert inlet data.
+//
+{
+    int i;
+
+    if ( Inlets ) for (i = 0; i < InletCount; i++) FREE(Inlets[i].qTbl);
+    FREE(Inlets);
+    FREE(LinkInlet);
+    InletCount = 0;
+}
+
 //=============================================================================
 
 double culvert_getInflow(int j, double q0, double h)
@@ -178,13 +300,13 @@ double culvert_getInflow(int j, double q0, double h)
 //
 {
     int      code,                      //culvert type code number
-             k,                         //conduit index
              condition;                 //flow condition
     double   y,                         //current depth (ft)
              y1,                        //unsubmerged depth limit (ft)
              y2,                        //submerged depth limit (ft)
              q;                         //inlet-controlled flow (cfs)
 	TCulvert culvert;                   //intermediate results
+    TCulvertInlet* inlet = NULL;        //shared inlet data
 
     // --- check that we have a culvert conduit    
     if ( Link[j].type != CONDUIT ) return q0;
@@ -192,26 +314,32 @@ double culvert_getInflow(int j, double q0, double h)
     code = culvert.xsect->culvertCode;
     if ( code <= 0 || code > MAX_CULVERT_CODE ) return q0;
 
-    // --- compute often-used variables 
-    k = Link[j].subIndex;
-    culvert.yFull = culvert.xsect->yFull;
-    culvert.ad = culvert.xsect->aFull * sqrt(culvert.yFull);
-
-    // --- slope correction factor (-7 for mitered inlets, 0.5 for others)
-    switch (code)
+    // --- retrieve (or compute) often-used variables
+    if ( LinkInlet && LinkInlet[j] >= 0 )
     {
-    case 5:
-    case 37:
-    case 46: culvert.scf = -7.0 * Conduit[k].slope; break;    
-    default: culvert.scf = 0.5 * Conduit[k].slope;
+        inlet = &Inlets[LinkInlet[j]];
+        culvert.yFull = inlet->yFull;
+        culvert.ad = inlet->ad;
+        culvert.scf = inlet->scf;
+        y1 = inlet->y1;
+        y2 = inlet->y2;
+    }
+    else
+    {
+        setCulvertParams(j, code, &culvert);
+
+        // --- submerged flow limit is based on FHWA criteria of Q/AD > 4
+        //     and unsubmerged limit on an arbitrary 0.95 full
+        y1 = 0.95 * culvert.yFull;
+        y2 = culvert.yFull * (16.0 * Params[code][C] + Params[code][Y] -
+             culvert.scf);
     }
 
     // --- find head relative to culvert's upstream invert
     //     (can be greater than yFull when inlet is submerged) 
     y = h - (Node[Link[j].node1].invertElev + Link[j].offset1);
 
-    // --- check for submerged flow (based on FHWA criteria of Q/AD > 4)
-    y2 = culvert.yFull * (16.0 * Params[code][C] + Params[code][Y] - culvert.scf);
+    // --- check for submerged flow
     if ( y >= y2 )
     {    
         q = getSubmergedFlow(code, y, &culvert);
@@ -219,17 +347,26 @@ double culvert_getInflow(int j, double q0, double h)
     }
     else
     {
-        // --- check for unsubmerged flow (based on arbitrary limit of 0.95 full)
-        y1 = 0.95 * culvert.yFull;
+        // --- check for unsubmerged flow
         if ( y <= y1 )
         {
-            q = getUnsubmergedFlow(code, y, &culvert);
+            if ( inlet && inlet->qTbl )
+            {
+                q = getTableFlow(inlet, y);
+                culvert.dQdH = (y > 0.0) ? q / y / Params[code][M] : 0.0;
+            }
+            else q = getUnsubmergedFlow(code, y, &culvert);
             condition = 1;
         }
         // --- flow is in transition zone
         else
         {
-            q = getTransitionFlow(code, y, y1, y2, &culvert);
+            if ( inlet )
+            {
+                q = inlet->q1 + (inlet->q2 - inlet->q1) * (y - y1) / (y2 - y1);
+                culvert.dQdH = (inlet->q2 - inlet->q1) / (y2 - y1);
+            }
+            else q = getTransitionFlow(code, y, y1, y2, &culvert);
             condition = 0;
         }
     }
@@ -250,6 +387,131 @@ double culvert_getInflow(int j, double q0, double h)
 
 //=============================================================================
 
+void setCulvertParams(int j, int code, TCulvert* culvert)
+//
+//  Input:   j       = link index
+//           code    = culvert type code number
+//           culvert = pointer to a culvert data structure
+//  Output:  none
+//  Purpose: computes the parameters of a culvert that depend only on its
+//           cross section and slope.
+//
+{
+    int k = Link[j].subIndex;
+
+    culvert->yFull = culvert->xsect->yFull;
+    culvert->ad = culvert->xsect->aFull * sqrt(culvert->yFull);
+
+    // --- slope correction factor (-7 for mitered inlets, 0.5 for others)
+    switch (code)
+    {
+    case 5:
+    case 37:
+    case 46: culvert->scf = -7.0 * Conduit[k].slope; break;    
+    default: culvert->scf = 0.5 * Conduit[k].slope;
+    }
+}
+
+//=============================================================================
+
+int findInlet(int j, int code, double scf)
+//
+//  Input:   j    = link index
+//           code = culvert type code number
+//           scf  = culvert's slope correction factor
+//  Output:  returns index of an existing inlet identical to link j's
+//           or -1 if there is none
+//  Purpose: looks for a culvert inlet that link j can share.
+//
+{
+    int i;
+
+    for (i = 0; i < InletCount; i++)
+    {
+        if ( Inlets[i].code == code &&
+             Inlets[i].scf == scf &&
+             xsect_isSame(&Link[Inlets[i].link].xsect, &Link[j].xsect) )
+            return i;
+    }
+    return -1;
+}
+
+//=============================================================================
+
+void createForm1Table(TCulvertInlet* inlet, TCulvert* culvert)
+//
+//  Input:   inlet   = shared culvert inlet data
+//           culvert = pointer to a culvert data structure
+//  Output:  none
+//  Purpose: tabulates unsubmerged flow through a Form 1 inlet at depths
+//           spaced evenly between 0 and the unsubmerged depth limit.
+//
+//  Note:    the number of entries is doubled until linear interpolation at
+//           the midpoint of every interval is within TBL_TOL * q1 of the
+//           flow solved for there. If that can't be met with TBL_MAX
+//           entries there is no table and flows are solved for each time.
+{
+    int     i, m;
+    double  dy, q, tol, xacc;
+    double* t;
+
+    culvert->kk = Params[inlet->code][K];
+    culvert->mm = Params[inlet->code][M];
+    xacc = TBL_XACC * inlet->yFull;
+    tol = TBL_TOL * inlet->q1;
+    for (m = TBL_MIN; m <= TBL_MAX; m = 2*m - 1)
+    {
+        t = (double *) realloc(inlet->qTbl, m * sizeof(double));
+        if ( t == NULL ) break;
+        inlet->qTbl = t;
+
+        // --- compute flows at the table's depths
+        dy = inlet->y1 / (double)(m - 1);
+        t[0] = 0.0;
+        for (i = 1; i < m; i++) t[i] = solveForm1Flow(i * dy, xacc, culvert);
+
+        // --- check interpolation error at each interval's midpoint
+        for (i = 1; i < m; i++)
+        {
+            q = solveForm1Flow((i - 0.5) * dy, xacc, culvert);
+            if ( fabs(q - 0.5 * (t[i-1] + t[i])) > tol ) break;
+        }
+        if ( i == m )
+        {
+            inlet->nTbl = m;
+
+            // --- transition zone starts from the table's last flow
+            inlet->q1 = t[m-1];
+            return;
+        }
+    }
+    FREE(inlet->qTbl);
+    inlet->nTbl = 0;
+}
+
+//=============================================================================
+
+double getTableFlow(TCulvertInlet* inlet, double h)
+//
+//  Input:   inlet = shared culvert inlet data
+//           h     = inlet water depth above culvert invert (ft)
+//  Output:  returns unsubmerged inlet-controlled flow rate (cfs)
+//  Purpose: interpolates a Form 1 inlet's flow from its flow table.
+//
+{
+    int     i;
+    double  x;
+    double* t = inlet->qTbl;
+
+    if ( h <= 0.0 ) return 0.0;
+    x = h / inlet->y1 * (double)(inlet->nTbl - 1);
+    i = (int)x;
+    if ( i >= inlet->nTbl - 1 ) return t[inlet->nTbl - 1];
+    return t[i] + (x - (double)i) * (t[i+1] - t[i]);
+}
+
+//=============================================================================
+
 double getUnsubmergedFlow(int code, double h, TCulvert* culvert)
 //
 //  Input:   code  = culvert type code number
@@ -358,6 +620,41 @@ double getForm1Flow(double h, TCulvert* culvert)
 
 //=============================================================================
 
+double solveForm1Flow(double h, double xacc, TCulvert* culvert)
+//
+//  Input:   h       = inlet water depth above culvert invert (ft)
+//           xacc    = tolerance in critical depth (ft)
+//           culvert = pointer to a culvert data structure
+//  Output:  returns inlet controlled flow rate (cfs)
+//  Purpose: solves FHWA Equation Form 1 for an unsubmerged culvert to
+//           within a given tolerance.
+//
+//  Note:    the residual of Equation Form 1 decreases with critical depth
+//           from h/yFull + 0.5*s at yc = 0, so bisection always converges
+//           and the flow returned is the one at the converged depth (the
+//           Ridder search in getForm1Flow returns the flow from its last
+//           trial depth, which is only used when no table is made).
+{
+    int    i;
+    double ylo = 0.0, yhi = h, yc;
+
+    if ( h <= 0.0 ) return 0.0;
+    culvert->hPlus = h / culvert->yFull + culvert->scf;
+
+    // --- critical depth can't exceed the inlet depth
+    if ( form1Eqn(yhi, culvert) >= 0.0 ) return culvert->qc;
+    for (i = 0; i < 100 && yhi - ylo > xacc; i++)
+    {
+        yc = 0.5 * (ylo + yhi);
+        if ( form1Eqn(yc, culvert) > 0.0 ) ylo = yc;
+        else yhi = yc;
+    }
+    form1Eqn(0.5 * (ylo + yhi), culvert);
+    return culvert->qc;
+}
+
+//=============================================================================
+
 double form1Eqn(double yc, void* p)
 //
 //  Input:   yc = critical depth
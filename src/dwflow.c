@@ -34,7 +34,7 @@ static double findLocalLosses(int link, double a1, double a2, double aMid,
 
 static double getWidth(TXsect* xsect, double y);
 static double getArea(TXsect* xsect, double y);
-static double getHydRad(TXsect* xsect, double y);
+static void   getAreaAndHydRad(TXsect* xsect, double y, double* a, double* r);
 
 static double checkNormalFlow(int j, double q, double y1, double y2,
               double a1, double r1);
@@ -119,14 +119,12 @@ void  dwflow_findConduitFlow(int j, int steps, double omega, double dt)
     findSurfArea(j, qLast, length, &h1, &h2, &y1, &y2);
 
     // --- compute area at each end of conduit & hyd. radius at upstream end
-    a1 = getArea(xsect, y1);
+    getAreaAndHydRad(xsect, y1, &a1, &r1);
     a2 = getArea(xsect, y2);
-    r1 = getHydRad(xsect, y1);
 
     // --- compute area & hyd. radius at midpoint
     yMid = 0.5 * (y1 + y2);
-    aMid = getArea(xsect, yMid);
-    rMid = getHydRad(xsect, yMid);
+    getAreaAndHydRad(xsect, yMid, &aMid, &rMid);
 
     // --- alternate approach not currently used, but might produce better
     //     Bernoulli energy balance for steady flows
@@ -571,18 +569,18 @@ double getArea(TXsect* xsect, double y)
 
 //=============================================================================
 
-double getHydRad(TXsect* xsect, double y)
+void getAreaAndHydRad(TXsect* xsect, double y, double* a, double* r)
 //
 //  Input:   xsect = ptr. to conduit cross section
 //           y     = flow depth (ft)
-//  Output:  returns hydraulic radius (ft)
-//  Purpose: computes hydraulic radius of flow cross-section in a conduit.
+//  Output:  a = flow area (ft2)
+//           r = hydraulic radius (ft)
+//  Purpose: computes area and hydraulic radius of flow cross-section in a
+//           conduit with a single pass through its geometry tables.
 //
 {
-    double hRadius;                     // hyd. radius (ft)
     y = MIN(y, xsect->yFull);
-    hRadius = xsect_getRofY(xsect, y);
-    return hRadius;
+    xsect_getAandRofY(xsect, y, a, r);
 }
 
 //=============================================================================
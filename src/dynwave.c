@@ -52,6 +52,11 @@ static TXnode* Xnode;                  // extended nodal information
 static double  Omega;                  // actual under-relaxation parameter
 static int     Steps;                  // number of Picard iterations
 
+static int*    ConduitOrder;           // true conduits grouped by shape
+static int     NumConduits;            // number of true conduits
+static int*    NonConduitOrder;        // all other links in index order
+static int     NumNonConduits;         // number of other links
+
 //-----------------------------------------------------------------------------
 //  Function declarations
 //-----------------------------------------------------------------------------
@@ -59,6 +64,8 @@ static void   initRoutingStep(void);
 static void   initNodeStates(void);
 static void   findBypassedLinks();
 static void   findLimitedLinks();
+static void   chargeFailedStep(void);
+static void   groupConduitsByShape(void);
 
 static void   findLinkFlows(double dt);
 static int    isTrueConduit(int link);
@@ -101,6 +108,8 @@ void dynwave_init()
         Link[i].flowClass = DRY;
         Link[i].dqdh = 0.0;
     }
+    groupConduitsByShape();
+    forcemain_init();
 }
 
 //=============================================================================
@@ -113,6 +122,26 @@ void  dynwave_close()
 //
 {
     FREE(Xnode);
+    FREE(ConduitOrder);
+    FREE(NonConduitOrder);
+    forcemain_close();
+}
+
+//=============================================================================
+
+void dynwave_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of the dynamic wave solver in a
+//           simulation state snapshot.
+//
+{
+    if ( Xnode == NULL ) return;
+    snapshot_copy(&VariableStep, sizeof(VariableStep));
+    snapshot_copy(&Omega, sizeof(Omega));
+    snapshot_copy(&Steps, sizeof(Steps));
+    snapshot_copy(Xnode, Nobjects[NODE] * sizeof(TXnode));
 }
 
 //=============================================================================
@@ -158,6 +187,7 @@ int dynwave_execute(double tStep)
 
     // --- initialize
     if ( ErrorCode ) return 0;
+    profile_start(PROF_DYNWAVE);
     Steps = 0;
     converged = FALSE;
     Omega = OMEGA;
@@ -179,10 +209,16 @@ int dynwave_execute(double tStep)
             findBypassedLinks();
         }
     }
-    if ( !converged ) NonConvergeCount++;
+    if ( !converged )
+    {
+        NonConvergeCount++;
+        if ( Profiling ) chargeFailedStep();
+    }
 
     //  --- identify any capacity-limited conduits
     findLimitedLinks();
+    profile_stop(PROF_DYNWAVE);
+    profile_addTrials(Steps, converged);
     return Steps;
 }
 
@@ -260,7 +296,37 @@ void   findBypassedLinks()
         if ( Xnode[Link[i].node1].converged &&
              Xnode[Link[i].node2].converged )
              Link[i].bypassed = TRUE;
-        else Link[i].bypassed = FALSE;
+        else
+        {
+            Link[i].bypassed = FALSE;
+            if ( Profiling ) profile_addTrialCost(LINK, i);
+        }
+    }
+}
+
+//=============================================================================
+
+void chargeFailedStep()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: charges a non-converged time step to each node that did not
+//           converge and to each link attached to such a node.
+//
+{
+    int i;
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        if ( Node[i].type == OUTFALL ) continue;
+        if ( !Xnode[i].converged ) profile_addFailureCost(NODE, i);
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( (Node[Link[i].node1].type != OUTFALL &&
+              !Xnode[Link[i].node1].converged) ||
+             (Node[Link[i].node2].type != OUTFALL &&
+              !Xnode[Link[i].node2].converged) )
+            profile_addFailureCost(LINK, i);
     }
 }
 
@@ -301,13 +367,15 @@ void  findLimitedLinks()
 
 void findLinkFlows(double dt)
 {
-    int i;
+    int i, j;
 
     // --- find new flow in each non-dummy conduit
-    for ( i = 0; i < Nobjects[LINK]; i++)
+    //     (visited in shape order; each conduit's flow depends only on
+    //     its own state and that of its end nodes)
+    for ( i = 0; i < NumConduits; i++)
     {
-        if ( isTrueConduit(i) && !Link[i].bypassed )
-            dwflow_findConduitFlow(i, Steps, Omega, dt);
+        j = ConduitOrder[i];
+        if ( !Link[j].bypassed ) dwflow_findConduitFlow(j, Steps, Omega, dt);
     }
 
     // --- update inflow/outflows for nodes attached to non-dummy conduits
@@ -317,12 +385,58 @@ void findLinkFlows(double dt)
     }
 
     // --- find new flows for all dummy conduits, pumps & regulators
-    for ( i = 0; i < Nobjects[LINK]; i++)
+    //     (visited in link order since the inflow to a dummy conduit or
+    //     pump depends on the node flows accumulated before it)
+    for ( i = 0; i < NumNonConduits; i++)
     {
-	    if ( !isTrueConduit(i) )
-	    {	
-            if ( !Link[i].bypassed ) findNonConduitFlow(i, dt);
-            updateNodeFlows(i);
+        j = NonConduitOrder[i];
+        if ( !Link[j].bypassed ) findNonConduitFlow(j, dt);
+        updateNodeFlows(j);
+    }
+}
+
+//=============================================================================
+
+void groupConduitsByShape()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: lists the non-dummy conduits sorted by cross section shape so
+//           that successive flow updates use the same geometry functions
+//           and tables, and all other links in index order.
+//
+{
+    int i, k;
+
+    NumConduits = 0;
+    NumNonConduits = 0;
+    ConduitOrder = NULL;
+    NonConduitOrder = NULL;
+    if ( Nobjects[LINK] == 0 ) return;
+    ConduitOrder = (int *) calloc(Nobjects[LINK], sizeof(int));
+    NonConduitOrder = (int *) calloc(Nobjects[LINK], sizeof(int));
+    if ( ConduitOrder == NULL || NonConduitOrder == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    for (k = CIRCULAR; k <= FORCE_MAIN; k++)
+    {
+        for (i = 0; i < Nobjects[LINK]; i++)
+        {
+            if ( isTrueConduit(i) && Link[i].xsect.type == k )
+            {
+                ConduitOrder[NumConduits] = i;
+                NumConduits++;
+            }
+        }
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        if ( !isTrueConduit(i) )
+        {
+            NonConduitOrder[NumNonConduits] = i;
+            NumNonConduits++;
         }
     }
 }
@@ -524,6 +638,7 @@ int findNodeDepths(double dt)
         {
             converged = FALSE;
             Xnode[i].converged = FALSE;
+            if ( Profiling && Steps > 0 ) profile_addTrialCost(NODE, i);
         }
     }
     return converged;
@@ -707,6 +822,13 @@ double getVariableStep(double maxStep)
 
     // --- don't let time step go below an absolute minimum
     if ( tMin < MINTIMESTEP ) tMin = MINTIMESTEP;
+
+    // --- charge the step to the element that set it
+    if ( Profiling )
+    {
+        if ( minLink >= 0 ) profile_addStepCost(LINK, minLink, tMin);
+        else if ( minNode >= 0 ) profile_addStepCost(NODE, minNode, tMin);
+    }
     return tMin;
 }
 
@@ -79,7 +79,8 @@
 //-------------------------------------
  enum GageDataType {
       RAIN_TSERIES,                    // rainfall from user-supplied time series
-      RAIN_FILE};                      // rainfall from external file
+      RAIN_FILE,                       // rainfall from external file
+      RAIN_GRID};                      // rainfall grids from external file
 
 //-------------------------------------
 // Cross section shape types
@@ -296,6 +297,11 @@ enum  SubAreaType {
       H_W,                             // Hazen-Williams eqn.
       D_W};                            // Darcy-Weisbach eqn.
 
+ enum FrictionModeType {
+      FRIC_EXACT,                      // compute friction at every call
+      FRIC_CACHED,                     // reuse friction at nearby Reynolds no.
+      FRIC_TABLE};                     // also interpolate from a table
+
  enum OffsetType {
       DEPTH_OFFSET,                    // offset measured as depth
       ELEV_OFFSET};                    // offset measured as elevation
@@ -403,7 +409,8 @@ enum  CompatibilityType {
       s_COORDINATE,   s_VERTICES,     s_POLYGON,      s_LABEL,
       s_SYMBOL,       s_BACKDROP,     s_TAG,          s_PROFILE,
       s_MAP,          s_LID_CONTROL,  s_LID_USAGE,    s_GWF,                   //(5.1.007)
-      s_ADJUST};                                                               //(5.1.007)
+      s_ADJUST,                                                                //(5.1.007)
+      s_GRIDWEIGHT};
 
  enum InputOptionType {
       FLOW_UNITS,        INFIL_MODEL,       ROUTE_MODEL, 
@@ -418,7 +425,10 @@ enum  CompatibilityType {
       FORCE_MAIN_EQN,    LINK_OFFSETS,      MIN_SLOPE,
       IGNORE_SNOWMELT,   IGNORE_GWATER,     IGNORE_ROUTING,
       IGNORE_QUALITY,    MAX_TRIALS,        HEAD_TOL,
-      SYS_FLOW_TOL,      LAT_FLOW_TOL,      IGNORE_RDII};                      //(5.1.004)
+      SYS_FLOW_TOL,      LAT_FLOW_TOL,      IGNORE_RDII,                       //(5.1.004)
+      PROFILE_FILE,      RUN_PROFILE,       COST_FILE,
+      COST_STEP_LIMIT,   DEPTH_TABLES,      FORCE_MAIN_FRICTION,
+      CULVERT_TABLES,    THREADS,           CHECKPOINT};
 
 enum  NoYesType {
       NO,
@@ -428,3 +438,16 @@ enum  NoneAllType {
       NONE,
       ALL,
       SOME};
+
+//-------------------------------------
+// Routines timed by the run profiler
+//-------------------------------------
+ #define MAX_PROF_TIMERS 7
+ enum ProfileTimerType {
+      PROF_RUNOFF,                     // runoff_execute
+      PROF_ROUTING,                    // routing_execute
+      PROF_DYNWAVE,                    // dynwave_execute
+      PROF_CONTROLS,                   // controls_evaluate
+      PROF_QUALITY,                    // qualrout_execute
+      PROF_MASSBAL,                    // massbal_updateRoutingTotals
+      PROF_OUTPUT};                    // output_saveResults
@@ -121,6 +121,7 @@
 #define ERR319 "\n  ERROR 319: unknown format for rainfall data file %s."
 #define ERR320 "\n  ERROR 320: invalid format for rainfall interface file."
 #define ERR321 "\n  ERROR 321: no data in rainfall interface file for gage %s."
+#define ERR322 "\n  ERROR 322: invalid rainfall grid cells for subcatchment %s."
 
 #define ERR323 "\n  ERROR 323: cannot open runoff interface file %s."
 #define ERR325 \
@@ -154,6 +155,11 @@
 #define ERR361 "\n  ERROR 361: could not open external file used for Time Series %s."
 #define ERR363 "\n  ERROR 363: invalid data in external file used for Time Series %s."
 
+#define ERR365 "\n  ERROR 365: cannot open run time profile file %s."
+#define ERR367 "\n  ERROR 367: cannot open element cost file %s."
+
+#define ERR369 "\n  ERROR 369: cannot write checkpoint file %s."
+
 #define ERR401 "\n  ERROR 401: general system error."
 #define ERR402 \
 "\n  ERROR 402: cannot open new project while current project still open."
@@ -161,6 +167,7 @@
 #define ERR405 \
 "\n  ERROR 405: amount of output produced will exceed maximum file size;" \
 "\n             either reduce Ending Date or increase Reporting Time Step."
+#define ERR407 "\n  ERROR 407: invalid or empty simulation state snapshot %s."
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -177,10 +184,11 @@ char* ErrorMsgs[] =
       ERR188, ERR191, ERR193, ERR195, ERR200, ERR201, ERR203, ERR205, ERR207,
       ERR209, ERR211, ERR213, ERR217, ERR219, ERR221, ERR223, ERR225, ERR227,
       ERR229, ERR231, ERR233, ERR301, ERR303, ERR305, ERR307, ERR309, ERR311,
-      ERR313, ERR315, ERR317, ERR318, ERR319, ERR320, ERR321, ERR323, ERR325,
-      ERR327, ERR329, ERR330, ERR331, ERR333, ERR335, ERR336, ERR337, ERR338,
-      ERR339, ERR341, ERR343, ERR345, ERR351, ERR353, ERR355, ERR357, ERR361,
-      ERR363, ERR401, ERR402, ERR403, ERR405};
+      ERR313, ERR315, ERR317, ERR318, ERR319, ERR320, ERR321, ERR322, ERR323,
+      ERR325, ERR327, ERR329, ERR330, ERR331, ERR333, ERR335, ERR336, ERR337,
+      ERR338, ERR339, ERR341, ERR343, ERR345, ERR351, ERR353, ERR355, ERR357,
+      ERR361, ERR363, ERR365, ERR367, ERR369, ERR401, ERR402, ERR403, ERR405,
+      ERR407};
 
 int ErrorCodes[] =
     { 0,      101,    103,    105,    107,    108,    109,    110,    111,
@@ -191,10 +199,11 @@ int ErrorCodes[] =
       188,    191,    193,    195,    200,    201,    203,    205,    207,
       209,    211,    213,    217,    219,    221,    223,    225,    227,
       229,    231,    233,    301,    303,    305,    307,    309,    311,
-      313,    315,    317,    318,    319,    320,    321,    323,    325,
-      327,    329,    330,    331,    333,    335,    336,    337,    338,
-      339,    341,    343,    345,    351,    353,    355,    357,    361,
-      363,    401,    402,    403,    405};
+      313,    315,    317,    318,    319,    320,    321,    322,    323,
+      325,    327,    329,    330,    331,    333,    335,    336,    337,
+      338,    339,    341,    343,    345,    351,    353,    355,    357,
+      361,    363,    365,    367,    369,    401,    402,    403,    405,
+      407};
 
 char  ErrString[256];
 
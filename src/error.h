@@ -122,45 +122,54 @@ enum  ErrorType {
       ERR_RAIN_FILE_FORMAT,     //319  76
       ERR_RAIN_IFACE_FORMAT,    //320  77
       ERR_RAIN_FILE_GAGE,       //321  78
+      ERR_RAIN_GRID,            //322  79
 
   //... Runoff File Errors
-      ERR_RUNOFF_FILE_OPEN ,    //323  79
-      ERR_RUNOFF_FILE_FORMAT,   //325  80
-      ERR_RUNOFF_FILE_END,      //327  81
-      ERR_RUNOFF_FILE_READ,     //329  82
+      ERR_RUNOFF_FILE_OPEN ,    //323  80
+      ERR_RUNOFF_FILE_FORMAT,   //325  81
+      ERR_RUNOFF_FILE_END,      //327  82
+      ERR_RUNOFF_FILE_READ,     //329  83
 
   //... Hotstart File Errors
-      ERR_HOTSTART_FILE_NAMES,  //330  83
-      ERR_HOTSTART_FILE_OPEN,   //331  84
-      ERR_HOTSTART_FILE_FORMAT, //333  85
-      ERR_HOTSTART_FILE_READ,   //335  86
+      ERR_HOTSTART_FILE_NAMES,  //330  84
+      ERR_HOTSTART_FILE_OPEN,   //331  85
+      ERR_HOTSTART_FILE_FORMAT, //333  86
+      ERR_HOTSTART_FILE_READ,   //335  87
 
   //... Climate File Errors
-      ERR_NO_CLIMATE_FILE,      //336  87
-      ERR_CLIMATE_FILE_OPEN,    //337  88
-      ERR_CLIMATE_FILE_READ,    //338  89
-      ERR_CLIMATE_END_OF_FILE,  //339  90
+      ERR_NO_CLIMATE_FILE,      //336  88
+      ERR_CLIMATE_FILE_OPEN,    //337  89
+      ERR_CLIMATE_FILE_READ,    //338  90
+      ERR_CLIMATE_END_OF_FILE,  //339  91
 
   //... RDII File Errors
-      ERR_RDII_FILE_SCRATCH,    //341  91
-      ERR_RDII_FILE_OPEN,       //343  92
-      ERR_RDII_FILE_FORMAT,     //345  93
+      ERR_RDII_FILE_SCRATCH,    //341  92
+      ERR_RDII_FILE_OPEN,       //343  93
+      ERR_RDII_FILE_FORMAT,     //345  94
       
   //... Routing File Errors
-      ERR_ROUTING_FILE_OPEN,    //351  94
-      ERR_ROUTING_FILE_FORMAT,  //353  95
-      ERR_ROUTING_FILE_NOMATCH, //355  96
-      ERR_ROUTING_FILE_NAMES,   //357  97
+      ERR_ROUTING_FILE_OPEN,    //351  95
+      ERR_ROUTING_FILE_FORMAT,  //353  96
+      ERR_ROUTING_FILE_NOMATCH, //355  97
+      ERR_ROUTING_FILE_NAMES,   //357  98
 
   //... Time Series File Errors
-      ERR_TABLE_FILE_OPEN,      //361  98
-      ERR_TABLE_FILE_READ,      //363  99
+      ERR_TABLE_FILE_OPEN,      //361  99
+      ERR_TABLE_FILE_READ,      //363 100
+
+  //... Profile File Errors
+      ERR_PROFILE_FILE_OPEN,    //365 101
+      ERR_COST_FILE_OPEN,       //367 102
+
+  //... Checkpoint File Errors
+      ERR_CHECKPOINT_FILE,      //369 103
 
   //... Runtime Errors
-      ERR_SYSTEM,               //401  100
-      ERR_NOT_CLOSED,           //402  101
-      ERR_NOT_OPEN,             //403  102
-      ERR_FILE_SIZE,            //405  103
+      ERR_SYSTEM,               //401  104
+      ERR_NOT_CLOSED,           //402  105
+      ERR_NOT_OPEN,             //403  106
+      ERR_FILE_SIZE,            //405  107
+      ERR_SNAPSHOT,             //407  108
 
       MAXERRMSG};
       
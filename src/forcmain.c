@@ -10,6 +10,7 @@
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>
 #include <math.h>
 #include "headers.h"
 
@@ -18,19 +19,126 @@
 //-----------------------------------------------------------------------------
 static const double VISCOS = 1.1E-5;   // Kinematic viscosity of water
                                        // @ 20 deg C (sq ft/sec)
+static const double RE_TOL = 0.001;    // relative change in Reynolds number
+                                       // over which a cached friction
+                                       // factor is reused
+static const double TBL_VMAX = 50.0;   // velocity at end of friction factor
+                                       // tables (ft/sec)
+static const double TBL_TOL = 0.0001;  // max. relative interpolation error
+                                       // of friction factor tables
+static const int    TBL_MIN = 65;      // min. & max. number of entries
+static const int    TBL_MAX = 4097;    // in friction factor tables
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    double  hrad;          // hyd. radius of cached values (ft)
+    double  hradPow;       // hrad^1.1667 (Hazen-Williams)
+    double  re;            // Reynolds number of cached friction factor
+    double  f;             // cached Darcy-Weisbach friction factor
+    double  hradTbl;       // hyd. radius the table applies to (ft)
+    int     nTbl;          // number of friction factor table entries
+    double  xMin;          // sqrt(Reynolds number) at first table entry
+    double  dx;            // sqrt(Reynolds number) spacing of table entries
+    double* fTbl;          // friction factor v. sqrt(Reynolds number)
+}  TFricCache;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TFricCache* FricCache;          // friction cache for each conduit
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
+// forcemain_init        (called by dynwave_init)
+// forcemain_close       (called by dynwave_close)
 // forcemain_getEquivN
 // forcemain_getRoughFactor
 // forcemain_getFricSlope
+// forcemain_snapshot    (called by copyState in snapshot.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static double forcemain_getFricFactor(double e, double hrad, double re);
 static double forcemain_getReynolds(double v, double hrad);
+static double forcemain_getCachedFricFactor(TFricCache* c, double e,
+              double hrad, double re);
+static void   forcemain_createTable(int j, TFricCache* c);
+static double forcemain_getTableFricFactor(TFricCache* c, double re);
+
+//=============================================================================
+
+void forcemain_init()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: creates the friction factor cache used for Darcy-Weisbach
+//           force mains (and for the hyd. radius term of Hazen-Williams).
+//
+//  Note:    if memory is short friction is computed at every call instead.
+{
+    int j, k;
+
+    FricCache = NULL;
+    if ( ForceMainFriction == FRIC_EXACT || Nlinks[CONDUIT] == 0 ) return;
+    FricCache = (TFricCache *) calloc(Nlinks[CONDUIT], sizeof(TFricCache));
+    if ( FricCache == NULL ) return;
+    if ( ForceMainFriction != FRIC_TABLE || ForceMainEqn != D_W ) return;
+    for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        if ( Link[j].type != CONDUIT ) continue;
+        if ( Link[j].xsect.type != FORCE_MAIN ) continue;
+        k = Link[j].subIndex;
+        forcemain_createTable(j, &FricCache[k]);
+    }
+}
+
+//=============================================================================
+
+void forcemain_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the friction factor cache.
+//
+{
+    int k;
+
+    if ( FricCache == NULL ) return;
+    for (k = 0; k < Nlinks[CONDUIT]; k++) FREE(FricCache[k].fTbl);
+    FREE(FricCache);
+}
+
+//=============================================================================
+
+void forcemain_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the friction factors last computed for each
+//           conduit in a simulation state snapshot.
+//
+//  Note:    a cached friction factor is reused while the Reynolds number
+//           stays within RE_TOL of the one it was computed at, so it is
+//           part of the simulation's state. The tables never change.
+{
+    int k;
+    TFricCache* c;
+
+    if ( FricCache == NULL ) return;
+    for (k = 0; k < Nlinks[CONDUIT]; k++)
+    {
+        c = &FricCache[k];
+        snapshot_copy(&c->hrad, sizeof(c->hrad));
+        snapshot_copy(&c->hradPow, sizeof(c->hradPow));
+        snapshot_copy(&c->re, sizeof(c->re));
+        snapshot_copy(&c->f, sizeof(c->f));
+    }
+}
 
 //=============================================================================
 
@@ -99,21 +207,138 @@ double forcemain_getFricSlope(int j, double v, double hrad)
 //
 {
     double re, f;
-    TXsect xsect = Link[j].xsect;
+    TXsect*     xsect = &Link[j].xsect;
+    TFricCache* c = NULL;
+
+    if ( FricCache ) c = &FricCache[Link[j].subIndex];
     switch ( ForceMainEqn )
     {
       case H_W:
-        return xsect.sBot * pow(v, 0.852) / pow(hrad, 1.1667);
+        // --- hyd. radius term only changes when pipe is partly full
+        if ( c == NULL )
+            return xsect->sBot * pow(v, 0.852) / pow(hrad, 1.1667);
+        if ( hrad != c->hrad )
+        {
+            c->hrad = hrad;
+            c->hradPow = pow(hrad, 1.1667);
+        }
+        return xsect->sBot * pow(v, 0.852) / c->hradPow;
       case D_W:
         re = forcemain_getReynolds(v, hrad);
-        f = forcemain_getFricFactor(xsect.rBot, hrad, re);
-        return f * xsect.sBot * v / hrad;
+        if ( c ) f = forcemain_getCachedFricFactor(c, xsect->rBot, hrad, re);
+        else     f = forcemain_getFricFactor(xsect->rBot, hrad, re);
+        return f * xsect->sBot * v / hrad;
     }
     return 0.0;
 }
 
 //=============================================================================
 
+double forcemain_getCachedFricFactor(TFricCache* c, double e, double hrad,
+                                     double re)
+//
+//  Input:   c = force main's friction factor cache
+//           e = roughness height (ft)
+//           hrad = hydraulic radius (ft)
+//           re = Reynolds number
+//  Output:  returns a Darcy-Weisbach friction factor
+//  Purpose: reuses the last friction factor computed for a force main if
+//           the Reynolds number has changed by less than RE_TOL.
+//
+//  Note:    since |d ln(f) / d ln(Re)| <= 1 for laminar & turbulent flow
+//           (and < 2 in the transition zone) a reused friction factor is
+//           within 2*RE_TOL of its exact value.
+{
+    double f;
+
+    if ( hrad == c->hrad && fabs(re - c->re) <= RE_TOL * c->re ) return c->f;
+    f = -1.0;
+    if ( c->fTbl && fabs(hrad - c->hradTbl) <= 1.0e-6 * hrad )
+        f = forcemain_getTableFricFactor(c, re);
+    if ( f < 0.0 ) f = forcemain_getFricFactor(e, hrad, re);
+    c->hrad = hrad;
+    c->re = re;
+    c->f = f;
+    return f;
+}
+
+//=============================================================================
+
+void forcemain_createTable(int j, TFricCache* c)
+//
+//  Input:   j = link index
+//           c = force main's friction factor cache
+//  Output:  none
+//  Purpose: tabulates a full force main's turbulent friction factor at
+//           evenly spaced values of sqrt(Re) from Re = 4000 up to the Re
+//           at a velocity of TBL_VMAX.
+//
+//  Note:    the number of entries is doubled until linear interpolation
+//           at the midpoint of every interval is within TBL_TOL of the
+//           Swamee-Jain value. If that can't be met (or memory is short)
+//           no table is used.
+{
+    int     i, n;
+    int     fits = FALSE;
+    double  e = Link[j].xsect.rBot;
+    double  hrad = Link[j].xsect.rFull;
+    double  x, f, xMax;
+    double* t;
+
+    xMax = sqrt(forcemain_getReynolds(TBL_VMAX, hrad));
+    c->xMin = sqrt(4000.0);
+    if ( xMax <= c->xMin ) return;
+    for (n = TBL_MIN; n <= TBL_MAX && !fits; n = 2*n - 1)
+    {
+        t = (double *) realloc(c->fTbl, n * sizeof(double));
+        if ( t == NULL ) break;
+        c->fTbl = t;
+        c->nTbl = n;
+        c->dx = (xMax - c->xMin) / (n - 1);
+        for (i = 0; i < n; i++)
+        {
+            x = c->xMin + i * c->dx;
+            t[i] = forcemain_getFricFactor(e, hrad, x * x);
+        }
+        fits = TRUE;
+        for (i = 1; i < n && fits; i++)
+        {
+            x = c->xMin + (i - 0.5) * c->dx;
+            f = forcemain_getFricFactor(e, hrad, x * x);
+            if ( fabs(0.5 * (t[i-1] + t[i]) - f) > TBL_TOL * f ) fits = FALSE;
+        }
+    }
+    if ( !fits )
+    {
+        FREE(c->fTbl);
+        c->nTbl = 0;
+    }
+    else c->hradTbl = hrad;
+}
+
+//=============================================================================
+
+double forcemain_getTableFricFactor(TFricCache* c, double re)
+//
+//  Input:   c = force main's friction factor cache
+//           re = Reynolds number
+//  Output:  returns a Darcy-Weisbach friction factor (or -1 if re is
+//           outside the range of the force main's table)
+//  Purpose: interpolates a friction factor from a force main's table.
+//
+{
+    int    i;
+    double x;
+
+    if ( re < 4000.0 ) return -1.0;
+    x = (sqrt(re) - c->xMin) / c->dx;
+    i = (int)x;
+    if ( i >= c->nTbl - 1 ) return -1.0;
+    return c->fTbl[i] + (x - i) * (c->fTbl[i+1] - c->fTbl[i]);
+}
+
+//=============================================================================
+
 double forcemain_getReynolds(double v, double hrad)
 //
 //  Input:   v = flow velocity (ft/sec)
@@ -18,6 +18,7 @@ void     project_open(char *f1, char *f2, char *f3);
 void     project_close(void);
 void     project_readInput(void);
 int      project_readOption(char* s1, char* s2);
+int      project_readCheckpoint(char* tok[], int ntoks);
 void     project_validate(void);
 int      project_init(void);
 int      project_addObject(int type, char* id, int n);
@@ -73,15 +74,19 @@ int      climate_readEvapParams(char* tok[], int ntoks);
 int      climate_readAdjustments(char* tok[], int ntoks);                      //(5.1.007)
 void     climate_validate(void);
 void     climate_openFile(void);
+void     climate_closeFile(void);
 void     climate_initState(void);
 void     climate_setState(DateTime aDate);
 DateTime climate_getNextEvap(DateTime aDate); 
+void     climate_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Rainfall Processing Methods
 //-----------------------------------------------------------------------------
 void    rain_open(void);
 void    rain_close(void);
+int     rain_readRecord(int gage, DateTime* date, float* depth);
+long long rain_findDate(int gage, DateTime t);
 
 //-----------------------------------------------------------------------------
 //   Snowmelt Processing Methods
@@ -95,9 +100,9 @@ void    snow_initSnowmelt(int snowIndex);
 void    snow_validateSnowmelt(int snowIndex);
 void    snow_setMeltCoeffs(int snowIndex, double season);
 void    snow_plowSnow(int subcatch, double tStep);
-double  snow_getSnowMelt(int subcatch, double rainfall, double snowfall,
-        double tStep, double netPrecip[]);
+void    snow_meltSnowpacks(double tStep);
 double  snow_getSnowCover(int subcatch);
+void    snow_freeSnowpacks(void);
 
 //-----------------------------------------------------------------------------
 //   Runoff Analyzer Methods
@@ -105,6 +110,7 @@ double  snow_getSnowCover(int subcatch);
 int     runoff_open(void);
 void    runoff_execute(void);
 void    runoff_close(void);
+void    runoff_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Conveyance System Routing Methods
@@ -122,11 +128,48 @@ void    output_end(void);
 void    output_close(void);
 void    output_checkFileSize(void);
 void    output_saveResults(double reportTime);
+double  output_getBytesSaved(void);
 void    output_readDateTime(int period, DateTime *aDate);
 void    output_readSubcatchResults(int period, int area);
 void    output_readNodeResults(int period, int node);
 void    output_readLinkResults(int period, int link);
 
+//-----------------------------------------------------------------------------
+//   Run Time Profiler Methods
+//-----------------------------------------------------------------------------
+void    profile_open(void);
+void    profile_start(int timer);
+void    profile_stop(int timer);
+void    profile_addTrials(int trials, int converged);
+void    profile_addTrialCost(int type, int index);
+void    profile_addFailureCost(int type, int index);
+void    profile_addStepCost(int type, int index, double tStep);
+void    profile_report(void);
+void    profile_close(void);
+
+//-----------------------------------------------------------------------------
+//   Simulation State Snapshot Methods
+//-----------------------------------------------------------------------------
+int     snapshot_save(int handle);
+int     snapshot_restore(int handle);
+int     snapshot_delete(int handle);
+int     snapshot_saveImage(char** data, size_t* size);
+int     snapshot_restoreImage(char* data, size_t size);
+void    snapshot_close(void);
+void    snapshot_copy(void* x, size_t size);
+void    snapshot_copyObjects(void* x, int n, size_t size, const size_t ptrs[],
+        int nPtrs);
+void    snapshot_copyFilePos(FILE* f);
+
+//-----------------------------------------------------------------------------
+//   Checkpoint Methods
+//-----------------------------------------------------------------------------
+void    checkpoint_open(void);
+int     checkpoint_isResuming(void);
+void    checkpoint_resume(void);
+void    checkpoint_step(void);
+void    checkpoint_close(void);
+
 //-----------------------------------------------------------------------------
 //   Groundwater Methods
 //-----------------------------------------------------------------------------
@@ -154,6 +197,8 @@ void    rdii_openRdii(void);
 void    rdii_closeRdii(void);
 int     rdii_getNumRdiiFlows(DateTime aDate);
 void    rdii_getRdiiFlow(int index, int* node, double* q);
+void    rdii_snapshot(void);
+void    rdii_reportStats(void);
 
 //-----------------------------------------------------------------------------
 //   Landuse Methods
@@ -187,9 +232,11 @@ void    dynwave_close(void);
 double  dynwave_getRoutingStep(double fixedStep);
 int     dynwave_execute(double tStep);
 void    dwflow_findConduitFlow(int j, int steps, double omega, double dt);
+void    dynwave_snapshot(void);
 
 void    qualrout_init(void);
 void    qualrout_execute(double tStep);
+void    qualrout_close(void);
 
 //-----------------------------------------------------------------------------
 //   Treatment Methods
@@ -222,6 +269,7 @@ void    massbal_addNodeLosses(double evapLoss, double infilLoss);
 void    massbal_addLinkLosses(double evapLoss, double infilLoss);
 void    massbal_addReactedMass(int pollut, double mass);
 double  massbal_getStepFlowError(void);
+void    massbal_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Simulation Statistics Methods
@@ -235,6 +283,7 @@ void    stats_updateFlowStats(double tStep, DateTime aDate, int stepCount,
 void    stats_updateSubcatchStats(int subcatch, double rainVol, double runonVol,
         double evapVol, double infilVol, double runoffVol, double runoff);
 void    stats_updateMaxRunoff(void);
+void    stats_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Raingage Methods
@@ -243,10 +292,26 @@ int      gage_readParams(int gage, char* tok[], int ntoks);
 void     gage_validate(int gage);
 void     gage_initState(int gage);
 void     gage_setState(int gage, DateTime aDate);
-double   gage_getPrecip(int gage, double *rainfall, double *snowfall);
+double   gage_getPrecip(int gage, int subcatch, double *rainfall,
+         double *snowfall);
 void     gage_setReportRainfall(int gage, DateTime aDate);
 DateTime gage_getNextRainDate(int gage, DateTime aDate);
 
+//-----------------------------------------------------------------------------
+//   Rainfall Grid Methods
+//-----------------------------------------------------------------------------
+int      raingrid_readWeights(char* tok[], int ntoks);
+void     raingrid_validate(void);
+void     raingrid_delete(void);
+void     raingrid_initState(int gage);
+int      raingrid_readFrame(int gage, DateTime* date, double scale,
+         double* mean);
+void     raingrid_swapFrames(int gage);
+double   raingrid_getRainfall(int gage, int subcatch);
+void     raingrid_setReportDate(int gage, DateTime aDate);
+double   raingrid_getReportRainfall(int gage, int subcatch);
+void     raingrid_snapshot(void);
+
 //-----------------------------------------------------------------------------
 //   Subcatchment Methods
 //-----------------------------------------------------------------------------
@@ -316,6 +381,7 @@ int     iface_getIfaceNode(int index);
 double  iface_getIfaceFlow(int index);
 double  iface_getIfaceQual(int index, int pollut);
 void    iface_saveOutletResults(DateTime reportDate, FILE* file);
+void    iface_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Hot Start File Methods
@@ -351,9 +417,12 @@ void    link_getResults(int link, double wt, float x[]);
 //   Link Cross-Section Methods
 //-----------------------------------------------------------------------------
 int     xsect_isOpen(int type);
+int     xsect_solvesForYnorm(int type);
+int     xsect_solvesForYcrit(int type);
 int     xsect_setParams(TXsect *xsect, int type, double p[], double ucf);
 void    xsect_setIrregXsectParams(TXsect *xsect);
 void    xsect_setCustomXsectParams(TXsect *xsect);
+int     xsect_isSame(TXsect* x1, TXsect* x2);
 double  xsect_getAmax(TXsect* xsect);
 double  xsect_getSofA(TXsect* xsect, double area);
 double  xsect_getYofA(TXsect* xsect, double area);
@@ -363,19 +432,25 @@ double  xsect_getdSdA(TXsect* xsect, double area);
 double  xsect_getAofY(TXsect* xsect, double y);
 double  xsect_getRofY(TXsect* xsect, double y);
 double  xsect_getWofY(TXsect* xsect, double y);
+void    xsect_getAandRofY(TXsect* xsect, double y, double* a, double* r);
 double  xsect_getYcrit(TXsect* xsect, double q);
 
 //-----------------------------------------------------------------------------
 //   Culvert Methods
 //-----------------------------------------------------------------------------
+void    culvert_createInlets(void);
+void    culvert_deleteInlets(void);
 double  culvert_getInflow(int link, double q, double h);
 
 //-----------------------------------------------------------------------------
 //   Force Main Methods
 //-----------------------------------------------------------------------------
+void    forcemain_init(void);
+void    forcemain_close(void);
 double  forcemain_getEquivN(int j, int k);
 double  forcemain_getRoughFactor(int j, double lengthFactor);
 double  forcemain_getFricSlope(int j, double v, double hrad);
+void    forcemain_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Cross-Section Transect Methods
@@ -389,6 +464,7 @@ void    transect_validate(int j);
 //   Custom Shape Cross-Section Methods
 //-----------------------------------------------------------------------------
 int     shape_validate(TShape *shape, TTable *curve);
+void    shape_delete(TShape *shape);
 
 //-----------------------------------------------------------------------------
 //   Control Rule Methods
@@ -398,6 +474,7 @@ void    controls_delete(void);
 int     controls_addRuleClause(int rule, int keyword, char* Tok[], int nTokens);
 int     controls_evaluate(DateTime currentTime, DateTime elapsedTime, 
         double tStep);
+void    controls_snapshot(void);
 
 //-----------------------------------------------------------------------------
 //   Table & Time Series Methods
@@ -409,6 +486,7 @@ void    table_deleteEntries(TTable* table);
 void    table_init(TTable* table);
 int     table_validate(TTable* table);
 double  table_interpolate(double x, double x1, double y1, double x2, double y2);
+double  table_getIntervalError(double* coarse, double* fine, int n);
 double  table_lookup(TTable* table, double x);
 double  table_intervalLookup(TTable* table, double x);
 double  table_inverseLookup(TTable* table, double y);
@@ -418,6 +496,9 @@ int     table_getNextEntry(TTable* table, double* x, double* y);
 double  table_getMaxY(TTable *table, double x);
 void    table_tseriesInit(TTable *table);
 double  table_tseriesLookup(TTable* table, double t, char extend);
+double  table_tseriesCursorLookup(TTable* table, int* cursor, double t,
+        char extend);
+void    table_tseriesLoad(TTable* table);
 double  table_getArea(TTable* table, double x);
 double  table_getInverseArea(TTable* table, double a);
 double  table_lookupEx(TTable* table, double x);
@@ -436,6 +517,10 @@ int      strcomp(char *s1, char *s2);         // case insensitive string compare
 char*    sstrncpy(char *dest, const char *src,
          size_t maxlen);                      // safe string copy
 void     writecon(char *s);                   // writes string to console
+unsigned long long hashBytes(unsigned long long h,
+         const void* x, size_t n);            // add bytes to a FNV-1a hash
+int      replaceFile(char *fname,             // rename file over another
+         char *newName);
 DateTime getDateTime(double elapsedMsec);     // convert elapsed time to date
 void     getElapsedTime(DateTime aDate,       // convert elapsed date
          int* days, int* hrs, int* mins);
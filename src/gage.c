@@ -35,6 +35,7 @@ const double OneSecond = 1.1574074e-5;
 //-----------------------------------------------------------------------------
 static int    readGageSeriesFormat(char* tok[], int ntoks, double x[]);
 static int    readGageFileFormat(char* tok[], int ntoks, double x[]);
+static int    readGageGridFormat(char* tok[], int ntoks, double x[]);
 static int    getFirstRainfall(int gage);
 static int    getNextRainfall(int gage);
 static double convertRainfall(int gage, double rain);
@@ -53,6 +54,7 @@ int gage_readParams(int j, char* tok[], int ntoks)
 //  Data formats are:
 //    Name RainType RecdFreq SCF TIMESERIES SeriesName
 //    Name RainType RecdFreq SCF FILE FileName Station Units StartDate
+//    Name RainType RecdFreq SCF GRID FileName
 //
 {
     int      k, err;
@@ -90,6 +92,11 @@ int gage_readParams(int j, char* tok[], int ntoks)
         sstrncpy(staID, tok[6], MAXMSG);
         err = readGageFileFormat(tok, ntoks, x);
     }
+    else if ( k == RAIN_GRID    )
+    {
+        err = readGageGridFormat(tok, ntoks, x);
+        if ( !err ) sstrncpy(fname, tok[5], MAXFNAME);
+    }
     else return error_setInpError(ERR_KEYWORD, tok[4]);
 
     // --- save parameters to rain gage object
@@ -100,8 +107,13 @@ int gage_readParams(int j, char* tok[], int ntoks)
     Gage[j].rainInterval = (int)x[2];
     Gage[j].snowFactor   = x[3];
     Gage[j].rainUnits    = (int)x[6];
-    if ( Gage[j].tSeries >= 0 ) Gage[j].dataSource = RAIN_TSERIES;
-    else                        Gage[j].dataSource = RAIN_FILE;
+    if      ( k == RAIN_GRID )      Gage[j].dataSource = RAIN_GRID;
+    else if ( Gage[j].tSeries >= 0 ) Gage[j].dataSource = RAIN_TSERIES;
+    else                             Gage[j].dataSource = RAIN_FILE;
+    if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        sstrncpy(Gage[j].fname, fname, MAXFNAME);
+    }
     if ( Gage[j].dataSource == RAIN_FILE )
     {
         sstrncpy(Gage[j].fname, fname, MAXFNAME);
@@ -193,6 +205,38 @@ int readGageFileFormat(char* tok[], int ntoks, double x[])
 
 //=============================================================================
 
+int readGageGridFormat(char* tok[], int ntoks, double x[])
+{
+    int m;
+    DateTime aTime;
+
+    // --- a grid gage's line ends with the name of its grid file
+    if ( ntoks < 6 ) return error_setInpError(ERR_ITEMS, "");
+
+    // --- determine type of rain data
+    //     (cumulative values aren't supported for grids)
+    m = findmatch(tok[1], RainTypeWords);
+    if ( m < 0 || m == CUMULATIVE_RAINFALL )
+        return error_setInpError(ERR_KEYWORD, tok[1]);
+    x[1] = (double)m;
+
+    // --- get data time interval & convert to seconds
+    if ( getDouble(tok[2], &x[2]) ) x[2] = floor(x[2]*3600 + 0.5);
+    else if ( datetime_strToTime(tok[2], &aTime) )
+    {
+        x[2] = floor(aTime*SECperDAY + 0.5);
+    }
+    else return error_setInpError(ERR_DATETIME, tok[2]);
+    if ( x[2] <= 0.0 ) return error_setInpError(ERR_DATETIME, tok[2]);
+
+    // --- get snow catch deficiency factor
+    if ( !getDouble(tok[3], &x[3]) )
+        return error_setInpError(ERR_NUMBER, tok[3]);
+    return 0;
+}
+
+//=============================================================================
+
 void  gage_validate(int j)
 //
 //  Input:   j = rain gage index
@@ -246,6 +290,16 @@ void  gage_validate(int j)
             }
         }
     }
+
+    // --- for gage with rainfall grids:
+    if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        if ( Gage[j].rainInterval < WetStep )
+        {
+            report_writeWarningMsg(WARN01, Gage[j].ID);
+            WetStep = Gage[j].rainInterval;
+        }
+    }
 }
 
 //=============================================================================
@@ -275,6 +329,9 @@ void  gage_initState(int j)
         if ( UnitSystem == SI ) Gage[j].unitsFactor = MMperINCH;
     }
 
+    // --- for gage with rainfall grids, position grid file at first grid
+    if ( Gage[j].dataSource == RAIN_GRID ) raingrid_initState(j);
+
     // --- get first & next rainfall values
     if ( getFirstRainfall(j) )
     {
@@ -288,6 +345,7 @@ void  gage_initState(int j)
             // --- make next rainfall date the start of the rain record
             Gage[j].nextDate = Gage[j].startDate;
             Gage[j].nextRainfall = Gage[j].rainfall;
+            if ( Gage[j].dataSource == RAIN_GRID ) raingrid_swapFrames(j);
 
             // --- make start of current rain interval the simulation start
             Gage[j].startDate = StartDateTime;
@@ -372,6 +430,7 @@ void gage_setState(int j, DateTime t)
         Gage[j].endDate = datetime_addSeconds(Gage[j].startDate,
                           Gage[j].rainInterval);
         Gage[j].rainfall = Gage[j].nextRainfall;
+        if ( Gage[j].dataSource == RAIN_GRID ) raingrid_swapFrames(j);
         if ( !getNextRainfall(j) ) Gage[j].nextDate = NO_DATE;
     }
 }
@@ -395,22 +454,28 @@ DateTime gage_getNextRainDate(int j, DateTime aDate)
 
 //=============================================================================
 
-double gage_getPrecip(int j, double *rainfall, double *snowfall)
+double gage_getPrecip(int j, int i, double *rainfall, double *snowfall)
 //
 //  Input:   j = rain gage index
+//           i = index of subcatchment receiving the precipitation
 //  Output:  rainfall = rainfall rate (ft/sec)
 //           snowfall = snow fall rate (ft/sec)
 //           returns total precipitation (ft/sec)
 //  Purpose: determines whether gage's recorded rainfall is rain or snow.
 //
 {
+    double r = Gage[j].rainfall;
+
+    // --- a gage with rainfall grids has its own value for each subcatchment
+    if ( Gage[j].dataSource == RAIN_GRID ) r = raingrid_getRainfall(j, i);
+
     *rainfall = 0.0;
     *snowfall = 0.0;
     if ( !IgnoreSnowmelt && Temp.ta <= Snow.snotmp )
     {
-       *snowfall = Gage[j].rainfall * Gage[j].snowFactor / UCF(RAINFALL);
+       *snowfall = r * Gage[j].snowFactor / UCF(RAINFALL);
     }
-    else *rainfall = Gage[j].rainfall / UCF(RAINFALL);
+    else *rainfall = r / UCF(RAINFALL);
     return (*rainfall) + (*snowfall);
 } 
 
@@ -448,6 +513,10 @@ void gage_setReportRainfall(int j, DateTime reportDate)
     //     interval and start of next interval so use next interval's rainfall
     else result = Gage[j].nextRainfall;
     Gage[j].reportRainfall = result;
+
+    // --- make same choice for subcatchments of a gage with rainfall grids
+    if ( Gage[j].dataSource == RAIN_GRID )
+        raingrid_setReportDate(j, reportDate);
 }
 
 //=============================================================================
@@ -462,6 +531,7 @@ int getFirstRainfall(int j)
     int    k;                          // time series index
     float  vFirst;                     // first rain volume (ft or m)
     double rFirst;                     // first rain intensity (in/hr or mm/hr)
+    long long pos;                     // file position of first rain record
 
     // --- assign default values to date & rainfall
     Gage[j].startDate = NO_DATE;
@@ -473,14 +543,15 @@ int getFirstRainfall(int j)
     // --- use rain interface file if applicable
     if ( Gage[j].dataSource == RAIN_FILE )
     {
-        if ( Frain.file && Gage[j].endFilePos > Gage[j].startFilePos )
+        // --- skip over records that end well before the simulation
+        //     starts (with a day's margin) using the file's date index
+        pos = rain_findDate(j, datetime_addSeconds(StartDateTime,
+                               -Gage[j].rainInterval) - 1.0);
+        if ( pos >= 0 ) Gage[j].currentFilePos = pos;
+
+        // --- retrieve 1st date & rainfall volume from file
+        if ( rain_readRecord(j, &Gage[j].startDate, &vFirst) )
         {
-            // --- retrieve 1st date & rainfall volume from file
-            fseek(Frain.file, Gage[j].startFilePos, SEEK_SET);
-            fread(&Gage[j].startDate, sizeof(DateTime), 1, Frain.file);
-            fread(&vFirst, sizeof(float), 1, Frain.file);
-            Gage[j].currentFilePos = ftell(Frain.file);
-
             // --- convert rainfall to intensity
             Gage[j].rainfall = convertRainfall(j, (double)vFirst);
             return 1;
@@ -488,6 +559,20 @@ int getFirstRainfall(int j)
         return 0;
     }
 
+    // --- use first grid from a rainfall grid file
+    //     (its subcatchment rainfall becomes the gage's current values)
+    else if ( Gage[j].dataSource == RAIN_GRID )
+    {
+        if ( raingrid_readFrame(j, &Gage[j].startDate,
+                                convertRainfall(j, 1.0), &rFirst) )
+        {
+            raingrid_swapFrames(j);
+            Gage[j].rainfall = rFirst;
+            return 1;
+        }
+        return 0;
+    }
+
     // --- otherwise access user-supplied rainfall time series
     else
     {
@@ -516,9 +601,9 @@ int getNextRainfall(int j)
 //  Purpose: positions rainfall record to date with next non-zero rainfall
 //           while updating the gage's next rain intensity value.
 //
-//  Note: zero rainfall values explicitly entered into a rain file or
-//        time series are skipped over so that a proper accounting of
-//        wet and dry periods can be maintained.
+//  Note: zero rainfall values explicitly entered into a rain file,
+//        time series or rainfall grid file are skipped over so that a
+//        proper accounting of wet and dry periods can be maintained.
 //
 {
     int    k;                          // time series index
@@ -530,17 +615,20 @@ int getNextRainfall(int j)
     {
         if ( Gage[j].dataSource == RAIN_FILE )
         {
-            if ( Frain.file && Gage[j].currentFilePos < Gage[j].endFilePos )
+            if ( rain_readRecord(j, &Gage[j].nextDate, &vNext) )
             {
-                fseek(Frain.file, Gage[j].currentFilePos, SEEK_SET);
-                fread(&Gage[j].nextDate, sizeof(DateTime), 1, Frain.file);
-                fread(&vNext, sizeof(float), 1, Frain.file);
-                Gage[j].currentFilePos = ftell(Frain.file);
                 rNext = convertRainfall(j, (double)vNext);
             }
             else return 0;
         }
 
+        else if ( Gage[j].dataSource == RAIN_GRID )
+        {
+            if ( !raingrid_readFrame(j, &Gage[j].nextDate,
+                                     convertRainfall(j, 1.0), &rNext) )
+                return 0;
+        }
+
         else
         {
             k = Gage[j].tSeries;
@@ -36,7 +36,10 @@ EXTERN long
 EXTERN char
                   Msg[MAXMSG+1],            // Text of output message
                   Title[MAXTITLE][MAXMSG+1],// Project title
-                  TempDir[MAXFNAME+1];      // Temporary file directory
+                  TempDir[MAXFNAME+1],      // Temporary file directory
+                  ProfileFile[MAXFNAME+1],  // Run time profile file
+                  CostFile[MAXFNAME+1],     // Element cost file
+                  CheckpointFile[MAXFNAME+1]; // Checkpoint file
 
 EXTERN TRptFlags
                   RptFlags;                 // Reporting options
@@ -50,6 +53,7 @@ EXTERN int
                   InfilModel,               // Infiltration method
                   RouteModel,               // Flow routing method
                   ForceMainEqn,             // Flow equation for force mains
+                  ForceMainFriction,        // Friction factor evaluation mode
                   LinkOffsets,              // Link offset convention
                   AllowPonding,             // Allow water to pond at nodes
                   InertDamping,             // Degree of inertial damping
@@ -70,7 +74,11 @@ EXTERN int
                   ReportStep,               // Reporting time step (sec)
                   SweepStart,               // Day of year when sweeping starts
                   SweepEnd,                 // Day of year when sweeping ends
-                  MaxTrials;                // Max. trials for DW routing
+                  MaxTrials,                // Max. trials for DW routing
+                  Profiling,                // Collect run time profile
+                  DepthTables,              // Tabulate conduit yNorm & yCrit
+                  CulvertTables,            // Tabulate culvert inlet flows
+                  NumThreads;               // Threads used for quality routing
 
 EXTERN double
                   RouteStep,                // Routing time step (sec)
@@ -85,7 +93,9 @@ EXTERN double
                   QualError,                // Quality routing error
                   HeadTol,                  // DW routing head tolerance (ft)
                   SysFlowTol,               // Tolerance for steady system flow
-                  LatFlowTol;               // Tolerance for steady nodal inflow       
+                  LatFlowTol,               // Tolerance for steady nodal inflow       
+                  CostStepLimit,            // Small time step limit for costs (sec)
+                  CheckpointDays;           // Days between checkpoints
 
 EXTERN DateTime
                   StartDate,                // Starting date
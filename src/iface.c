@@ -65,6 +65,7 @@ static DateTime NewIfaceDate;          // next date of interface values
 //  iface_getIfaceFlow       (called by addIfaceInflows in routing.c)
 //  iface_getIfaceQual       (called by addIfaceInflows in routing.c)
 //  iface_saveOutletResults  (called by output_saveResults)
+//  iface_snapshot           (called by copyState in snapshot.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -302,7 +303,7 @@ void iface_saveOutletResults(DateTime reportDate, FILE* file)
 //
 {
     int i, p, yr, mon, day, hr, min, sec;
-    char theDate[25];
+    char theDate[26];
     datetime_decodeDate(reportDate, &yr, &mon, &day);
     datetime_decodeTime(reportDate, &hr, &min, &sec);
     sprintf(theDate, " %04d %02d  %02d  %02d  %02d  %02d ",
@@ -325,6 +326,32 @@ void iface_saveOutletResults(DateTime reportDate, FILE* file)
 
 //=============================================================================
 
+void iface_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the interface inflows being interpolated and
+//           the positions reached in the interface files in a simulation
+//           state snapshot.
+//
+{
+    int i;
+
+    snapshot_copyFilePos(Foutflows.file);
+    if ( !Finflows.file || OldIfaceValues == NULL ) return;
+    for (i = 0; i < NumIfaceNodes; i++)
+    {
+        snapshot_copy(OldIfaceValues[i], (1+NumIfacePolluts) * sizeof(double));
+        snapshot_copy(NewIfaceValues[i], (1+NumIfacePolluts) * sizeof(double));
+    }
+    snapshot_copy(&IfaceFrac, sizeof(IfaceFrac));
+    snapshot_copy(&OldIfaceDate, sizeof(OldIfaceDate));
+    snapshot_copy(&NewIfaceDate, sizeof(NewIfaceDate));
+    snapshot_copyFilePos(Finflows.file);
+}
+
+//=============================================================================
+
 void openFileForOutput()
 //
 //  Input:   none
@@ -335,7 +362,10 @@ void openFileForOutput()
     int i, n;
 
     // --- open the routing file for writing text
-    Foutflows.file = fopen(Foutflows.name, "wt");
+    //     (keeping what was written before a checkpoint the run resumes from)
+    if ( checkpoint_isResuming() )
+        Foutflows.file = fopen(Foutflows.name, "r+t");
+    else Foutflows.file = fopen(Foutflows.name, "wt");
     if ( Foutflows.file == NULL )
     {
         report_writeErrorMsg(ERR_ROUTING_FILE_OPEN, Foutflows.name);
@@ -39,6 +39,7 @@ static double Fumax;   // saturated water volume in upper soil zone (ft)
 //  infil_getState   (called by writeRunoffFile in hotstart.c)
 //  infil_setState   (called by readRunoffFile in hotstart.c)
 //  infil_getInfil   (called by getSubareaRunoff in subcatch.c)
+//  infil_snapshot   (called by copyState in snapshot.c)
 
 //  Called locally and by storage node methods in node.c
 //  grnampt_setParams
@@ -120,6 +121,23 @@ void infil_delete()
 
 //=============================================================================
 
+void infil_snapshot()
+//
+//  Purpose: saves or restores the infiltration state of all subcatchments
+//           in a simulation state snapshot.
+//  Input:   none
+//  Output:  none
+//
+{
+    int n = Nobjects[SUBCATCH];
+
+    snapshot_copy(HortInfil, n * sizeof(THorton));
+    snapshot_copy(GAInfil, n * sizeof(TGrnAmpt));
+    snapshot_copy(CNInfil, n * sizeof(TCurveNum));
+}
+
+//=============================================================================
+
 int infil_readParams(int m, char* tok[], int ntoks)
 //
 //  Input:   m = infiltration method code
@@ -92,6 +92,7 @@ int     infil_readParams(int model, char* tok[], int ntoks);
 void    infil_initState(int area, int model);
 void    infil_getState(int j, int m, double x[]);
 void    infil_setState(int j, int m, double x[]);
+void    infil_snapshot(void);
 double  infil_getInfil(int area, int model, double tstep, double rainfall,
         double runon, double depth);
 
@@ -146,6 +146,7 @@ int inflow_readExtInflow(char* tok[], int ntoks)
     inflow->sFactor  = sf;
     inflow->baseline = baseline;
     inflow->basePat  = basePat;
+    inflow->tsCursor = 0;
     return 0;
 }
 
@@ -195,7 +196,8 @@ double inflow_getExtInflow(TExtInflow* inflow, DateTime aDate)
         hour  = datetime_hourOfDay(aDate);
         blv  *= inflow_getPatternFactor(p, month, day, hour);
     }
-    if ( k >= 0 ) tsv = table_tseriesLookup(&Tseries[k], aDate, FALSE) * sf;
+    if ( k >= 0 ) tsv = table_tseriesCursorLookup(&Tseries[k],
+                        &inflow->tsCursor, aDate, FALSE) * sf;
     return cf * (tsv + blv);
 }
 
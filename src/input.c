@@ -582,6 +582,9 @@ int  parseLine(int sect, char *line)
       case s_LID_USAGE:
         return lid_readGroupParams(Tok, Ntokens);
 
+      case s_GRIDWEIGHT:
+        return raingrid_readWeights(Tok, Ntokens);
+
       default: return 0;
     }
 }
@@ -635,6 +638,8 @@ int readOption(char* line)
 {
     Ntokens = getTokens(line);
     if ( Ntokens < 2 ) return 0;
+    if ( findmatch(Tok[0], OptionWords) == CHECKPOINT )
+        return project_readCheckpoint(Tok, Ntokens);
     return project_readOption(Tok[0], Tok[1]);
 }
 
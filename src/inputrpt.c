@@ -111,6 +111,14 @@ void inputrpt_writeInput()
                     RainTypeWords[Gage[i].rainType],
                     (Gage[i].rainInterval)/60);
             }
+            else if ( Gage[i].dataSource == RAIN_GRID )
+            {
+                fprintf(Frpt.file, "\n  %-20s %-30s ",
+                    Gage[i].ID, Gage[i].fname);
+                fprintf(Frpt.file, "%-10s %3d min.",
+                    RainTypeWords[Gage[i].rainType],
+                    (Gage[i].rainInterval)/60);
+            }
             else fprintf(Frpt.file, "\n  %-20s %-30s",
                 Gage[i].ID, Gage[i].fname);
         }
@@ -262,19 +270,19 @@ void inputrpt_writeInput()
             k = Shape[i].curve;
             fprintf(Frpt.file, "\n\n  Shape %s", Curve[k].ID);
             fprintf(Frpt.file, "\n  Area:  ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
+            for ( m = 1; m < Shape[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Shape[i].areaTbl[m]);
             }
             fprintf(Frpt.file, "\n  Hrad:  ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
+            for ( m = 1; m < Shape[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Shape[i].hradTbl[m]);
             }
             fprintf(Frpt.file, "\n  Width: ");
-            for ( m = 1; m < N_SHAPE_TBL; m++)
+            for ( m = 1; m < Shape[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Shape[i].widthTbl[m]);
@@ -294,19 +302,19 @@ void inputrpt_writeInput()
         {
             fprintf(Frpt.file, "\n\n  Transect %s", Transect[i].ID);
             fprintf(Frpt.file, "\n  Area:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].areaTbl[m]);
             }
             fprintf(Frpt.file, "\n  Hrad:  ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].hradTbl[m]);
             }
             fprintf(Frpt.file, "\n  Width: ");
-            for ( m = 1; m < N_TRANSECT_TBL; m++)
+            for ( m = 1; m < Transect[i].nTbl; m++)
             {
                  if ( m % 5 == 1 ) fprintf(Frpt.file,"\n          ");
                  fprintf(Frpt.file, "%10.4f ", Transect[i].widthTbl[m]);
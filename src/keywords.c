@@ -33,7 +33,7 @@ char* CurveTypeWords[]     = { w_STORAGE, w_DIVERSION, w_TIDAL, w_RATING,
                                w_CONTROLS, w_SHAPE,
                                w_PUMP1, w_PUMP2, w_PUMP3, w_PUMP4, NULL}; 
 char* RuleKeyWords[]       = { w_RULE, w_IF, w_AND, w_OR, w_THEN, w_ELSE, 
-                               w_PRIORITY, NULL};
+                               w_PRIORITY, w_EVERY, NULL};
 char* ReportWords[]        = { w_INPUT, w_CONTINUITY, w_FLOWSTATS,
                                w_CONTROLS, w_SUBCATCH, w_NODE, w_LINK,
                                w_NODESTATS, NULL};
@@ -46,7 +46,7 @@ char* EvapTypeWords[]      = { w_CONSTANT, w_MONTHLY, w_TIMESERIES,
                                w_TEMPERATURE, w_FILE, w_RECOVERY,
                                w_DRYONLY, NULL};
 char* SnowmeltWords[]      = { w_PLOWABLE, w_IMPERV, w_PERV, w_REMOVAL, NULL};
-char* GageDataWords[]      = { w_TIMESERIES, w_FILE, NULL};
+char* GageDataWords[]      = { w_TIMESERIES, w_FILE, w_GRID, NULL};
 char* RainTypeWords[]      = { w_INTENSITY, w_VOLUME, w_CUMULATIVE, NULL};
 char* RainUnitsWords[]     = { w_INCHES, w_MMETER, NULL};
 char* OffOnWords[]         = { w_OFF, w_ON, NULL};
@@ -77,9 +77,15 @@ char* OptionWords[]        = { w_FLOW_UNITS,        w_INFIL_MODEL,
                                w_IGNORE_ROUTING,    w_IGNORE_QUALITY,
                                w_MAX_TRIALS,        w_HEAD_TOL,
                                w_SYS_FLOW_TOL,      w_LAT_FLOW_TOL,
-                               w_IGNORE_RDII,       NULL};                     //(5.1.004)
+                               w_IGNORE_RDII,                                   //(5.1.004)
+                               w_PROFILE_FILE,      w_PROFILE,  // must be in this order
+                               w_COST_FILE,         w_COST_STEP_LIMIT,
+                               w_DEPTH_TABLES,      w_FORCE_MAIN_FRICTION,
+                               w_CULVERT_TABLES,    w_THREADS,
+                               w_CHECKPOINT,        NULL};
 char* FlowUnitWords[]      = { w_CFS, w_GPM, w_MGD, w_CMS, w_LPS, w_MLD, NULL};
 char* ForceMainEqnWords[]  = { w_H_W, w_D_W, NULL};
+char* FrictionModeWords[]  = { w_EXACT, w_CACHED, w_TABLE, NULL};
 char* LinkOffsetWords[]    = { w_DEPTH, w_ELEVATION, NULL};
 char* OldRouteModelWords[] = { w_NONE, w_NF, w_KW, w_EKW, w_DW, NULL};
 char* RouteModelWords[]    = { w_NONE, w_STEADY, w_KINWAVE, w_XKINWAVE,
@@ -127,7 +133,8 @@ char* SectWords[]          = { ws_TITLE,          ws_OPTION,
                                ws_TAG,            ws_PROFILE,
                                ws_MAP,            ws_LID_CONTROL,
                                ws_LID_USAGE,      ws_GWF,                      //(5.1.007)
-                               ws_ADJUST,         NULL};                       //(5.1.007)
+                               ws_ADJUST,                                      //(5.1.007)
+                               ws_GRIDWEIGHT,     NULL};
 
 char* LoadUnitsWords[]     = { w_LBS, w_KG, w_LOGN };
 char* NodeTypeWords[]      = { w_JUNCTION, w_OUTFALL,
@@ -39,6 +39,7 @@ extern char* RelationWords[];
 extern char* OptionWords[];
 extern char* FlowUnitWords[];
 extern char* ForceMainEqnWords[];
+extern char* FrictionModeWords[];
 extern char* LinkOffsetWords[];
 extern char* RouteModelWords[];
 extern char* OldRouteModelWords[];
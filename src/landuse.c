@@ -266,6 +266,7 @@ int  landuse_readBuildupParams(char* tok[], int ntoks)
     Landuse[j].buildupFunc[p].coeff[1]   = c[1];
     Landuse[j].buildupFunc[p].coeff[2]   = c[2];
     Landuse[j].buildupFunc[p].maxDays = tmax;
+    Landuse[j].buildupFunc[p].tsCursor = 0;
     return 0;
 }
 
@@ -737,7 +738,8 @@ double landuse_getExternalBuildup(int i, int p, double buildup, double tStep)
     // --- get buildup rate (mass/unit/day) over the interval
     if ( ts >= 0 )
     {        
-        rate = sf * table_tseriesLookup(&Tseries[ts],
+        rate = sf * table_tseriesCursorLookup(&Tseries[ts],
+               &Landuse[i].buildupFunc[p].tsCursor,
                getDateTime(NewRunoffTime), FALSE);
     }
 
@@ -39,6 +39,7 @@
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <math.h>
+#include <stddef.h>
 #include "headers.h"
 #include "lid.h"
 
@@ -117,6 +118,7 @@ static int        SaveResults;         // = 1 if detailed results to be saved
 //  lid_delete               called by deleteObjects in project.c
 //  lid_validate             called by project_validate
 //  lid_initState            called by project_init
+//  lid_snapshot             called by copyState in snapshot.c
 
 //  lid_readParams           called by parseLine in input.c
 //  lid_readGroupParams      called by treatmnt_readExpression
@@ -1056,6 +1058,46 @@ void lid_initState()
 
 //=============================================================================
 
+void lid_snapshot()
+//
+//  Purpose: saves or restores the state of all LID units in a simulation
+//           state snapshot.
+//  Input:   none
+//  Output:  none
+//
+{
+    int        j;
+    TLidGroup  lidGroup;
+    TLidList*  lidList;
+    TLidUnit*  lidUnit;
+    static const size_t GroupPtrs[] = {offsetof(struct LidGroup, lidList)};
+    static const size_t UnitPtrs[] = {offsetof(TLidUnit, rptFile)};
+
+    snapshot_copy(&NextReportTime, sizeof(NextReportTime));
+    for (j = 0; j < GroupCount; j++)
+    {
+        lidGroup = LidGroups[j];
+        if ( lidGroup == NULL ) continue;
+        snapshot_copyObjects(lidGroup, 1, sizeof(struct LidGroup),
+                             GroupPtrs, 1);
+        lidList = lidGroup->lidList;
+        while ( lidList )
+        {
+            lidUnit = lidList->lidUnit;
+            snapshot_copyObjects(lidUnit, 1, sizeof(TLidUnit), UnitPtrs, 1);
+            if ( lidUnit->rptFile )
+            {
+                snapshot_copy(&lidUnit->rptFile->lastReportTime,
+                              sizeof(double));
+                snapshot_copyFilePos(lidUnit->rptFile->file);
+            }
+            lidList = lidList->nextLidUnit;
+        }
+    }
+}
+
+//=============================================================================
+
 int isLidPervious(int k)
 //
 //  Purpose: determines if a LID process allows infiltration or not.
@@ -170,6 +170,7 @@ double   lid_getRunoff(int subcatch, double *outflow, double *evapVol,
          double *pervEvapVol, double *infilVol, double tStep);
 void     lid_writeSummary(void);
 void     lid_writeWaterBalance(void);
+void     lid_snapshot(void);
 //-----------------------------------------------------------------------------
 void     lidproc_initWaterBalance(TLidUnit *lidUnit, double initVol);
 double   lidproc_getOutflow(TLidUnit* theUnit, TLidProc* theProc, double inflow,
@@ -24,6 +24,13 @@
 static const double MIN_DELTA_Z = 0.001; // minimum elevation change for conduit
                                          // slopes (ft)
 
+// --- conduit normal & critical depth tables
+enum  DepthTableType {YNORM_TABLE, YCRIT_TABLE};
+static const int    DEPTH_TBL_MIN = 33;    // initial number of table entries
+static const int    DEPTH_TBL_MAX = 1025;  // max. number of table entries
+static const double DEPTH_TBL_TOL = 0.001; // max. interpolation error
+                                           // (fraction of full depth)
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -64,16 +71,26 @@ static double conduit_getSlope(int j);
 static double conduit_getInflow(int j);
 static void   conduit_updateStats(int j, double dt, DateTime aDate);
 static double conduit_getLossRate(int j, double tstep);
+static void   conduit_createDepthTables(int j, int k);
+static void   conduit_setDepthTable(int j, int k, int type, TDepthTable* tbl);
+static double conduit_solveDepth(int j, int k, int type, double q);
+static double conduit_lookupDepth(TDepthTable* tbl, double q, double qMax);
 
 static int    pump_readParams(int j, int k, char* tok[], int ntoks);
 static void   pump_validate(int j, int k);
 static void   pump_initState(int j, int k);
 static double pump_getInflow(int j);
+static void   pump_setCurve(int k, int m);
+static int    pump_findEntry(TPumpCurve* curve, double x, int strict);
+static double pump_lookup(int k, double x);
+static double pump_intervalLookup(int k, double x);
+static double pump_getSlope(int k, double x);
 
 static int    orifice_readParams(int j, int k, char* tok[], int ntoks);
 static void   orifice_validate(int j, int k);
 static void   orifice_setSetting(int j, double tstep);
 static double orifice_getWeirCoeff(int j, int k, double h);
+static double orifice_getOpenArea(int j, int k);
 static double orifice_getInflow(int j);
 static double orifice_getFlow(int j, int k, double head, double f,
               int hasFlapGate);
@@ -83,6 +100,7 @@ static void   weir_validate(int j, int k);
 static void   weir_setSetting(int j);                                          //(5.1.007)
 static double weir_getInflow(int j);
 static double weir_getOpenArea(int j, double y);
+static double weir_getCrestWidth(int j, int k);
 static void   weir_getFlow(int j, int k, double head, double dir,
               int hasFlapGate, double* q1, double* q2);
 static double weir_getOrificeFlow(int j, double head, double y, double cOrif); //(5.1.007)
@@ -694,6 +712,17 @@ double link_getYcrit(int j, double q)
 //  Purpose: computes critical depth for given flow rate.
 //
 {
+    int k;
+
+    // --- use conduit's critical depth table if flow is within its range
+    if ( Link[j].type == CONDUIT )
+    {
+        k = Link[j].subIndex;
+        q = fabs(q);
+        if ( Conduit[k].yCritTbl.y && q <= Conduit[k].yCritTbl.qLimit )
+            return conduit_lookupDepth(&Conduit[k].yCritTbl, q,
+                                       Conduit[k].qMax);
+    }
     return xsect_getYcrit(&Link[j].xsect, q);
 }
 
@@ -708,7 +737,6 @@ double  link_getYnorm(int j, double q)
 //
 {
     int    k;
-    double s, a, y;
 
     if ( Link[j].type != CONDUIT ) return 0.0;
     if ( Link[j].xsect.type == DUMMY ) return 0.0;
@@ -716,10 +744,9 @@ double  link_getYnorm(int j, double q)
     k = Link[j].subIndex;
     if ( q > Conduit[k].qMax ) q = Conduit[k].qMax;
     if ( q <= 0.0 ) return 0.0;
-    s = q / Conduit[k].beta;
-    a = xsect_getAofS(&Link[j].xsect, s);
-    y = xsect_getYofA(&Link[j].xsect, a);
-    return y;
+    if ( Conduit[k].yNormTbl.y && q <= Conduit[k].yNormTbl.qLimit )
+        return conduit_lookupDepth(&Conduit[k].yNormTbl, q, Conduit[k].qMax);
+    return conduit_solveDepth(j, k, YNORM_TABLE, q);
 }
 
 //=============================================================================
@@ -1041,6 +1068,146 @@ void  conduit_validate(int j, int k)
          Link[j].cLossAvg    == 0.0
        ) Conduit[k].hasLosses = FALSE;
     else Conduit[k].hasLosses = TRUE;
+
+    // --- tabulate normal & critical depths used by dynamic wave routing
+    if ( RouteModel == DW && DepthTables ) conduit_createDepthTables(j, k);
+}
+
+//=============================================================================
+
+void conduit_createDepthTables(int j, int k)
+//
+//  Input:   j = link index
+//           k = conduit index
+//  Output:  none
+//  Purpose: builds tables of normal and critical depth versus flow for
+//           conduit shapes whose depths must otherwise be found with a
+//           root finder each time they are needed.
+//
+{
+    int type = Link[j].xsect.type;
+
+    FREE(Conduit[k].yNormTbl.y);
+    FREE(Conduit[k].yCritTbl.y);
+    Conduit[k].yNormTbl.n = 0;
+    Conduit[k].yCritTbl.n = 0;
+    if ( type == DUMMY || Conduit[k].qMax <= 0.0 ) return;
+    if ( xsect_solvesForYnorm(type) )
+        conduit_setDepthTable(j, k, YNORM_TABLE, &Conduit[k].yNormTbl);
+    if ( xsect_solvesForYcrit(type) )
+        conduit_setDepthTable(j, k, YCRIT_TABLE, &Conduit[k].yCritTbl);
+}
+
+//=============================================================================
+
+void conduit_setDepthTable(int j, int k, int type, TDepthTable* tbl)
+//
+//  Input:   j = link index
+//           k = conduit index
+//           type = YNORM_TABLE or YCRIT_TABLE
+//           tbl = depth table to fill
+//  Output:  none
+//  Purpose: tabulates normal or critical depth at flows spaced evenly in
+//           (q/qMax)^(1/3) between 0 and the conduit's max. flow.
+//
+//  Note: the number of entries is doubled until linear interpolation at
+//        the midpoint of every interval is within DEPTH_TBL_TOL * yFull
+//        of the directly computed depth. If the depth jumps (e.g. where
+//        critical depth reaches a closed conduit's crown) the largest
+//        table only covers flows below the jump and depths at higher
+//        flows are computed directly. Entries are forced to be
+//        non-decreasing so the table is monotone in flow.
+{
+    int     i, m;
+    int     bad = 0;
+    double  x, y, tol;
+    double  qMax = Conduit[k].qMax;
+    double* t;
+
+    tol = DEPTH_TBL_TOL * Link[j].xsect.yFull;
+    for (m = DEPTH_TBL_MIN; m <= DEPTH_TBL_MAX; m = 2*m - 1)
+    {
+        t = (double *) realloc(tbl->y, m * sizeof(double));
+        if ( t == NULL )
+        {
+            FREE(tbl->y);
+            tbl->n = 0;
+            return;
+        }
+        tbl->y = t;
+
+        // --- compute depths at the table's flow values
+        t[0] = 0.0;
+        for (i = 1; i < m; i++)
+        {
+            x = (double)i / (double)(m - 1);
+            y = conduit_solveDepth(j, k, type, qMax * x * x * x);
+            t[i] = MAX(y, t[i-1]);
+        }
+
+        // --- find first interval whose midpoint can't be interpolated
+        for (bad = 1; bad < m; bad++)
+        {
+            x = ((double)bad - 0.5) / (double)(m - 1);
+            y = conduit_solveDepth(j, k, type, qMax * x * x * x);
+            if ( fabs(y - 0.5 * (t[bad-1] + t[bad])) > tol ) break;
+        }
+        if ( bad == m ) break;
+    }
+
+    // --- table is usable up to the start of the first bad interval
+    if ( m > DEPTH_TBL_MAX ) m = DEPTH_TBL_MAX;
+    if ( bad <= 1 )
+    {
+        FREE(tbl->y);
+        tbl->n = 0;
+        return;
+    }
+    tbl->n = m;
+    x = (double)(bad - 1) / (double)(m - 1);
+    tbl->qLimit = (bad == m) ? qMax : qMax * x * x * x;
+}
+
+//=============================================================================
+
+double conduit_solveDepth(int j, int k, int type, double q)
+//
+//  Input:   j = link index
+//           k = conduit index
+//           type = YNORM_TABLE or YCRIT_TABLE
+//           q = flow rate per barrel (cfs)
+//  Output:  returns normal or critical depth (ft)
+//  Purpose: computes normal or critical depth directly from the conduit's
+//           cross section geometry.
+//
+{
+    double a;
+
+    if ( q <= 0.0 ) return 0.0;
+    if ( type == YCRIT_TABLE ) return xsect_getYcrit(&Link[j].xsect, q);
+    a = xsect_getAofS(&Link[j].xsect, q / Conduit[k].beta);
+    return xsect_getYofA(&Link[j].xsect, a);
+}
+
+//=============================================================================
+
+double conduit_lookupDepth(TDepthTable* tbl, double q, double qMax)
+//
+//  Input:   tbl = conduit depth table
+//           q = flow rate per barrel (cfs), no greater than tbl->qLimit
+//           qMax = conduit's max. flow (cfs)
+//  Output:  returns normal or critical depth (ft)
+//  Purpose: interpolates a depth from a conduit's depth table.
+//
+{
+    int    i;
+    double x;
+
+    if ( q <= 0.0 ) return 0.0;
+    x = cbrt(q / qMax) * (tbl->n - 1);
+    i = (int)x;
+    if ( i >= tbl->n - 1 ) return tbl->y[tbl->n - 1];
+    return tbl->y[i] + (x - i) * (tbl->y[i+1] - tbl->y[i]);
 }
 
 //=============================================================================
@@ -1400,6 +1567,7 @@ void  pump_validate(int j, int k)
                 }
             }
             Link[j].qFull /= UCF(FLOW);
+            pump_setCurve(k, m);
        }
     }
 
@@ -1430,6 +1598,9 @@ void  pump_initState(int j, int k)
 {
     Link[j].setting = Pump[k].initSetting;
     Link[j].targetSetting = Pump[k].initSetting;
+    Pump[k].curve.entry = 0;
+    Pump[k].curve.lookups = 0;
+    Pump[k].curve.entryChanges = 0;
 }
 
 //=============================================================================
@@ -1465,7 +1636,7 @@ double pump_getInflow(int j)
     {
       case PUMP1_CURVE:
         vol = Node[n1].newVolume * UCF(VOLUME);
-        qIn = table_intervalLookup(&Curve[m], vol) / UCF(FLOW);
+        qIn = pump_intervalLookup(k, vol) / UCF(FLOW);
 
         // --- check if off of pump curve
         if ( vol < Pump[k].xMin || vol > Pump[k].xMax )    
@@ -1474,7 +1645,7 @@ double pump_getInflow(int j)
 
       case PUMP2_CURVE:
         depth = Node[n1].newDepth * UCF(LENGTH);
-        qIn = table_intervalLookup(&Curve[m], depth) / UCF(FLOW);
+        qIn = pump_intervalLookup(k, depth) / UCF(FLOW);
 
         // --- check if off of pump curve
         if ( depth < Pump[k].xMin || depth > Pump[k].xMax )  
@@ -1487,11 +1658,11 @@ double pump_getInflow(int j)
 
 		head = MAX(head, 0.0);
 
-        qIn = table_lookup(&Curve[m], head*UCF(LENGTH)) / UCF(FLOW);
+        qIn = pump_lookup(k, head*UCF(LENGTH)) / UCF(FLOW);
 
         // --- compute dQ/dh (slope of pump curve) and
         //     reverse sign since flow decreases with increasing head
-    	Link[j].dqdh = -table_getSlope(&Curve[m], head*UCF(LENGTH)) * 
+    	Link[j].dqdh = -pump_getSlope(k, head*UCF(LENGTH)) * 
                        UCF(LENGTH) / UCF(FLOW);
 
         // --- check if off of pump curve
@@ -1502,10 +1673,10 @@ double pump_getInflow(int j)
 
       case PUMP4_CURVE:
         depth = Node[n1].newDepth;
-        qIn = table_lookup(&Curve[m], depth*UCF(LENGTH)) / UCF(FLOW);
+        qIn = pump_lookup(k, depth*UCF(LENGTH)) / UCF(FLOW);
 
         // --- compute dQ/dh (slope of pump curve)
-        qIn1 = table_lookup(&Curve[m], (depth+dh)*UCF(LENGTH)) / UCF(FLOW);
+        qIn1 = pump_lookup(k, (depth+dh)*UCF(LENGTH)) / UCF(FLOW);
         Link[j].dqdh = (qIn1 - qIn) / dh;
 
         // --- check if off of pump curve
@@ -1522,6 +1693,152 @@ double pump_getInflow(int j)
     return qIn * Link[j].setting; 
 }
 
+//=============================================================================
+
+void pump_setCurve(int k, int m)
+//
+//  Input:   k = pump index
+//           m = pump curve index
+//  Output:  none
+//  Purpose: copies a pump's curve into flat arrays.
+//
+//  Note:    if memory runs out the pump simply uses the curve's table.
+{
+    int        i, n = 0;
+    double     x, y;
+    TPumpCurve* curve = &Pump[k].curve;
+
+    FREE(curve->x);
+    FREE(curve->y);
+    curve->n = 0;
+    if ( table_getFirstEntry(&Curve[m], &x, &y) )
+    {
+        n = 1;
+        while ( table_getNextEntry(&Curve[m], &x, &y) ) n++;
+    }
+    if ( n == 0 ) return;
+    curve->x = (double *) malloc(n * sizeof(double));
+    curve->y = (double *) malloc(n * sizeof(double));
+    if ( curve->x == NULL || curve->y == NULL )
+    {
+        FREE(curve->x);
+        FREE(curve->y);
+        return;
+    }
+    i = 0;
+    table_getFirstEntry(&Curve[m], &x, &y);
+    do
+    {
+        curve->x[i] = x;
+        curve->y[i] = y;
+        i++;
+    } while ( i < n && table_getNextEntry(&Curve[m], &x, &y) );
+    curve->n = i;
+    curve->entry = 0;
+}
+
+//=============================================================================
+
+int pump_findEntry(TPumpCurve* curve, double x, int strict)
+//
+//  Input:   curve = a pump's curve arrays
+//           x = an x-value
+//           strict = TRUE if the point sought must lie strictly above x
+//  Output:  returns index of the first curve point whose x-value is >= x
+//           (or > x if strict), or the number of points if there is none
+//  Purpose: locates x on a pump curve starting from the point found by
+//           the previous look-up.
+//
+//  Note:    a pump's operating point seldom moves far between routing
+//           iterations, so this takes no more than a step or two.
+{
+    int i = curve->entry;
+
+    if ( strict )
+    {
+        while ( i < curve->n && curve->x[i] <= x ) i++;
+        while ( i > 0 && curve->x[i-1] > x ) i--;
+    }
+    else
+    {
+        while ( i < curve->n && curve->x[i] < x ) i++;
+        while ( i > 0 && curve->x[i-1] >= x ) i--;
+    }
+    curve->lookups++;
+    if ( i != curve->entry )
+    {
+        curve->entryChanges++;
+        curve->entry = i;
+    }
+    return i;
+}
+
+//=============================================================================
+
+double pump_lookup(int k, double x)
+//
+//  Input:   k = pump index
+//           x = an x-value (user units)
+//  Output:  returns flow from pump's curve (user units)
+//  Purpose: interpolates a pump curve (same result as table_lookup).
+//
+{
+    int         i;
+    TPumpCurve* curve = &Pump[k].curve;
+
+    if ( curve->n == 0 ) return table_lookup(&Curve[Pump[k].pumpCurve], x);
+    i = pump_findEntry(curve, x, FALSE);
+    if ( i == 0 ) return curve->y[0];
+    if ( i == curve->n ) return curve->y[curve->n-1];
+    return table_interpolate(x, curve->x[i-1], curve->y[i-1],
+                                curve->x[i], curve->y[i]);
+}
+
+//=============================================================================
+
+double pump_intervalLookup(int k, double x)
+//
+//  Input:   k = pump index
+//           x = an x-value (user units)
+//  Output:  returns flow from pump's curve (user units)
+//  Purpose: finds the flow at the first pump curve point lying above x
+//           (same result as table_intervalLookup).
+//
+{
+    int         i;
+    TPumpCurve* curve = &Pump[k].curve;
+
+    if ( curve->n == 0 )
+        return table_intervalLookup(&Curve[Pump[k].pumpCurve], x);
+    i = pump_findEntry(curve, x, TRUE);
+    if ( i == curve->n ) i--;
+    return curve->y[i];
+}
+
+//=============================================================================
+
+double pump_getSlope(int k, double x)
+//
+//  Input:   k = pump index
+//           x = an x-value (user units)
+//  Output:  returns slope of pump's curve at x
+//  Purpose: finds the slope of the pump curve segment containing x
+//           (same result as table_getSlope).
+//
+{
+    int         i;
+    double      dx;
+    TPumpCurve* curve = &Pump[k].curve;
+
+    if ( curve->n == 0 ) return table_getSlope(&Curve[Pump[k].pumpCurve], x);
+    i = pump_findEntry(curve, x, FALSE);
+    if ( i == curve->n || curve->n < 2 ) return 0.0;
+    if ( i == 0 ) i = 1;
+    dx = curve->x[i] - curve->x[i-1];
+    if ( dx == 0.0 ) return 0.0;
+    return (curve->y[i] - curve->y[i-1]) / dx;
+}
+
 
 //=============================================================================
 //                    O R I F I C E   M E T H O D S
@@ -1611,6 +1928,10 @@ void  orifice_validate(int j, int k)
     Orifice[k].length = 2.0 * RouteStep * sqrt(GRAVITY * Link[j].xsect.yFull);
     Orifice[k].length = MAX(200.0, Orifice[k].length);
     Orifice[k].surfArea = 0.0;
+
+    // --- area of opening is found when first needed
+    Orifice[k].aSetting = -1.0;
+    Orifice[k].aOpen = 0.0;
 }
 
 //=============================================================================
@@ -1807,7 +2128,7 @@ double orifice_getInflow(int j)
     else
     {
         Link[j].newDepth = y1;
-        Orifice[k].surfArea = xsect_getAofY(&Link[j].xsect, y1);
+        Orifice[k].surfArea = orifice_getOpenArea(j, k);
     }
 
     // --- find flow through the orifice
@@ -1864,8 +2185,7 @@ double orifice_getFlow(int j, int k,  double head, double f, int hasFlapGate)
     if ( hasFlapGate )
     {
         // --- compute velocity for current orifice flow
-        area = xsect_getAofY(&Link[j].xsect,
-                             Link[j].setting * Link[j].xsect.yFull);
+        area = orifice_getOpenArea(j, k);
         veloc = q / area;
 
         // --- compute head loss from gate
@@ -1892,6 +2212,28 @@ double orifice_getFlow(int j, int k,  double head, double f, int hasFlapGate)
     return q;
 }
 
+//=============================================================================
+
+double orifice_getOpenArea(int j, int k)
+//
+//  Input:   j = link index
+//           k = orifice index
+//  Output:  returns area of orifice opening (ft2)
+//  Purpose: finds the flow area of an orifice at its current setting.
+//
+//  Note:    the area is only recomputed when the setting has changed
+//           (settings can also be restored from a hot start file, so
+//           the check is made here rather than in orifice_setSetting).
+{
+    if ( Link[j].setting != Orifice[k].aSetting )
+    {
+        Orifice[k].aSetting = Link[j].setting;
+        Orifice[k].aOpen = xsect_getAofY(&Link[j].xsect,
+                                         Link[j].setting * Link[j].xsect.yFull);
+    }
+    return Orifice[k].aOpen;
+}
+
 //=============================================================================
 //                           W E I R   M E T H O D S
 //=============================================================================
@@ -2014,6 +2356,13 @@ void  weir_validate(int j, int k)
     Weir[k].length = 2.0 * RouteStep * sqrt(GRAVITY * Link[j].xsect.yFull);
     Weir[k].length = MAX(200.0, Weir[k].length);
     Weir[k].surfArea = 0.0;
+
+    // --- save terms of the weir equation that don't change
+    //     (trapezoidal crest width is found when first needed)
+    Weir[k].endConCoeff = 0.1 * Weir[k].endCon;
+    Weir[k].crestLength = Link[j].xsect.wMax * UCF(LENGTH);
+    Weir[k].crestSetting = -1.0;
+    Weir[k].crestWidth = 0.0;
 }
 
 //=============================================================================
@@ -2127,9 +2476,8 @@ double weir_getInflow(int j)
         else              Link[j].flowClass = UP_CRITICAL;
     }
 
-    // --- compute new equivalent surface area
-    y = Link[j].xsect.yFull - (hcrown - MIN(h1, hcrown));
-    Weir[k].surfArea = xsect_getWofY(&Link[j].xsect, y) * Weir[k].length;
+    // --- equivalent surface area is not computed since weirs contribute
+    //     none to their end nodes (see findNonConduitSurfArea in dynwave.c)
 
 ////  New section added to release 5.1.007.  ////                              //(5.1.007)
     // --- head is above crown
@@ -2187,7 +2535,6 @@ void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
 {
     double length;
     double h;
-    double y;
     double hLoss;
     double area;
     double veloc;
@@ -2201,11 +2548,11 @@ void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
     if ( head <= 0.0 ) return;
 
     // --- convert weir length & head to original units
-    length = Link[j].xsect.wMax * UCF(LENGTH);
+    length = Weir[k].crestLength;
     h = head * UCF(LENGTH);
 
     // --- reduce length when end contractions present
-    length -= 0.1 * Weir[k].endCon * h;
+    length -= Weir[k].endConCoeff * h;
     length = MAX(length, 0.0);
 
     // --- use appropriate formula for weir flow
@@ -2231,9 +2578,8 @@ void weir_getFlow(int j, int k,  double head, double dir, int hasFlapGate,
         break;
 
       case TRAPEZOIDAL_WEIR:
-        y = (1.0 - Link[j].setting) * Link[j].xsect.yFull;
-        length = xsect_getWofY(&Link[j].xsect, y) * UCF(LENGTH);
-        length -= 0.1 * Weir[k].endCon * h;
+        length = weir_getCrestWidth(j, k);
+        length -= Weir[k].endConCoeff * h;
         length = MAX(length, 0.0);
         *q1 = Weir[k].cDisch1 * length * pow(h, 1.5);
         *q2 = Weir[k].cDisch2 * Weir[k].slope * pow(h, 2.5);
@@ -2331,6 +2677,29 @@ double weir_getOpenArea(int j, double y)
 
 //=============================================================================
 
+double weir_getCrestWidth(int j, int k)
+//
+//  Input:   j = link index
+//           k = weir index
+//  Output:  returns crest width in original units
+//  Purpose: finds the crest width of a trapezoidal (or partly open
+//           V-notch) weir at its current setting.
+//
+//  Note:    the width is only recomputed when the setting has changed.
+{
+    double y;
+
+    if ( Link[j].setting != Weir[k].crestSetting )
+    {
+        y = (1.0 - Link[j].setting) * Link[j].xsect.yFull;
+        Weir[k].crestSetting = Link[j].setting;
+        Weir[k].crestWidth = xsect_getWofY(&Link[j].xsect, y) * UCF(LENGTH);
+    }
+    return Weir[k].crestWidth;
+}
+
+//=============================================================================
+
 double  weir_getdqdh(int k, double dir, double h, double q1, double q2)
 {
     double q1h;
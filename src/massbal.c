@@ -60,6 +60,7 @@ double   TotalArea;               // total drainage area (ft2)
 //  massbal_addLinkLosses       (called from removeConduitLosses in routing.c)
 //  massbal_addReactedMass      (called from qualrout.c & treatmnt.c)
 //  massbal_getStepFlowError    (called from routing.c)
+//  massbal_snapshot            (called from copyState in snapshot.c)
 
 //-----------------------------------------------------------------------------
 //  Local Functions   
@@ -981,6 +982,30 @@ double massbal_getStepFlowError()
 
 //=============================================================================
 
+void massbal_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores all continuity totals in a simulation state
+//           snapshot.
+//
+{
+    int n = Nobjects[POLLUT];
+
+    snapshot_copy(&RunoffTotals, sizeof(TRunoffTotals));
+    snapshot_copy(LoadingTotals, n * sizeof(TLoadingTotals));
+    snapshot_copy(&GwaterTotals, sizeof(TGwaterTotals));
+    snapshot_copy(&FlowTotals, sizeof(TRoutingTotals));
+    snapshot_copy(QualTotals, n * sizeof(TRoutingTotals));
+    snapshot_copy(&StepFlowTotals, sizeof(TRoutingTotals));
+    snapshot_copy(&OldStepFlowTotals, sizeof(TRoutingTotals));
+    snapshot_copy(StepQualTotals, n * sizeof(TRoutingTotals));
+    snapshot_copy(NodeInflow, Nobjects[NODE] * sizeof(double));
+    snapshot_copy(NodeOutflow, Nobjects[NODE] * sizeof(double));
+}
+
+//=============================================================================
+
 double massbal_getStoredMass(int p)
 //
 //  Input:   p = pollutant index
@@ -40,6 +40,16 @@
 **	  27 = log10
 **    28 = step (x<=0 ? 0 : 1)
 **	  31 = ^
+**
+**   Once parsed, an expression is also compiled into a contiguous array of
+**   register-based instructions. Each distinct variable gets one register,
+**   operations whose arguments are all constants are folded at compile
+**   time, and a constant argument of any other operation is stored in the
+**   instruction itself. mathexpr_eval loads the variable registers
+**   (calling getVariableValue once per variable) and runs the code. The
+**   code holds no evaluation state, so one expression may be evaluated by
+**   several threads at once. The postfix list is used instead only if an
+**   expression needs too many registers to compile.
 ******************************************************************************/
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -51,6 +61,7 @@
 #include "mathexpr.h"
 
 #define MAX_STACK_SIZE  1024
+#define MAX_CODE_REGS   128            // max. registers in compiled code
 
 //  Local declarations
 //--------------------
@@ -65,6 +76,32 @@ struct TreeNode
 };
 typedef struct TreeNode ExprTree;
 
+//  Forms of the arguments of a compiled instruction
+enum ArgForm {REG_REG,            // both arguments are registers
+              REG_CONST,          // second argument is a constant
+              CONST_REG};         // first argument is a constant
+
+//  Instruction in a compiled math expression
+typedef struct
+{
+    int    opcode;                // operator code * 4 + argument form
+    int    result;                // register receiving the result
+    int    arg1;                  // register of first (or only) argument
+    int    arg2;                  // register of second argument
+    double k;                     // value of a constant argument
+} MathInstr;
+
+//  Compiled math expression (the arrays follow the structure in memory)
+struct MathCode
+{
+    int        nVars;             // number of variable registers
+    int        nInstr;            // number of instructions
+    int        result;            // register holding the expression's value
+    double     k;                 // value of a constant expression
+    MathInstr* instr;             // instructions in order of execution
+    int*       varIndex;          // variable index of each variable register
+};
+
 // Local variables
 //----------------
 static int    Err;
@@ -99,6 +136,11 @@ static ExprTree * getOp(int *);
 static ExprTree * getTree(void);
 static void       traverseTree(ExprTree *, MathExpr **);
 static void       deleteTree(ExprTree *);
+static int        isBinaryOp(int);
+static int        isUnaryOp(int);
+static double     applyOp(int, double, double);
+static struct MathCode * compileExpr(MathExpr *);
+static double     evalCode(struct MathCode *, double (*) (int));
 
 // Callback functions
 static int    (*getVariableIndex) (char *); // return index of named variable
@@ -510,6 +552,7 @@ void traverseTree(ExprTree *tree, MathExpr **expr)
     node->fvalue = tree->fvalue;
     node->opcode = tree->opcode;
     node->ivar = tree->ivar;
+    node->code = NULL;
     node->next = NULL;
     node->prev = (*expr);
     if (*expr) (*expr)->next = node;
@@ -541,6 +584,9 @@ double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
     MathExpr *node = expr;
     double r1, r2;
     int stackindex = 0;
+
+    // --- run the compiled form of the expression if there is one
+    if ( expr && expr->code ) return evalCode(expr->code, getVariableValue);
     
     ExprStack[0] = 0.0;
     while(node != NULL)
@@ -734,7 +780,11 @@ double mathexpr_eval(MathExpr *expr, double (*getVariableValue) (int))
 
 void mathexpr_delete(MathExpr *expr)
 {
-    if (expr) mathexpr_delete(expr->next);
+    if (expr)
+    {
+        mathexpr_delete(expr->next);
+        free(expr->code);
+    }
     free(expr);
 }
 
@@ -762,7 +812,274 @@ MathExpr * mathexpr_create(char *formula, int (*getVar) (char *))
             result = expr;
             expr = expr->prev;
         }
+        if (result) result->code = compileExpr(result);
     }
     deleteTree(tree);
     return result;
 }
+
+//=============================================================================
+
+int isBinaryOp(int opcode)
+{
+    return (opcode >= 3 && opcode <= 6) || opcode == 31;
+}
+
+//=============================================================================
+
+int isUnaryOp(int opcode)
+{
+    return opcode >= 9 && opcode <= 28;
+}
+
+//=============================================================================
+
+double applyOp(int opcode, double r2, double r1)
+/*
+**  Purpose:
+**    applies an operator to its arguments.
+**
+**  Input:
+**    opcode = operator code
+**    r2 = first (or only) argument
+**    r1 = second argument.
+**
+**  Returns:
+**    the value of the operation, computed as in mathexpr_eval.
+*/
+{
+    switch (opcode)
+    {
+      case 3:  return r2 + r1;
+      case 4:  return r2 - r1;
+      case 5:  return r2 * r1;
+      case 6:  return r2 / r1;
+      case 9:  return -r2;
+      case 10: return cos(r2);
+      case 11: return sin(r2);
+      case 12: return tan(r2);
+      case 13: if (r2 == 0.0) return 0.0;
+               return 1.0/tan( r2 );
+      case 14: return fabs( r2 );
+      case 15: if (r2 < 0.0) return -1.0;
+               if (r2 > 0.0) return 1.0;
+               return 0.0;
+      case 16: if (r2 < 0.0) return 0.0;
+               return sqrt( r2 );
+      case 17: if (r2 <= 0) return 0.0;
+               return log(r2);
+      case 18: return exp(r2);
+      case 19: return asin( r2 );
+      case 20: return acos( r2 );
+      case 21: return atan( r2 );
+      case 22: return 1.57079632679489661923 - atan(r2);
+      case 23: return (exp(r2)-exp(-r2))/2.0;
+      case 24: return (exp(r2)+exp(-r2))/2.0;
+      case 25: return (exp(r2)-exp(-r2))/(exp(r2)+exp(-r2));
+      case 26: return (exp(r2)+exp(-r2))/(exp(r2)-exp(-r2));
+      case 27: if (r2 == 0.0) return 0.0;
+               return log10( r2 );
+      case 28: if (r2 <= 0.0) return 0.0;
+               return 1.0;
+      case 31: if (r2 <= 0.0) return 0.0;
+               return exp(r1*log(r2));
+    }
+    return r2;
+}
+
+//=============================================================================
+
+struct MathCode * compileExpr(MathExpr *expr)
+/*
+**  Purpose:
+**    compiles a tokenized math expression into register-based code.
+**
+**  Input:
+**    expr = first node of a tokenized math expression.
+**  
+**  Returns:
+**    a pointer to the compiled code, or NULL if the expression could
+**    not be compiled.
+**
+**  Note:
+**    registers 0 to nVars-1 hold the variables. The result of an operation
+**    goes to a temporary register numbered by its position on the operand
+**    stack, which while compiling is coded as -1-position and is given its
+**    final number (nVars+position) at the end.
+*/
+{
+    int       varIndex[MAX_CODE_REGS];   // variable index of each var. reg.
+    int       isConst[MAX_CODE_REGS];    // TRUE if stack entry is constant
+    double    value[MAX_CODE_REGS];      // value of constant stack entries
+    int       reg[MAX_CODE_REGS];        // register of other stack entries
+    MathInstr instr[MAX_CODE_REGS];      // instructions
+    int       nVars = 0, nTemps = 0, nInstr = 0, top = -1;
+    int       i, k, n, op, form;
+    MathInstr *in;
+    struct MathCode *code;
+    MathExpr  *node;
+
+    for (node = expr; node != NULL; node = node->next)
+    {
+        op = node->opcode;
+
+        // --- number or variable is pushed onto the stack
+        if ( op == 7 || op == 8 )
+        {
+            if ( ++top >= MAX_CODE_REGS ) return NULL;
+            isConst[top] = (op == 7);
+            value[top] = node->fvalue;
+            if ( op == 8 )
+            {
+                for (k = 0; k < nVars; k++)
+                    if ( varIndex[k] == node->ivar ) break;
+                if ( k == nVars )
+                {
+                    if ( nVars >= MAX_CODE_REGS ) return NULL;
+                    varIndex[nVars++] = node->ivar;
+                }
+                reg[top] = k;
+            }
+        }
+
+        // --- operator replaces its arguments with its result
+        else if ( isBinaryOp(op) || isUnaryOp(op) )
+        {
+            n = isBinaryOp(op) ? 2 : 1;
+            if ( top < n - 1 ) return NULL;
+            top -= n - 1;
+
+            // --- fold operation on constants
+            if ( isConst[top] && (n == 1 || isConst[top+1]) )
+            {
+                value[top] = applyOp(op, value[top],
+                                     (n == 2) ? value[top+1] : 0.0);
+                continue;
+            }
+
+            // --- emit instruction, keeping any constant argument in it
+            if ( nInstr >= MAX_CODE_REGS ) return NULL;
+            in = &instr[nInstr++];
+            form = REG_REG;
+            in->k = 0.0;
+            if ( n == 1 )
+            {
+                in->arg1 = reg[top];
+                in->arg2 = reg[top];
+            }
+            else if ( isConst[top] )
+            {
+                form = CONST_REG;
+                in->k = value[top];
+                in->arg1 = reg[top+1];
+                in->arg2 = reg[top+1];
+            }
+            else if ( isConst[top+1] )
+            {
+                form = REG_CONST;
+                in->k = value[top+1];
+                in->arg1 = reg[top];
+                in->arg2 = reg[top];
+            }
+            else
+            {
+                in->arg1 = reg[top];
+                in->arg2 = reg[top+1];
+            }
+            in->opcode = 4 * op + form;
+            in->result = -1 - top;
+            reg[top] = -1 - top;
+            isConst[top] = 0;
+            if ( top + 1 > nTemps ) nTemps = top + 1;
+        }
+    }
+
+    // --- expression's value is the entry left on top of the stack
+    if ( top < 0 || nVars + nTemps > MAX_CODE_REGS ) return NULL;
+
+    // --- allocate the code as a single block
+    code = (struct MathCode *) malloc(sizeof(struct MathCode) +
+           nInstr * sizeof(MathInstr) + nVars * sizeof(int));
+    if ( code == NULL ) return NULL;
+    code->nVars = nVars;
+    code->nInstr = nInstr;
+    code->instr = (MathInstr *) (code + 1);
+    code->varIndex = (int *) (code->instr + nInstr);
+    memcpy(code->instr, instr, nInstr * sizeof(MathInstr));
+    memcpy(code->varIndex, varIndex, nVars * sizeof(int));
+
+    // --- give temporary registers their final numbers
+    //     (a constant expression has a result register of -1)
+    code->k = value[top];
+    if ( isConst[top] ) code->result = -1;
+    else if ( reg[top] < 0 ) code->result = nVars - 1 - reg[top];
+    else code->result = reg[top];
+    for (i = 0; i < nInstr; i++)
+    {
+        in = &code->instr[i];
+        in->result = nVars - 1 - in->result;
+        if ( in->arg1 < 0 ) in->arg1 = nVars - 1 - in->arg1;
+        if ( in->arg2 < 0 ) in->arg2 = nVars - 1 - in->arg2;
+    }
+    return code;
+}
+
+//=============================================================================
+
+double evalCode(struct MathCode *code, double (*getVariableValue) (int))
+/*
+**  Purpose:
+**    evaluates a compiled math expression.
+**
+**  Input:
+**    code = compiled math expression
+**    getVariableValue = function that returns the value of a variable.
+**  
+**  Returns:
+**    the value of the expression.
+*/
+{
+    double     r[MAX_CODE_REGS];
+    MathInstr* in = code->instr;
+    MathInstr* end = in + code->nInstr;
+    int        i;
+
+    if ( code->result < 0 ) return code->k;
+    for (i = 0; i < code->nVars; i++)
+    {
+        if (getVariableValue != NULL) r[i] = getVariableValue(code->varIndex[i]);
+        else r[i] = 0.0;
+    }
+    for ( ; in < end; in++)
+    {
+        switch (in->opcode)
+        {
+          case 4*3:   r[in->result] = r[in->arg1] + r[in->arg2]; break;
+          case 4*3+1: r[in->result] = r[in->arg1] + in->k;       break;
+          case 4*3+2: r[in->result] = in->k + r[in->arg2];       break;
+          case 4*4:   r[in->result] = r[in->arg1] - r[in->arg2]; break;
+          case 4*4+1: r[in->result] = r[in->arg1] - in->k;       break;
+          case 4*4+2: r[in->result] = in->k - r[in->arg2];       break;
+          case 4*5:   r[in->result] = r[in->arg1] * r[in->arg2]; break;
+          case 4*5+1: r[in->result] = r[in->arg1] * in->k;       break;
+          case 4*5+2: r[in->result] = in->k * r[in->arg2];       break;
+          case 4*6:   r[in->result] = r[in->arg1] / r[in->arg2]; break;
+          case 4*6+1: r[in->result] = r[in->arg1] / in->k;       break;
+          case 4*6+2: r[in->result] = in->k / r[in->arg2];       break;
+          default:
+            switch (in->opcode & 3)
+            {
+              case REG_CONST:
+                r[in->result] = applyOp(in->opcode/4, r[in->arg1], in->k);
+                break;
+              case CONST_REG:
+                r[in->result] = applyOp(in->opcode/4, in->k, r[in->arg2]);
+                break;
+              default:
+                r[in->result] = applyOp(in->opcode/4, r[in->arg1],
+                                        r[in->arg2]);
+            }
+        }
+    }
+    return r[code->result];
+}
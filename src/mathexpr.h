@@ -8,6 +8,9 @@
 **  LAST UPDATE:   03/20/14
 ******************************************************************************/
 
+//  Register-based code compiled from a tokenized math expression
+struct MathCode;
+
 //  Node in a tokenized math expression list
 struct ExprNode
 {
@@ -16,6 +19,7 @@ struct ExprNode
     double fvalue;                // numerical value
 	struct ExprNode *prev;        // previous node
     struct ExprNode *next;        // next node
+    struct MathCode *code;        // compiled expression (first node only)
 };
 typedef struct ExprNode MathExpr;
 
@@ -23,6 +27,7 @@ typedef struct ExprNode MathExpr;
 MathExpr* mathexpr_create(char* s, int (*getVar) (char *));
 
 //  Evaluates a tokenized math expression
+//  (getVal is called once for each distinct variable in the expression)
 double mathexpr_eval(MathExpr* expr, double (*getVal) (int));
 
 //  Deletes a tokenized math expression
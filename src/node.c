@@ -129,6 +129,7 @@ void  node_setParams(int j, int type, int k, double x[])
         Outfall[k].fixedStage  = x[2] / UCF(LENGTH);
         Outfall[k].tideCurve   = (int)x[3];
         Outfall[k].stageSeries = (int)x[4];
+        Outfall[k].tsCursor    = 0;
         Outfall[k].hasFlapGate = (char)x[5];
         break;
 
@@ -1286,8 +1287,8 @@ void outfall_setOutletDepth(int j, double yNorm, double yCrit, double z)
       case TIMESERIES_OUTFALL:
         k = Outfall[i].stageSeries;
         currentDate = StartDateTime + NewRoutingTime / MSECperDAY;
-        stage = table_tseriesLookup(&Tseries[k], currentDate, TRUE) /
-                UCF(LENGTH);
+        stage = table_tseriesCursorLookup(&Tseries[k], &Outfall[i].tsCursor,
+                                          currentDate, TRUE) / UCF(LENGTH);
         break;
       default: stage = Node[j].invertElev;
     }
@@ -64,6 +64,11 @@ typedef struct
    TTableEntry*  lastEntry;       // last data point
    TTableEntry*  thisEntry;       // current data point
    TFile         file;            // external data file
+   int           nPoints;         // number of data points in arrays
+   int           thisPoint;       // index of current data point in arrays
+   int           cursor;          // time bracket used by tseriesLookup
+   double*       xData;           // x-values of data points (time series)
+   double*       yData;           // y-values of data points (time series)
 }  TTable;
 
 
@@ -84,9 +89,9 @@ typedef struct
    int           rainUnits;       // rain depth units (US or SI)
    double        snowFactor;      // snow catch deficiency correction
 
-   long          startFilePos;    // starting byte position in Rain file
-   long          endFilePos;      // ending byte position in Rain file
-   long          currentFilePos;  // current byte position in Rain file
+   long long     startFilePos;    // starting byte position in Rain file
+   long long     endFilePos;      // ending byte position in Rain file
+   long long     currentFilePos;  // current byte position in Rain file
    double        rainAccum;       // cumulative rainfall
    double        unitsFactor;     // units conversion factor (to inches or mm)
    DateTime      startDate;       // start date of current rainfall
@@ -108,6 +113,7 @@ typedef struct
 {
    int           dataSource;      // data from time series or file 
    int           tSeries;         // temperature data time series index
+   int           tsCursor;        // time bracket in temperature time series
    DateTime      fileStartDate;   // starting date of data read from file
    double        elev;            // elev. of study area (ft)
    double        anglat;          // latitude (degrees)
@@ -250,6 +256,8 @@ typedef struct
    int           toSubcatch;      // index of subcatch receiving plowed snow
 
    double        dhm[3];          // melt coeff. for each surface (ft/sec-F)
+   double        ccRate[3];       // cold content gain rate (ft/sec-F)
+   double        dmelt[3];        // degree-day melt at current temp. (ft/sec)
 }  TSnowmelt;
 
 
@@ -270,6 +278,7 @@ typedef struct
    double        awe[3];          // initial AWESI of linear ADC
    double        sbws[3];         // final AWESI of linear ADC
    double        imelt[3];        // immediate melt (ft)
+   double        netPrecip[3];    // net precip. on each runoff sub-area (ft/sec)
 }  TSnowpack;
 
 
@@ -371,6 +380,7 @@ struct ExtInflow
    double         cFactor;       // units conversion factor for mass inflow
    double         baseline;      // constant baseline value
    double         sFactor;       // time series scaling factor
+   int            tsCursor;      // time bracket in inflow time series
    struct ExtInflow* next;       // pointer to next inflow data object
 };
 typedef struct ExtInflow TExtInflow;
@@ -475,6 +485,7 @@ typedef struct
    double     fixedStage;         // fixed outfall stage (ft)
    int        tideCurve;          // index of tidal stage curve
    int        stageSeries;        // index of outfall stage time series
+   int        tsCursor;           // time bracket in stage time series
 }  TOutfall;
 
 
@@ -538,7 +549,8 @@ typedef struct
 //--------------------------------------
 // CROSS SECTION TRANSECT DATA STRUCTURE
 //--------------------------------------
-#define  N_TRANSECT_TBL  51       // size of transect geometry tables
+#define  N_TRANSECT_TBL      51   // min. size of transect geometry tables
+#define  N_TRANSECT_TBL_MAX  401  // max. size of transect geometry tables
 typedef struct
 {
     char*        ID;                        // section ID
@@ -552,9 +564,9 @@ typedef struct
     double       lengthFactor;              // floodplain / channel length 
 
     double       roughness;                 // Manning's n
-    double       areaTbl[N_TRANSECT_TBL];   // table of area v. depth
-    double       hradTbl[N_TRANSECT_TBL];   // table of hyd. radius v. depth
-    double       widthTbl[N_TRANSECT_TBL];  // table of top width v. depth
+    double*      areaTbl;                   // table of area v. depth
+    double*      hradTbl;                   // table of hyd. radius v. depth
+    double*      widthTbl;                  // table of top width v. depth
     int          nTbl;                      // size of geometry tables
 }   TTransect;
 
@@ -562,7 +574,8 @@ typedef struct
 //-------------------------------------
 // CUSTOM CROSS SECTION SHAPE STRUCTURE
 //-------------------------------------
-#define N_SHAPE_TBL  51           // size of shape geometry tables
+#define N_SHAPE_TBL      51       // min. size of shape geometry tables
+#define N_SHAPE_TBL_MAX  401      // max. size of shape geometry tables
 typedef struct
 {
     int          curve;                     // index of shape curve
@@ -572,9 +585,9 @@ typedef struct
     double       wMax;                      // max. width
     double       sMax;                      // max. section factor
     double       aMax;                      // area at max. section factor
-    double       areaTbl[N_SHAPE_TBL];      // table of area v. depth
-    double       hradTbl[N_SHAPE_TBL];      // table of hyd. radius v. depth
-    double       widthTbl[N_SHAPE_TBL];     // table of top width v. depth
+    double*      areaTbl;                   // table of area v. depth
+    double*      hradTbl;                   // table of hyd. radius v. depth
+    double*      widthTbl;                  // table of top width v. depth
 }   TShape;
 
 
@@ -624,6 +637,17 @@ typedef struct
 }  TLink;
 
 
+//---------------------
+// CONDUIT DEPTH TABLE
+//---------------------
+typedef struct
+{
+   int           n;               // number of table entries
+   double        qLimit;          // largest flow covered by table (cfs)
+   double*       y;               // depths at flows spaced evenly in
+                                  // (q/qMax)^(1/3) (ft)
+}  TDepthTable;
+
 //---------------
 // CONDUIT OBJECT
 //---------------
@@ -646,9 +670,24 @@ typedef struct
    char          capacityLimited; // capacity limited flag
    char          superCritical;   // super-critical flow flag
    char          hasLosses;       // local losses flag
+   TDepthTable   yNormTbl;        // normal depth v. flow table
+   TDepthTable   yCritTbl;        // critical depth v. flow table
 }  TConduit;
 
 
+//------------------
+// PUMP CURVE ARRAYS
+//------------------
+typedef struct
+{
+   int           n;               // number of curve points
+   int           entry;           // point found by last look-up
+   double*       x;               // x-values of points (user units)
+   double*       y;               // flows at points (user units)
+   long long     lookups;         // number of look-ups made
+   long long     entryChanges;    // look-ups that moved to another segment
+}  TPumpCurve;
+
 //------------
 // PUMP OBJECT
 //------------
@@ -661,6 +700,7 @@ typedef struct
    double        yOff;            // shutoff depth (ft)
    double        xMin;            // minimum pt. on pump curve 
    double        xMax;            // maximum pt. on pump curve
+   TPumpCurve    curve;           // copy of pump curve in flat arrays
 }  TPump;
 
 
@@ -679,6 +719,8 @@ typedef struct
    double        cWeir;           // coeff. for weir flow (cfs)
    double        length;          // equivalent length (ft)
    double        surfArea;        // equivalent surface area (ft2)
+   double        aSetting;        // setting at which aOpen was found
+   double        aOpen;           // area of opening at aSetting (ft2)
 }  TOrifice;
 
 
@@ -698,6 +740,11 @@ typedef struct
    double        length;          // equivalent length (ft)
    double        slope;           // slope for Vnotch & Trapezoidal weirs
    double        surfArea;        // equivalent surface area (ft2)
+   double        endConCoeff;     // 0.1 * end contractions
+   double        crestLength;     // crest length when fully open (user units)
+   double        crestSetting;    // setting at which crestWidth was found
+   double        crestWidth;      // trapezoidal crest width at crestSetting
+                                  // (user units)
 }  TWeir;
 
 
@@ -742,6 +789,7 @@ typedef struct
    int           funcType;        // buildup function type code
    double        coeff[3];        // coeffs. of buildup function
    double        maxDays;         // time to reach max. buildup (days)
+   int           tsCursor;        // time bracket in buildup time series
 }  TBuildup;
 
 
@@ -406,8 +406,11 @@ void output_openOutFile()
         getTempFileName(Fout.name);
     }
 
-    // --- try to open the file
-    if ( (Fout.file = fopen(Fout.name, "w+b")) == NULL)
+    // --- try to open the file (keeping the results saved before the
+    //     checkpoint a run resumes from)
+    if ( checkpoint_isResuming() ) Fout.file = fopen(Fout.name, "r+b");
+    else Fout.file = fopen(Fout.name, "w+b");
+    if ( Fout.file == NULL )
     {
         writecon(FMT14);
         ErrorCode = ERR_OUT_FILE;
@@ -445,6 +448,18 @@ void output_saveResults(double reportTime)
 
 //=============================================================================
 
+double output_getBytesSaved()
+//
+//  Input:   none
+//  Output:  returns number of bytes of computed results saved so far
+//  Purpose: reports the size of the results written by output_saveResults.
+//
+{
+    return (double)BytesPerPeriod * (double)Nperiods;
+}
+
+//=============================================================================
+
 void output_end()
 //
 //  Input:   none
@@ -0,0 +1,476 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   profile.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Run time profiling of the engine's main computational routines.
+//
+//   When the PROFILE option is turned on, a monotonic clock is read at the
+//   start and end of each call to the routines listed in ProfileTimerType
+//   and the elapsed times and call counts are accumulated. The number of
+//   Picard iterations used by each dynamic wave routing step is also
+//   tallied, as are the pump curve look-ups that had to move to another
+//   curve segment. A summary is written to the report file at the end of
+//   the run and, if a PROFILE_FILE was named, to that file in JSON format.
+//
+//   If a COST_FILE is named, the dynamic wave solver's cost is also charged
+//   to the individual nodes and links responsible for it (extra iterations,
+//   non-converged steps and Courant critical time steps) and written to
+//   that file as a CSV table.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include "headers.h"
+
+#define WRITE(x) (report_writeLine((x)))
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define MAX_PROF_TRIALS 50        // iteration counts above this share a bin
+
+static char* TimerNames[] = {"Runoff", "Flow Routing", "Dynamic Wave",
+                             "Control Rules", "Quality Routing",
+                             "Mass Balance", "Output Results"};
+static char* TimerKeys[]  = {"runoff", "routing", "dynwave", "controls",
+                             "qualrout", "massbal", "output"};
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    long long  calls;             // number of calls timed
+    long long  total;             // total ticks spent in calls
+    long long  maxTime;           // longest single call (ticks)
+    long long  started;           // clock reading at start of current call
+}  TProfTimer;
+
+typedef struct
+{
+    long       trials;            // iterations not converged (node) or
+                                  //   recomputed after the 2nd (link)
+    long       failures;          // non-converged steps ending with the
+                                  //   element (or an end node) unconverged
+    long       critical;          // times it set the variable time step
+    double     smallStepTime;     // sum of those steps below CostStepLimit
+}  TElemCost;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TProfTimer Timers[MAX_PROF_TIMERS];
+static long long  Trials[MAX_PROF_TRIALS+1];  // steps using each # iterations
+static long long  NonConverged;               // steps that did not converge
+static long long  RunStart;                   // clock reading at start of run
+static double     TicksPerSec;                // clock resolution
+static FILE*      JsonFile;                   // JSON summary file
+static FILE*      Fcost;                      // element cost file
+static TElemCost* NodeCost;                   // costs charged to each node
+static TElemCost* LinkCost;                   // costs charged to each link
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  profile_open          (called by swmm_start)
+//  profile_start         (called at start of each profiled routine)
+//  profile_stop          (called at end of each profiled routine)
+//  profile_addTrials     (called by dynwave_execute)
+//  profile_addTrialCost  (called from dynwave.c)
+//  profile_addFailureCost(called by dynwave_execute)
+//  profile_addStepCost   (called by getVariableStep in dynwave.c)
+//  profile_report        (called by swmm_end)
+//  profile_close         (called by swmm_end)
+
+//-----------------------------------------------------------------------------
+//  Function declarations
+//-----------------------------------------------------------------------------
+static long long getTicks(void);
+static void      getPumpLookups(double* lookups, double* changes);
+static void      writeJsonFile(double runTime);
+static void      writeCostFile(void);
+
+//=============================================================================
+
+void profile_open()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: clears all timers and counters at the start of a run.
+//
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+#endif
+
+    JsonFile = NULL;
+    Fcost = NULL;
+    NodeCost = NULL;
+    LinkCost = NULL;
+    if ( !Profiling ) return;
+    if ( strlen(ProfileFile) > 0 )
+    {
+        JsonFile = fopen(ProfileFile, "wt");
+        if ( JsonFile == NULL )
+        {
+            report_writeErrorMsg(ERR_PROFILE_FILE_OPEN, ProfileFile);
+            return;
+        }
+    }
+
+    // --- open element cost file & allocate its counters
+    if ( strlen(CostFile) > 0 )
+    {
+        Fcost = fopen(CostFile, "wt");
+        if ( Fcost == NULL )
+        {
+            report_writeErrorMsg(ERR_COST_FILE_OPEN, CostFile);
+            return;
+        }
+        NodeCost = (TElemCost *) calloc(Nobjects[NODE], sizeof(TElemCost));
+        LinkCost = (TElemCost *) calloc(Nobjects[LINK], sizeof(TElemCost));
+        if ( (Nobjects[NODE] > 0 && NodeCost == NULL) ||
+             (Nobjects[LINK] > 0 && LinkCost == NULL) )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return;
+        }
+    }
+    memset(Timers, 0, sizeof(Timers));
+    memset(Trials, 0, sizeof(Trials));
+    NonConverged = 0;
+
+#ifdef _WIN32
+    QueryPerformanceFrequency(&freq);
+    TicksPerSec = (double)freq.QuadPart;
+#else
+    TicksPerSec = 1.0e9;
+#endif
+    RunStart = getTicks();
+}
+
+//=============================================================================
+
+void profile_start(int timer)
+//
+//  Input:   timer = a ProfileTimerType code
+//  Output:  none
+//  Purpose: marks the start of a call to a profiled routine.
+//
+{
+    if ( !Profiling ) return;
+    Timers[timer].started = getTicks();
+}
+
+//=============================================================================
+
+void profile_stop(int timer)
+//
+//  Input:   timer = a ProfileTimerType code
+//  Output:  none
+//  Purpose: adds the time since the matching profile_start to a timer.
+//
+{
+    long long t;
+
+    if ( !Profiling ) return;
+    t = getTicks() - Timers[timer].started;
+    Timers[timer].calls++;
+    Timers[timer].total += t;
+    if ( t > Timers[timer].maxTime ) Timers[timer].maxTime = t;
+}
+
+//=============================================================================
+
+void profile_addTrials(int trials, int converged)
+//
+//  Input:   trials = number of Picard iterations used in a routing step
+//           converged = TRUE if the step converged
+//  Output:  none
+//  Purpose: updates the histogram of iterations used per routing step.
+//
+{
+    if ( !Profiling ) return;
+    Trials[MIN(trials, MAX_PROF_TRIALS)]++;
+    if ( !converged ) NonConverged++;
+}
+
+//=============================================================================
+
+void profile_addTrialCost(int type, int index)
+//
+//  Input:   type = NODE or LINK
+//           index = index of node or link
+//  Output:  none
+//  Purpose: charges a Picard iteration to a node that has not converged
+//           or to a link that must be recomputed.
+//
+{
+    TElemCost* cost = (type == NODE) ? NodeCost : LinkCost;
+    if ( cost ) cost[index].trials++;
+}
+
+//=============================================================================
+
+void profile_addFailureCost(int type, int index)
+//
+//  Input:   type = NODE or LINK
+//           index = index of node or link
+//  Output:  none
+//  Purpose: charges a non-converged routing step to a node or link.
+//
+{
+    TElemCost* cost = (type == NODE) ? NodeCost : LinkCost;
+    if ( cost ) cost[index].failures++;
+}
+
+//=============================================================================
+
+void profile_addStepCost(int type, int index, double tStep)
+//
+//  Input:   type = NODE or LINK
+//           index = index of node or link
+//           tStep = variable time step it set (sec)
+//  Output:  none
+//  Purpose: charges a Courant critical time step to a node or link.
+//
+{
+    TElemCost* cost = (type == NODE) ? NodeCost : LinkCost;
+    if ( cost == NULL ) return;
+    cost[index].critical++;
+    if ( tStep < CostStepLimit ) cost[index].smallStepTime += tStep;
+}
+
+//=============================================================================
+
+void profile_report()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the run time profile to the report file.
+//
+{
+    int       i;
+    long long steps = 0;
+    long long trials = 0;
+    double    runTime, t, bytes;
+    double    lookups, changes;
+    char      name[32];
+
+    if ( !Profiling || Frpt.file == NULL ) return;
+    runTime = (getTicks() - RunStart) / TicksPerSec;
+
+    WRITE("");
+    WRITE("****************");
+    WRITE("Run Time Profile");
+    WRITE("****************");
+    fprintf(Frpt.file,
+"\n  ---------------------------------------------------------------------"
+"\n                                    Total   Percent      Mean       Max"
+"\n  Routine                 Calls       sec    of Run      usec      usec"
+"\n  ---------------------------------------------------------------------");
+    for (i = 0; i < MAX_PROF_TIMERS; i++)
+    {
+        // --- routines called from within routing_execute are indented
+        t = Timers[i].total / TicksPerSec;
+        if ( i == PROF_RUNOFF || i == PROF_ROUTING || i == PROF_OUTPUT )
+            strcpy(name, TimerNames[i]);
+        else sprintf(name, "  %s", TimerNames[i]);
+        fprintf(Frpt.file, "\n  %-18s %10.0f %9.3f %9.2f %9.1f %9.1f",
+            name, (double)Timers[i].calls, t,
+            (runTime > 0.0) ? 100.0 * t / runTime : 0.0,
+            (Timers[i].calls > 0) ? 1.0e6 * t / Timers[i].calls : 0.0,
+            1.0e6 * Timers[i].maxTime / TicksPerSec);
+    }
+    fprintf(Frpt.file, "\n  %-29s %9.3f sec", "Total Run Time", runTime);
+
+    // --- throughput measures used to compare runs of the same model
+    for (i = 0; i <= MAX_PROF_TRIALS; i++)
+    {
+        steps += Trials[i];
+        trials += i * Trials[i];
+    }
+    bytes = output_getBytesSaved();
+    t = Timers[PROF_OUTPUT].total / TicksPerSec;
+    WRITE("");
+    fprintf(Frpt.file, "\n  Routing Steps per Second ..... %12.1f",
+        (runTime > 0.0) ? StepCount / runTime : 0.0);
+    if ( steps > 0 ) fprintf(Frpt.file,
+        "\n  Iterations per Step .......... %12.2f", (double)trials / steps);
+    fprintf(Frpt.file, "\n  Results Saved ................ %12.3f MB",
+        bytes / 1.0e6);
+    if ( t > 0.0 ) fprintf(Frpt.file,
+        "\n  Results Saved per Second ..... %12.3f MB", bytes / 1.0e6 / t);
+    getPumpLookups(&lookups, &changes);
+    if ( lookups > 0.0 )
+    {
+        fprintf(Frpt.file, "\n  Pump Curve Look-ups .......... %12.0f",
+            lookups);
+        fprintf(Frpt.file, "\n  Pump Segment Changes ......... %12.0f"
+            " (%.2f%%)", changes, 100.0 * changes / lookups);
+    }
+    if ( steps > 0 )
+    {
+        WRITE("");
+        fprintf(Frpt.file,
+"\n  Dynamic Wave Iterations per Step"
+"\n  --------------------------------"
+"\n  Iterations       Steps   Percent");
+        for (i = 1; i <= MAX_PROF_TRIALS; i++)
+        {
+            if ( Trials[i] == 0 ) continue;
+            fprintf(Frpt.file, "\n  %4d%s %15.0f %9.2f", i,
+                (i == MAX_PROF_TRIALS) ? "+" : " ", (double)Trials[i],
+                100.0 * Trials[i] / steps);
+        }
+        fprintf(Frpt.file, "\n  Not Converged %11.0f %9.2f",
+            (double)NonConverged, 100.0 * NonConverged / steps);
+    }
+    WRITE("");
+    if ( JsonFile ) writeJsonFile(runTime);
+    if ( Fcost ) writeCostFile();
+}
+
+//=============================================================================
+
+void profile_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: closes the profiler's files and frees its memory.
+//
+{
+    if ( JsonFile ) fclose(JsonFile);
+    if ( Fcost ) fclose(Fcost);
+    JsonFile = NULL;
+    Fcost = NULL;
+    FREE(NodeCost);
+    FREE(LinkCost);
+}
+
+//=============================================================================
+
+void writeJsonFile(double runTime)
+//
+//  Input:   runTime = total run time (sec)
+//  Output:  none
+//  Purpose: writes the run time profile to the PROFILE_FILE in JSON format.
+//
+{
+    int    i, n;
+    double lookups, changes;
+    FILE*  f = JsonFile;
+
+    fprintf(f, "{\n  \"runTime\": %.6f,\n  \"routingSteps\": %ld,"
+        "\n  \"resultBytes\": %.0f,\n  \"timers\": {", runTime, StepCount,
+        output_getBytesSaved());
+    for (i = 0; i < MAX_PROF_TIMERS; i++)
+    {
+        fprintf(f, "%s\n    \"%s\": {\"calls\": %.0f, \"total\": %.9f, "
+            "\"max\": %.9f}", (i > 0) ? "," : "", TimerKeys[i],
+            (double)Timers[i].calls, Timers[i].total / TicksPerSec,
+            Timers[i].maxTime / TicksPerSec);
+    }
+    fprintf(f, "\n  },\n  \"dynwave\": {\n    \"nonConverged\": %.0f,"
+        "\n    \"iterations\": [", (double)NonConverged);
+
+    // --- histogram entry i is the number of steps using i+1 iterations
+    //     (trailing empty bins are omitted)
+    n = MAX_PROF_TRIALS;
+    while ( n > 1 && Trials[n] == 0 ) n--;
+    for (i = 1; i <= n; i++)
+    {
+        fprintf(f, "%s%.0f", (i > 1) ? ", " : "", (double)Trials[i]);
+    }
+    getPumpLookups(&lookups, &changes);
+    fprintf(f, "]\n  },\n  \"pumpCurves\": {\"lookups\": %.0f, "
+        "\"segmentChanges\": %.0f}\n}\n", lookups, changes);
+}
+
+//=============================================================================
+
+void getPumpLookups(double* lookups, double* changes)
+//
+//  Input:   none
+//  Output:  lookups = number of pump curve look-ups made
+//           changes = number of look-ups that moved to another segment
+//  Purpose: totals the pump curve look-up counts of all pumps.
+//
+{
+    int k;
+
+    *lookups = 0.0;
+    *changes = 0.0;
+    for (k = 0; k < Nlinks[PUMP]; k++)
+    {
+        *lookups += (double)Pump[k].curve.lookups;
+        *changes += (double)Pump[k].curve.entryChanges;
+    }
+}
+
+//=============================================================================
+
+void writeCostFile()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the costs charged to each node and link to the
+//           COST_FILE in CSV format.
+//
+{
+    int i;
+
+    fprintf(Fcost, "Type,ID,Iterations,Failures,CriticalSteps,"
+        "SmallStepTime\n");
+    for (i = 0; i < Nobjects[NODE]; i++)
+    {
+        fprintf(Fcost, "NODE,%s,%ld,%ld,%ld,%.3f\n", Node[i].ID,
+            NodeCost[i].trials, NodeCost[i].failures, NodeCost[i].critical,
+            NodeCost[i].smallStepTime);
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        fprintf(Fcost, "LINK,%s,%ld,%ld,%ld,%.3f\n", Link[i].ID,
+            LinkCost[i].trials, LinkCost[i].failures, LinkCost[i].critical,
+            LinkCost[i].smallStepTime);
+    }
+}
+
+//=============================================================================
+
+long long getTicks()
+//
+//  Input:   none
+//  Output:  returns current reading of a monotonic clock
+//  Purpose: reads the high resolution clock used for profiling.
+//
+{
+#ifdef _WIN32
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+#endif
+}
@@ -22,6 +22,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <malloc.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "headers.h"
 #include "lid.h" 
 #include "hash.h"
@@ -40,6 +43,7 @@ const int    DEFAULT_MAXTRIALS = 8;       // Max. trials per time step
 //-----------------------------------------------------------------------------
 static HTtable* Htable[MAX_OBJ_TYPES]; // Hash tables for object ID names
 static char     MemPoolAllocated;      // TRUE if memory pool allocated 
+static double*  QualBlock;             // node & link quality state variables
 
 //-----------------------------------------------------------------------------
 //  External Functions (declared in funcs.h)
@@ -48,6 +52,7 @@ static char     MemPoolAllocated;      // TRUE if memory pool allocated
 //  project_close          (called from swmm_close in swmm5.c)
 //  project_readInput      (called from swmm_open in swmm5.c)
 //  project_readOption     (called from readOption in input.c)
+//  project_readCheckpoint (called from readOption in input.c)
 //  project_validate       (called from swmm_open in swmm5.c)
 //  project_init           (called from swmm_start in swmm5.c)
 //  project_addObject      (called from addObject in input.c)
@@ -161,6 +166,7 @@ void project_validate()
     {
         err = table_validate(&Tseries[i]);
         if ( err ) report_writeTseriesErrorMsg(err, &Tseries[i]);
+        else table_tseriesLoad(&Tseries[i]);
     }
 
     // --- validate hydrology objects
@@ -172,6 +178,7 @@ void project_validate()
     for ( i=0; i<Nobjects[GAGE]; i++ )     gage_validate(i);
     for ( i=0; i<Nobjects[AQUIFER]; i++ )  gwater_validateAquifer(i);
     for ( i=0; i<Nobjects[SUBCATCH]; i++ ) subcatch_validate(i);
+    raingrid_validate();
     for ( i=0; i<Nobjects[SNOWMELT]; i++ ) snow_validateSnowmelt(i);
 
     // --- compute geometry tables for each shape curve
@@ -194,6 +201,9 @@ void project_validate()
     for ( i=0; i<Nobjects[LINK]; i++) link_validate(i);
     for ( i=0; i<Nobjects[NODE]; i++) node_validate(i);
 
+    // --- share inlet data between culverts with identical inlets
+    culvert_createInlets();
+
     // --- adjust time steps if necessary
     if ( DryStep < WetStep )
     {
@@ -652,12 +662,96 @@ int project_readOption(char* s1, char* s2)
         sstrncpy(TempDir, s2, MAXFNAME);
         break;
 
+      // --- run time profiling (naming a profile file also turns it on)
+      case RUN_PROFILE:
+        m = findmatch(s2, NoYesWords);
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
+        Profiling = m;
+        break;
+
+      case PROFILE_FILE:
+        sstrncpy(ProfileFile, s2, MAXFNAME);
+        Profiling = TRUE;
+        break;
+
+      // --- file of costs charged to each node & link by dynamic wave
+      //     routing and the time step below which a step counts as small
+      case COST_FILE:
+        sstrncpy(CostFile, s2, MAXFNAME);
+        Profiling = TRUE;
+        break;
+
+      case COST_STEP_LIMIT:
+        if ( !getDouble(s2, &CostStepLimit) || CostStepLimit < 0.0 )
+            return error_setInpError(ERR_NUMBER, s2);
+        break;
+
+      // --- use tables of conduit normal & critical depth v. flow
+      case DEPTH_TABLES:
+        m = findmatch(s2, NoYesWords);
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
+        DepthTables = m;
+        break;
+
+      // --- how force main friction factors are evaluated
+      case FORCE_MAIN_FRICTION:
+        m = findmatch(s2, FrictionModeWords);
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
+        ForceMainFriction = m;
+        break;
+
+      // --- use tables of culvert inlet flow v. depth
+      case CULVERT_TABLES:
+        m = findmatch(s2, NoYesWords);
+        if ( m < 0 ) return error_setInpError(ERR_KEYWORD, s2);
+        CulvertTables = m;
+        break;
+
+      // --- number of threads used to route water quality
+      //     (only one is used if the engine was built without OpenMP)
+      case THREADS:
+        if ( !getInt(s2, &m) || m < 1 )
+            return error_setInpError(ERR_NUMBER, s2);
+#ifdef _OPENMP
+        NumThreads = MIN(m, omp_get_num_procs());
+#else
+        NumThreads = 1;
+#endif
+        break;
+
+      // --- CHECKPOINT has more than one value (see project_readCheckpoint)
+      case CHECKPOINT:
+        return error_setInpError(ERR_ITEMS, "");
     }
     return 0;
 }
 
 //=============================================================================
 
+int project_readCheckpoint(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns error code
+//  Purpose: reads the CHECKPOINT option.
+//
+//  Format of data is:
+//    CHECKPOINT  EVERY  days  fileName
+//
+{
+    double days;
+
+    if ( ntoks < 4 ) return error_setInpError(ERR_ITEMS, "");
+    if ( !match(tok[1], w_EVERY) ) return error_setInpError(ERR_KEYWORD, tok[1]);
+    if ( !getDouble(tok[2], &days) || days <= 0.0 )
+        return error_setInpError(ERR_NUMBER, tok[2]);
+    CheckpointDays = days;
+    sstrncpy(CheckpointFile, tok[3], MAXFNAME);
+    return 0;
+}
+
+//=============================================================================
+
 void initPointers()
 //
 //  Input:   none
@@ -677,6 +771,7 @@ void initPointers()
     Orifice  = NULL;
     Weir     = NULL;
     Outlet   = NULL;
+    QualBlock = NULL;
     Pollut   = NULL;
     Landuse  = NULL;
     Pattern  = NULL;
@@ -704,6 +799,9 @@ void setDefaults()
    // Project title & temp. file path
    for (i = 0; i < MAXTITLE; i++) strcpy(Title[i], "");
    strcpy(TempDir, "");
+   strcpy(ProfileFile, "");
+   strcpy(CostFile, "");
+   strcpy(CheckpointFile, "");
 
    // Interface files
    Frain.mode      = SCRATCH_FILE;     // Use scratch rainfall file
@@ -734,6 +832,7 @@ void setDefaults()
    InertDamping    = SOME;             // Partial inertial damping
    NormalFlowLtd   = BOTH;             // Default normal flow limitation
    ForceMainEqn    = H_W;              // Hazen-Williams eqn. for force mains
+   ForceMainFriction = FRIC_EXACT;     // Compute force main friction factors
    LinkOffsets     = DEPTH_OFFSET;     // Use depth for link offsets
    LengtheningStep = 0;                // No lengthening of conduits
    CourantFactor   = 0.0;              // No variable time step 
@@ -754,6 +853,12 @@ void setDefaults()
    HeadTol         = 0.0;              // Force use of default head tolerance
    SysFlowTol      = 0.05;             // System flow tolerance for steady state
    LatFlowTol      = 0.05;             // Lateral flow tolerance for steady state
+   Profiling       = FALSE;            // No run time profile
+   CostStepLimit   = 1.0;              // Small time step limit (secs)
+   DepthTables     = FALSE;            // Compute conduit normal & crit. depths
+   CulvertTables   = FALSE;            // Solve culvert inlet flows
+   NumThreads      = 1;                // Route water quality serially
+   CheckpointDays  = 0.0;              // No checkpoints
 
    // Deprecated options
    SlopeWeighting  = TRUE;             // Use slope weighting 
@@ -884,7 +989,7 @@ void createObjects()
 //        project_readInput().
 //
 {
-    int j, k;
+    int j, k, np;
 
     // --- allocate memory for each category of object
     if ( ErrorCode ) return;
@@ -934,10 +1039,23 @@ void createObjects()
         Subcatch[j].pondedQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
         Subcatch[j].totalLoad  = (double *) calloc(Nobjects[POLLUT], sizeof(double));
     }
+
+    // --- node & link concentrations share one block in which each
+    //     object's pollutants are contiguous and the objects follow
+    //     one another in index order (new concentrations of all nodes,
+    //     old ones of all nodes, then the same for links)
+    np = Nobjects[POLLUT];
+    if ( np > 0 ) QualBlock = (double *) calloc(2 * np *
+        (Nobjects[NODE] + Nobjects[LINK]), sizeof(double));
     for (j = 0; j < Nobjects[NODE]; j++)
     {
-        Node[j].oldQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
-        Node[j].newQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
+        Node[j].newQual = NULL;
+        Node[j].oldQual = NULL;
+        if ( QualBlock )
+        {
+            Node[j].newQual = QualBlock + j * np;
+            Node[j].oldQual = QualBlock + (Nobjects[NODE] + j) * np;
+        }
         Node[j].extInflow = NULL;
         Node[j].dwfInflow = NULL;
         Node[j].rdiiInflow = NULL;
@@ -945,8 +1063,14 @@ void createObjects()
     }
     for (j = 0; j < Nobjects[LINK]; j++)
     {
-        Link[j].oldQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
-        Link[j].newQual = (double *) calloc(Nobjects[POLLUT], sizeof(double));
+        Link[j].newQual = NULL;
+        Link[j].oldQual = NULL;
+        if ( QualBlock )
+        {
+            k = (2 * Nobjects[NODE] + j) * np;
+            Link[j].newQual = QualBlock + k;
+            Link[j].oldQual = QualBlock + k + Nobjects[LINK] * np;
+        }
 	    Link[j].totalLoad = (double *) calloc(Nobjects[POLLUT], sizeof(double));
     }
 
@@ -1062,8 +1186,8 @@ void deleteObjects()
         FREE(Subcatch[j].landFactor);
         FREE(Subcatch[j].groundwater);
 		gwater_deleteFlowExpression(j);
-        FREE(Subcatch[j].snowpack);
     }
+    snow_freeSnowpacks();
 
     // --- free memory for buildup/washoff functions
     if ( Landuse ) for (j = 0; j < Nobjects[LANDUSE]; j++)
@@ -1081,17 +1205,28 @@ void deleteObjects()
         FREE(Subcatch[j].pondedQual);
         FREE(Subcatch[j].totalLoad);
     }
-    if ( Node ) for (j = 0; j < Nobjects[NODE]; j++)
-    {
-        FREE(Node[j].oldQual);
-        FREE(Node[j].newQual);
-    }
     if ( Link ) for (j = 0; j < Nobjects[LINK]; j++)
     {
-        FREE(Link[j].oldQual);
-        FREE(Link[j].newQual);
 	    FREE(Link[j].totalLoad);
     }
+    FREE(QualBlock);
+
+    // --- free memory for custom shape geometry tables
+    if ( Shape ) for (j = 0; j < Nobjects[SHAPE]; j++) shape_delete(&Shape[j]);
+
+    // --- free memory for conduit normal & critical depth tables
+    if ( Conduit ) for (j = 0; j < Nlinks[CONDUIT]; j++)
+    {
+        FREE(Conduit[j].yNormTbl.y);
+        FREE(Conduit[j].yCritTbl.y);
+    }
+
+    // --- free memory for pump curve arrays
+    if ( Pump ) for (j = 0; j < Nlinks[PUMP]; j++)
+    {
+        FREE(Pump[j].curve.x);
+        FREE(Pump[j].curve.y);
+    }
 
     // --- free memory used for rainfall infiltration
     infil_delete();
@@ -1123,8 +1258,9 @@ void deleteObjects()
     if ( Curve ) for (j = 0; j < Nobjects[CURVE]; j++)
         table_deleteEntries(&Curve[j]);
 
-    // --- delete cross section transects
+    // --- delete cross section transects & culvert inlets
     transect_delete();
+    culvert_deleteInlets();
 
     // --- delete control rules
     controls_delete();
@@ -1132,6 +1268,9 @@ void deleteObjects()
     // --- delete LIDs
     lid_delete();
 
+    // --- delete rainfall grids
+    raingrid_delete();
+
     // --- now free each major category of object
     FREE(Gage);
     FREE(Subcatch);
@@ -8,32 +8,59 @@
 //
 //   Water quality routing functions.
 //
+//   When the THREADS option is above 1 the routing is split into
+//   phases that each loop over independent nodes or links in parallel.
+//   Rather than each link adding its mass outflow to its downstream node,
+//   each node gathers the outflows of its links in link index order, and
+//   mass lost to reactions is saved for each node and link and added to
+//   the mass balance in index order after each phase. Nodes that have
+//   treatment functions are routed serially in that pass. The results are
+//   therefore the same for any number of threads and match a serial run.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static int     Parallel;          // TRUE if quality is routed in parallel
+static int*    NodeLinkStart;     // start of each node's entries in NodeLinks
+static int*    NodeLinks;         // links joined to each node (index order)
+static double* NodeReacted;       // mass reacted in each node by pollutant
+static double* LinkReacted;       // mass reacted in each link by pollutant
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //  qualrout_init            (called by swmm_start)
 //  qualrout_execute         (called by routing_execute)
+//  qualrout_close           (called by routing_close)
 
 //-----------------------------------------------------------------------------
 //  Function declarations
 //-----------------------------------------------------------------------------
+static int   createNodeLinks(void);
+static void  executeParallel(double tStep);
 static void  findLinkMassFlow(int i, double tStep);
+static void  findLinkLoad(int i, double tStep);
+static void  gatherNodeMassFlow(int j);
+static void  updateNodeQual(int j, double tStep, double* reacted);
 static void  findNodeQual(int j);
-static void  findLinkQual(int i, double tStep);
-static void  findSFLinkQual(int i, double tStep);
-static void  findStorageQual(int j, double tStep);
+static void  findLinkQual(int i, double tStep, double* reacted);
+static void  findSFLinkQual(int i, double tStep, double* reacted);
+static void  findStorageQual(int j, double tStep, double* reacted);
 static void  updateHRT(int j, double v, double q, double tStep);
-static double getReactedQual(int p, double c, double v1, double tStep);
+static double getReactedQual(int p, double c, double v1, double tStep,
+              double* reacted);
 static double getMixedQual(double c, double v1, double wIn, double qIn,
               double tStep);
+static void  addReactedMass(int p, double w, double* reacted);
 
 
 //=============================================================================
@@ -71,6 +98,79 @@ void    qualrout_init()
             Link[i].newQual[p] = c;
         }
     }
+
+    // --- allocate the work arrays used to route quality in parallel
+    //     (quality is routed serially if memory runs out)
+    qualrout_close();
+    Parallel = FALSE;
+    if ( NumThreads > 1 && Nobjects[POLLUT] > 0 )
+    {
+        Parallel = createNodeLinks();
+        NodeReacted = (double *) calloc(Nobjects[NODE] * Nobjects[POLLUT],
+                                        sizeof(double));
+        LinkReacted = (double *) calloc(Nobjects[LINK] * Nobjects[POLLUT],
+                                        sizeof(double));
+        if ( !Parallel || NodeReacted == NULL || LinkReacted == NULL )
+        {
+            qualrout_close();
+            Parallel = FALSE;
+        }
+    }
+}
+
+//=============================================================================
+
+void qualrout_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the work arrays used to route quality in parallel.
+//
+{
+    FREE(NodeLinkStart);
+    FREE(NodeLinks);
+    FREE(NodeReacted);
+    FREE(LinkReacted);
+}
+
+//=============================================================================
+
+int createNodeLinks()
+//
+//  Input:   none
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: lists the links joined to each node in order of link index.
+//
+{
+    int i, j, n1, n2;
+
+    NodeLinkStart = (int *) calloc(Nobjects[NODE] + 1, sizeof(int));
+    NodeLinks = (int *) calloc(2 * Nobjects[LINK] + 1, sizeof(int));
+    if ( NodeLinkStart == NULL || NodeLinks == NULL ) return FALSE;
+
+    // --- count the links at each node and make the counts cumulative
+    //     (NodeLinkStart[j] then marks the end of node j's list)
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        n1 = Link[i].node1;
+        n2 = Link[i].node2;
+        NodeLinkStart[n1]++;
+        if ( n2 != n1 ) NodeLinkStart[n2]++;
+    }
+    for (j = 1; j < Nobjects[NODE]; j++)
+        NodeLinkStart[j] += NodeLinkStart[j-1];
+    NodeLinkStart[Nobjects[NODE]] = NodeLinkStart[Nobjects[NODE]-1];
+
+    // --- fill each list from its end, taking links in reverse order, so
+    //     that NodeLinkStart[j] ends up marking the start of node j's list
+    for (i = Nobjects[LINK] - 1; i >= 0; i--)
+    {
+        n1 = Link[i].node1;
+        n2 = Link[i].node2;
+        NodeLinks[--NodeLinkStart[n1]] = i;
+        if ( n2 != n1 ) NodeLinks[--NodeLinkStart[n2]] = i;
+    }
+    return TRUE;
 }
 
 //=============================================================================
@@ -84,38 +184,114 @@ void qualrout_execute(double tStep)
 //
 {
     int    i, j;
-    double qIn, vAvg;
+
+    if ( Parallel )
+    {
+        executeParallel(tStep);
+        return;
+    }
 
     // --- find mass flow each link contributes to its downstream node
     for ( i = 0; i < Nobjects[LINK]; i++ ) findLinkMassFlow(i, tStep);
 
     // --- find new water quality concentration at each node  
+    for (j = 0; j < Nobjects[NODE]; j++) updateNodeQual(j, tStep, NULL);
+
+    // --- find new water quality in each link
+    for ( i=0; i<Nobjects[LINK]; i++ ) findLinkQual(i, tStep, NULL);
+}
+
+//=============================================================================
+
+void executeParallel(double tStep)
+//
+//  Input:   tStep = routing time step (sec)
+//  Output:  none
+//  Purpose: routes water quality constituents through the drainage
+//           network over the current time step using NumThreads threads.
+//
+{
+    int     i, j, p;
+    int     np = Nobjects[POLLUT];
+    double* reacted;
+
+    // --- add the mass each link delivers over the step to its load
+#pragma omp parallel for num_threads(NumThreads) schedule(static)
+    for (i = 0; i < Nobjects[LINK]; i++) findLinkLoad(i, tStep);
+
+    // --- gather the mass flow into each node from its links and find
+    //     new quality at nodes without treatment
+#pragma omp parallel for num_threads(NumThreads) schedule(static)
     for (j = 0; j < Nobjects[NODE]; j++)
     {
-        // --- get node inflow and average volume
-        qIn = Node[j].inflow;
-        vAvg = (Node[j].oldVolume + Node[j].newVolume) / 2.0;
-        
-        // --- save inflow concentrations if treatment applied
-        if ( Node[j].treatment )
+        gatherNodeMassFlow(j);
+        if ( Node[j].treatment == NULL )
         {
-            if ( qIn < ZERO ) qIn = 0.0;
-            treatmnt_setInflow(qIn, Node[j].newQual);
+            memset(&NodeReacted[j*np], 0, np * sizeof(double));
+            updateNodeQual(j, tStep, &NodeReacted[j*np]);
         }
-       
-        // --- find new quality at the node 
-        if ( Node[j].type == STORAGE || Node[j].oldVolume > FUDGE )
+    }
+
+    // --- add the mass reacted at each node to the mass balance and
+    //     route quality through nodes with treatment, in node order
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        if ( Node[j].treatment ) updateNodeQual(j, tStep, NULL);
+        else
         {
-            findStorageQual(j, tStep);
+            reacted = &NodeReacted[j*np];
+            for (p = 0; p < np; p++) massbal_addReactedMass(p, reacted[p]);
         }
-        else findNodeQual(j);
-
-        // --- apply treatment to new quality values
-        if ( Node[j].treatment ) treatmnt_treat(j, qIn, vAvg, tStep);
     }
 
     // --- find new water quality in each link
-    for ( i=0; i<Nobjects[LINK]; i++ ) findLinkQual(i, tStep);
+#pragma omp parallel for num_threads(NumThreads) schedule(static)
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        memset(&LinkReacted[i*np], 0, np * sizeof(double));
+        findLinkQual(i, tStep, &LinkReacted[i*np]);
+    }
+    for (i = 0; i < Nobjects[LINK]; i++)
+    {
+        reacted = &LinkReacted[i*np];
+        for (p = 0; p < np; p++) massbal_addReactedMass(p, reacted[p]);
+    }
+}
+
+//=============================================================================
+
+void updateNodeQual(int j, double tStep, double* reacted)
+//
+//  Input:   j = node index
+//           tStep = routing time step (sec)
+//           reacted = array that saves mass reacted (or NULL)
+//  Output:  none
+//  Purpose: finds new water quality concentration at a node once the
+//           mass inflows from its links have been added to it.
+//
+{
+    double qIn, vAvg;
+
+    // --- get node inflow and average volume
+    qIn = Node[j].inflow;
+    vAvg = (Node[j].oldVolume + Node[j].newVolume) / 2.0;
+        
+    // --- save inflow concentrations if treatment applied
+    if ( Node[j].treatment )
+    {
+        if ( qIn < ZERO ) qIn = 0.0;
+        treatmnt_setInflow(qIn, Node[j].newQual);
+    }
+       
+    // --- find new quality at the node 
+    if ( Node[j].type == STORAGE || Node[j].oldVolume > FUDGE )
+    {
+        findStorageQual(j, tStep, reacted);
+    }
+    else findNodeQual(j);
+
+    // --- apply treatment to new quality values
+    if ( Node[j].treatment ) treatmnt_treat(j, qIn, vAvg, tStep);
 }
 
 //=============================================================================
@@ -185,6 +361,60 @@ void findLinkMassFlow(int i, double tStep)
 
 //=============================================================================
 
+void findLinkLoad(int i, double tStep)
+//
+//  Input:   i = link index
+//           tStep = time step (sec)
+//  Output:  none
+//  Purpose: adds constituent mass flow out of a link over the time step to
+//           the link's total load.
+//
+{
+    int    p;
+    double qLink = fabs(Link[i].newFlow);
+    double* load = Link[i].totalLoad;
+    double* c = Link[i].oldQual;
+
+    for (p = 0; p < Nobjects[POLLUT]; p++) load[p] += qLink * c[p] * tStep;
+}
+
+//=============================================================================
+
+void gatherNodeMassFlow(int j)
+//
+//  Input:   j = node index
+//  Output:  none
+//  Purpose: adds the constituent mass flow out of each link that
+//           discharges into a node to the accumulation at the node.
+//
+//  Note:    links are visited in index order so that the sums are the
+//           same as those made by findLinkMassFlow.
+{
+    int    i, k, p;
+    double qLink;
+    double* w = Node[j].newQual;
+    double* c;
+
+    for (k = NodeLinkStart[j]; k < NodeLinkStart[j+1]; k++)
+    {
+        // --- skip links whose downstream node is not node j
+        i = NodeLinks[k];
+        qLink = Link[i].newFlow;
+        if ( qLink < 0.0 )
+        {
+            if ( Link[i].node1 != j ) continue;
+        }
+        else if ( Link[i].node2 != j ) continue;
+        qLink = fabs(qLink);
+
+        // --- add link's mass flow to the node's accumulation
+        c = Link[i].oldQual;
+        for (p = 0; p < Nobjects[POLLUT]; p++) w[p] += qLink * c[p];
+    }
+}
+
+//=============================================================================
+
 void findNodeQual(int j)
 //
 //  Input:   j = node index
@@ -211,10 +441,11 @@ void findNodeQual(int j)
 
 //=============================================================================
 
-void findLinkQual(int i, double tStep)
+void findLinkQual(int i, double tStep, double* reacted)
 //
 //  Input:   i = link index
 //           tStep = routing time step (sec)
+//           reacted = array that saves mass reacted (or NULL)
 //  Output:  none
 //  Purpose: finds new quality in a link at end of the current time step.
 //
@@ -258,7 +489,7 @@ void findLinkQual(int i, double tStep)
     // --- Steady Flow routing requires special treatment
     if ( RouteModel == SF )
     {
-        findSFLinkQual(i, tStep);
+        findSFLinkQual(i, tStep, reacted);
         return;
     }
 
@@ -283,7 +514,7 @@ void findLinkQual(int i, double tStep)
     {
         // --- determine mass lost to first order decay
         c1 = Link[i].oldQual[p];
-        c2 = getReactedQual(p, c1, v1, tStep);
+        c2 = getReactedQual(p, c1, v1, tStep, reacted);
 
         // --- mix inflow to conduit with previous contents
         wIn = Node[j].newQual[p]*qIn;
@@ -296,10 +527,11 @@ void findLinkQual(int i, double tStep)
 
 //=============================================================================
 
-void  findSFLinkQual(int i, double tStep)
+void  findSFLinkQual(int i, double tStep, double* reacted)
 //
 //  Input:   i = link index
 //           tStep = routing time step (sec)
+//           reacted = array that saves mass reacted (or NULL)
 //  Output:  none
 //  Purpose: finds new quality in a link at end of the current time step for
 //           Steady Flow routing.
@@ -324,7 +556,7 @@ void  findSFLinkQual(int i, double tStep)
             c2 = c1 * exp(-Pollut[p].kDecay * t);
             c2 = MAX(0.0, c2);
             lossRate = (c1 - c2) * Link[i].newFlow;
-            massbal_addReactedMass(p, lossRate);
+            addReactedMass(p, lossRate, reacted);
         }
         Link[i].newQual[p] = c2;
     }
@@ -332,10 +564,11 @@ void  findSFLinkQual(int i, double tStep)
 
 //=============================================================================
 
-void  findStorageQual(int j, double tStep)
+void  findStorageQual(int j, double tStep, double* reacted)
 //
 //  Input:   j = node index
 //           tStep = routing time step (sec)
+//           reacted = array that saves mass reacted (or NULL)
 //  Output:  none
 //  Purpose: finds new quality in a node with storage volume.
 //  
@@ -368,7 +601,7 @@ void  findStorageQual(int j, double tStep)
         if ( Node[j].treatment == NULL ||
              Node[j].treatment[p].equation == NULL )
         {
-            c1 = getReactedQual(p, c1, v1, tStep);
+            c1 = getReactedQual(p, c1, v1, tStep, reacted);
         }
 
         // --- mix inflow with current contents (mass inflow rate was
@@ -403,12 +636,14 @@ void updateHRT(int j, double v, double q, double tStep)
 
 //=============================================================================
 
-double getReactedQual(int p, double c, double v1, double tStep)
+double getReactedQual(int p, double c, double v1, double tStep,
+                      double* reacted)
 //
 //  Input:   p = pollutant index
 //           c = initial concentration (mass/ft3)
 //           v1 = initial volume (ft3)
 //           tStep = time step (sec)
+//           reacted = array that saves mass reacted (or NULL)
 //  Output:  none
 //  Purpose: applies a first order reaction to a pollutant over a given
 //           time step.
@@ -421,8 +656,24 @@ double getReactedQual(int p, double c, double v1, double tStep)
     c2 = c * (1.0 - kDecay * tStep);
     c2 = MAX(0.0, c2);
     lossRate = (c - c2) * v1 / tStep;
-    massbal_addReactedMass(p, lossRate);
+    addReactedMass(p, lossRate, reacted);
     return c2;
 }
 
 //=============================================================================
+
+void addReactedMass(int p, double w, double* reacted)
+//
+//  Input:   p = pollutant index
+//           w = rate of mass reacted (mass/sec)
+//           reacted = array that saves mass reacted (or NULL)
+//  Output:  none
+//  Purpose: adds mass reacted to the routing totals or, when quality is
+//           routed in parallel, saves it until it can be added in order.
+//
+{
+    if ( reacted ) reacted[p] += w;
+    else massbal_addReactedMass(p, w);
+}
+
+//=============================================================================
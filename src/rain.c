@@ -25,22 +25,47 @@
 //                        StaID  Year  Month  Day  Hour  Minute  Rainfall
 //
 //   The layout of the SWMM binary rainfall interface file is:
-//     File stamp ("SWMM5-RAIN") (10 bytes)
+//     File stamp ("SWMM5-RNV2") (10 bytes)
 //     Number of SWMM rain gages in file (4-byte int)
+//     Number of rain records per block of the date index (4-byte int)
+//     Hash of the rain data files & gage parameters used (8-byte int)
 //     Repeated for each rain gage:
-//       recording station ID (not SWMM rain gage ID) (MAXMSG+1 (=80) bytes)
+//       recording station ID (not SWMM rain gage ID) (MAXMSG+1 bytes)
 //       gage recording interval (seconds) (4-byte int)
-//       starting byte of rain data in file (4-byte int)
-//       ending byte+1 of rain data in file (4-byte int)
+//       starting byte of rain data in file (8-byte int)
+//       ending byte+1 of rain data in file (8-byte int)
+//       starting byte of date index in file (8-byte int)
+//       number of entries in date index (4-byte int)
+//       dates of first & last rain periods (8-byte doubles)
+//       number of periods with rain, missing & malfunctioning (4-byte ints)
 //     For each gage:
 //       For each time period with non-zero rain:
 //         Date/time for start of period (8-byte double)
 //         Rain depth (inches) (4-byte float)
+//       For each block of rain records:
+//         Date/time of the block's first record (8-byte double)
+//
+//   Files written by earlier versions (stamp "SWMM5-RAIN") have no date
+//   index, no index block size, no hash, no summary statistics, and 4-byte
+//   starting and ending bytes, and can still be used.
+//
+//   Each gage reads its records through a buffer that holds a block of
+//   them at a time. The date index lets a run that starts part way through
+//   a gage's record skip over the records before its start date.
+//
+//   When the file is created each gage's data file is read into a buffer
+//   of its own, as many gages at a time as the THREADS option allows, and
+//   the buffers are then written to the file in gage order, so the file is
+//   the same for any number of threads. The hash is written once all gages
+//   were added; a saved file whose hash matches the gages' current data
+//   files is used as is instead of being created again.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
+#include <ctype.h>
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -52,54 +77,115 @@ enum RainFileFormat {UNKNOWN_FORMAT, NWS_TAPE, NWS_SPACE_DELIMITED,
 enum ConditionCodes {NO_CONDITION, ACCUMULATED_PERIOD, DELETED_PERIOD,
                      MISSING_PERIOD};
 
+#define RAIN_RECORD_SIZE  12      // bytes per rain record (date & depth)
+#define RAIN_BLOCK_SIZE   1024    // rain records per date index block
+#define RAIN_READ_BUFFER  65536   // bytes buffered when reading a data file
+
+static const char FileStamp1[] = "SWMM5-RAIN";   // stamp of original format
+static const char FileStamp2[] = "SWMM5-RNV2";   // stamp of indexed format
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    long long  start;             // file position of first buffered record
+    int        count;             // number of buffered records
+    int        size;              // number of records buffer can hold
+    char*      buffer;            // buffered records
+    int        blockSize;         // records per date index block
+    int        nIndex;            // number of date index entries
+    DateTime*  index;             // date of first record of each block
+}  TRainCursor;
+
+typedef struct                    // a gage's header entry in the file
+{
+    char       staID[MAXMSG+1];   // recording station ID
+    int        interval;          // recording interval (sec)
+    long long  startPos;          // starting byte of rain data
+    long long  endPos;            // ending byte+1 of rain data
+    long long  indexPos;          // starting byte of date index
+    int        nIndex;            // number of date index entries
+    TRainStats stats;             // summary of gage's rain data
+}  TRainEntry;
+
+typedef struct                    // reader of a gage's rainfall data file
+{
+    int        gage;              // index of rain gage
+    int        error;             // error code (0 if none)
+    char*      errLine;           // data file line with error
+    int        fileFormat;        // data file format code
+    int        hdrLines;          // number of header lines in data file
+    int        hasStationName;    // true if data contains station name
+    int        condition;         // rainfall condition code
+    int        timeOffset;        // time offset of rainfall reading (sec)
+    int        dataOffset;        // start of data on line of input
+    int        valueOffset;       // start of rain value on input line
+    int        rainType;          // rain measurement type code
+    int        interval;          // rain measurement interval (sec)
+    double     unitsFactor;       // units conversion factor
+    float      rainAccum;         // rainfall depth accumulation
+    char*      stationID;         // station ID appearing in rain file
+    DateTime   accumStartDate;    // date when accumulation begins
+    DateTime   previousDate;      // date of previous rainfall record
+    TRainStats stats;             // summary of rain data read
+    long       count;             // number of rain records read
+    long       size;              // number of records buffer can hold
+    char*      records;           // rain records read
+    int        sorted;            // TRUE if records' dates are in order
+    DateTime   lastDate;          // date of last rain record read
+}  TRainReader;
+
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
-TRainStats RainStats;                  // see objects.h for definition
-int        Condition;                  // rainfall condition code
-int        TimeOffset;                 // time offset of rainfall reading (sec)
-int        DataOffset;                 // start of data on line of input
-int        ValueOffset;                // start of rain value on input line
-int        RainType;                   // rain measurement type code
-int        Interval;                   // rain measurement interval (sec)
-double     UnitsFactor;                // units conversion factor
-float      RainAccum;                  // rainfall depth accumulation
-char       *StationID;                 // station ID appearing in rain file
-DateTime   AccumStartDate;             // date when accumulation begins
-DateTime   PreviousDate;               // date of previous rainfall record 
-int        GageIndex;                  // index of rain gage analyzed
-int        hasStationName;             // true if data contains station name
+static TRainCursor* Cursors;          // rain file cursor for each gage
 
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
-//  rain_open   (called by swmm_start in swmm5.c)
-//  rain_close  (called by swmm_end in swmm5.c)
+//  rain_open        (called by swmm_start in swmm5.c)
+//  rain_close       (called by swmm_end in swmm5.c)
+//  rain_readRecord  (called by getFirstRainfall & getNextRainfall in gage.c)
+//  rain_findDate    (called by getFirstRainfall in gage.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
-static void createRainFile(int count);
-static int  rainFileConflict(int i);            
+static void createRainFile(int count, unsigned long long hash);
+static int  rainFileConflict(int i);
+static unsigned long long findSourceHash(int count);
+static unsigned long long hashGageSource(int i);
+static int  rainFileIsCurrent(int count, unsigned long long hash);
+static void reportSavedStats(void);
 static void initRainFile(void);
-static int  findGageInFile(int i, int kount);
-static int  addGageToRainFile(int i);
-static int  findFileFormat(FILE *f, int i, int *hdrLines);
-static int  findNWSOnlineFormat(FILE *f, char *line);
-static void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-            DateTime day2);
-static int  readNWSLine(char *line, int fileFormat, DateTime day1,
+static int  findGageInFile(int i, int kount, int version, int blockSize);
+static void readEntry(TRainEntry* e, int version);
+static void writeEntry(TRainEntry* e);
+static int  readIndex(int i, long long indexPos, int nIndex, int blockSize);
+static void readGageFile(TRainReader* r);
+static void saveGageData(TRainReader* r, long long* entryPos,
+            long long* dataPos);
+static int  findFileFormat(FILE *f, TRainReader* r);
+static int  findNWSOnlineFormat(FILE *f, char *line, TRainReader* r);
+static void readFile(TRainReader* r, FILE *f);
+static int  readNWSLine(TRainReader* r, char *line, int fileFormat,
+            DateTime day1, DateTime day2);
+static int  readCMCLine(TRainReader* r, char *line, int fileFormat,
+            DateTime day1, DateTime day2);
+static int  readStdLine(TRainReader* r, char *line, DateTime day1,
             DateTime day2);
-static int  readCMCLine(char *line, int fileFormat, DateTime day1,
-            DateTime day2);
-static int  readStdLine(char *line, DateTime day1, DateTime day2);
-static void saveAccumRainfall(DateTime date1, int hour, int minute, long v);
-static void saveRainfall(DateTime date1, int hour, int minute, float x,
-            char isMissing);
-static void setCondition(char flag);
+static void saveAccumRainfall(TRainReader* r, DateTime date1, int hour,
+            int minute, long v);
+static void saveRainfall(TRainReader* r, DateTime date1, int hour,
+            int minute, float x, char isMissing);
+static void addRainRecord(TRainReader* r, DateTime date, float x);
+static int  fillBuffer(int i, long long pos);
+static void setCondition(TRainReader* r, char flag);
 static int  getNWSInterval(char *elemType);
-static int  parseStdLine(char *line, int *year, int *month, int *day,
-            int *hour, int *minute, float *value);
+static int  parseStdLine(char *line, char *staID, int *year, int *month,
+            int *day, int *hour, int *minute, float *value);
+static int  scanFields(char *s, const char *fmt, ...);
 
 //=============================================================================
 
@@ -112,6 +198,8 @@ void  rain_open(void)
 {
     int i;
     int count;
+    int isCurrent = FALSE;
+    unsigned long long hash = 0;
 
     // --- see how many gages get their data from a file
     count = 0;
@@ -120,6 +208,7 @@ void  rain_open(void)
         if ( Gage[i].dataSource == RAIN_FILE ) count++;
     }
     Frain.file = NULL;
+    Cursors = NULL;
     if ( count == 0 )
     {
         Frain.mode = NO_FILE;
@@ -146,7 +235,12 @@ void  rain_open(void)
         break;
 
       case SAVE_FILE:
-        if ( (Frain.file = fopen(Frain.name, "w+b")) == NULL)
+        // --- a file saved from the same data files is used as is
+        hash = findSourceHash(count);
+        isCurrent = rainFileIsCurrent(count, hash);
+        if ( isCurrent ) Frain.file = fopen(Frain.name, "r+b");
+        else             Frain.file = fopen(Frain.name, "w+b");
+        if ( Frain.file == NULL )
         {
             report_writeErrorMsg(ERR_RAIN_FILE_OPEN, Frain.name);
             return;
@@ -155,11 +249,15 @@ void  rain_open(void)
     }
 
     // --- create new rain file if required
-    if ( Frain.mode == SCRATCH_FILE || Frain.mode == SAVE_FILE )
+    if ( Frain.mode == SCRATCH_FILE ||
+       ( Frain.mode == SAVE_FILE && !isCurrent ) )
     {
-        createRainFile(count);
+        createRainFile(count, hash);
     }
 
+    // --- report the summary saved with a file that is used as is
+    if ( isCurrent ) reportSavedStats();
+
     // --- initialize rain file
     if ( Frain.mode != NO_FILE ) initRainFile();
 
@@ -176,6 +274,17 @@ void rain_close(void)
 //  Purpose: closes rain interface file and RDII processor.
 //
 {
+    int i;
+
+    if ( Cursors )
+    {
+        for (i = 0; i < Nobjects[GAGE]; i++)
+        {
+            FREE(Cursors[i].buffer);
+            FREE(Cursors[i].index);
+        }
+        FREE(Cursors);
+    }
     if ( Frain.file )
     {
         fclose(Frain.file);
@@ -187,69 +296,158 @@ void rain_close(void)
 
 //=============================================================================
 
-void createRainFile(int count)
+int rain_readRecord(int j, DateTime* date, float* depth)
+//
+//  Input:   j = rain gage index
+//  Output:  date = start date of rain period
+//           depth = rain depth over period (inches)
+//           returns TRUE if a record was read, FALSE if at end of gage's data
+//  Purpose: reads the rain record at a gage's current position in the rain
+//           interface file and advances the position to the next record.
+//
+{
+    TRainCursor* cursor;
+    long long    pos = Gage[j].currentFilePos;
+    char*        p;
+
+    if ( !Frain.file || !Cursors || pos >= Gage[j].endFilePos ) return FALSE;
+
+    // --- refill cursor's buffer if position lies outside of it
+    cursor = &Cursors[j];
+    if ( pos < cursor->start ||
+         pos >= cursor->start + (long long)cursor->count * RAIN_RECORD_SIZE )
+    {
+        if ( !fillBuffer(j, pos) ) return FALSE;
+    }
+
+    // --- retrieve record from buffer
+    p = cursor->buffer + (pos - cursor->start);
+    memcpy(date, p, sizeof(DateTime));
+    memcpy(depth, p + sizeof(DateTime), sizeof(float));
+    Gage[j].currentFilePos = pos + RAIN_RECORD_SIZE;
+    return TRUE;
+}
+
+//=============================================================================
+
+long long rain_findDate(int j, DateTime t)
+//
+//  Input:   j = rain gage index
+//           t = a calendar date/time
+//  Output:  returns file position of gage's last non-zero rain record
+//           dated on or before t, or -1 if there is none or the gage's
+//           data has no date index
+//  Purpose: uses a gage's date index to locate a starting rain record.
+//
+{
+    TRainCursor* cursor;
+    int          lo, hi, mid, b;
+    long long    savedPos, blockPos, pos = -1;
+    DateTime     date;
+    float        depth;
+
+    if ( !Cursors || Cursors[j].nIndex <= 0 ) return -1;
+    cursor = &Cursors[j];
+
+    // --- binary search for last index block starting on or before t
+    lo = 0;
+    hi = cursor->nIndex - 1;
+    if ( cursor->index[0] > t ) return -1;
+    while ( lo < hi )
+    {
+        mid = (lo + hi + 1) / 2;
+        if ( cursor->index[mid] <= t ) lo = mid;
+        else hi = mid - 1;
+    }
+
+    // --- scan forward from start of block for last non-zero record
+    //     dated on or before t, moving back a block if there is none
+    savedPos = Gage[j].currentFilePos;
+    for ( b = lo; b >= 0 && pos < 0; b-- )
+    {
+        blockPos = Gage[j].startFilePos +
+                   (long long)b * cursor->blockSize * RAIN_RECORD_SIZE;
+        Gage[j].currentFilePos = blockPos;
+        while ( rain_readRecord(j, &date, &depth) && date <= t )
+        {
+            if ( depth != 0.0f )
+                pos = Gage[j].currentFilePos - RAIN_RECORD_SIZE;
+        }
+    }
+    Gage[j].currentFilePos = savedPos;
+    return pos;
+}
+
+//=============================================================================
+
+void createRainFile(int count, unsigned long long hash)
 //
 //  Input:   count = number of files to include in rain interface file
+//           hash = hash of the gages' data files & parameters
 //  Output:  none
 //  Purpose: adds rain data from all rain gage files to the interface file.
 //
 {
-    int   i, k;
+    int   i, k, n;
     int   kount = count;               // number of gages in data file
-    int   filePos1;                    // starting byte of gage's header data
-    int   filePos2;                    // starting byte of gage's rain data
-    int   filePos3;                    // starting byte of next gage's data
-    int   interval;                    // recording interval (sec)
-    int   dummy = -1;
-    char  staID[MAXMSG+1];             // gage's ID name
-    char  fileStamp[] = "SWMM5-RAIN";
+    int   blockSize = RAIN_BLOCK_SIZE; // rain records per index block
+    unsigned long long noHash = 0;     // hash until all gages are added
+    long long entryPos;                // starting byte of gage's header data
+    long long dataPos;                 // starting byte of gage's rain data
+    TRainEntry   entry;                // fill-in header data
+    TRainReader* readers;              // readers of a batch of data files
 
     // --- make sure interface file is open and no error condition
     if ( ErrorCode || !Frain.file ) return;
 
-    // --- write file stamp & # gages to file
-    fwrite(fileStamp, sizeof(char), strlen(fileStamp), Frain.file);
+    // --- write file stamp, # gages, index block size & blank hash to file
+    fwrite(FileStamp2, sizeof(char), strlen(FileStamp2), Frain.file);
     fwrite(&kount, sizeof(int), 1, Frain.file);
-    filePos1 = ftell(Frain.file); 
+    fwrite(&blockSize, sizeof(int), 1, Frain.file);
+    fwrite(&noHash, sizeof(noHash), 1, Frain.file);
+    entryPos = _ftelli64(Frain.file);
 
     // --- write default fill-in header records to file for each gage
     //     (will be replaced later with actual records)
-    if ( count > 0 ) report_writeRainStats(-1, &RainStats);
-    for ( i = 0;  i < count; i++ )
-    {
-        fwrite(staID, sizeof(char), MAXMSG+1, Frain.file);
-        for ( k = 1; k <= 3; k++ )
-            fwrite(&dummy, sizeof(int), 1, Frain.file);
-    }
-    filePos2 = ftell(Frain.file);
-
-    // --- loop through project's  rain gages,
-    //     looking for ones using rain files
-    for ( i = 0; i < Nobjects[GAGE]; i++ )
+    if ( count > 0 ) report_writeRainStats(-1, NULL);
+    memset(&entry, 0, sizeof(entry));
+    entry.startPos = -1;
+    entry.endPos = -1;
+    entry.indexPos = -1;
+    for ( i = 0;  i < count; i++ ) writeEntry(&entry);
+    dataPos = _ftelli64(Frain.file);
+
+    // --- create a reader for each gage in a batch of data files
+    readers = (TRainReader *) calloc(NumThreads, sizeof(TRainReader));
+    if ( readers == NULL ) report_writeErrorMsg(ERR_MEMORY, "");
+
+    // --- loop through project's rain gages, a batch of the ones
+    //     using rain files at a time
+    i = 0;
+    while ( !ErrorCode && i < Nobjects[GAGE] )
     {
-        if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
-        if ( rainFileConflict(i) ) break;
+        n = 0;
+        for ( ; i < Nobjects[GAGE] && n < NumThreads; i++ )
+        {
+            if ( Gage[i].dataSource == RAIN_FILE ) readers[n++].gage = i;
+        }
 
-        // --- position rain file to where data for gage will begin
-        fseek(Frain.file, filePos2, SEEK_SET);
+        // --- read the batch's data files in parallel
+#pragma omp parallel for num_threads(NumThreads) schedule(dynamic)
+        for (k = 0; k < n; k++) readGageFile(&readers[k]);
 
-        // --- add gage's data to rain file
-        if ( addGageToRainFile(i) )
+        // --- add each gage's data to rain file in gage order
+        for (k = 0; k < n; k++)
         {
-            // --- write header records for gage to beginning of rain file
-            filePos3 = ftell(Frain.file);
-            fseek(Frain.file, filePos1, SEEK_SET);
-            sstrncpy(staID, Gage[i].staID, MAXMSG);
-            interval = Interval;
-            fwrite(staID,      sizeof(char), MAXMSG+1, Frain.file);
-            fwrite(&interval,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos2,  sizeof(int), 1, Frain.file);
-            fwrite(&filePos3,  sizeof(int), 1, Frain.file);
-            filePos1 = ftell(Frain.file);
-            filePos2 = filePos3;
-            report_writeRainStats(i, &RainStats);
+            if ( !ErrorCode && !rainFileConflict(readers[k].gage) )
+            {
+                saveGageData(&readers[k], &entryPos, &dataPos);
+            }
+            FREE(readers[k].records);
+            FREE(readers[k].errLine);
         }
     }
+    FREE(readers);
 
     // --- if there was an error condition, then delete newly created file
     if ( ErrorCode )
@@ -258,6 +456,13 @@ void createRainFile(int count)
         Frain.file = NULL;
         remove(Frain.name);
     }
+
+    // --- otherwise the file is complete and its hash can be written
+    else
+    {
+        _fseeki64(Frain.file, strlen(FileStamp2) + 2*sizeof(int), SEEK_SET);
+        fwrite(&hash, sizeof(hash), 1, Frain.file);
+    }
 }
 
 //=============================================================================
@@ -286,41 +491,246 @@ int rainFileConflict(int i)
 
 //=============================================================================
 
-int addGageToRainFile(int i)
+void readGageFile(TRainReader* r)
 //
-//  Input:   i = rain gage index
-//  Output:  returns 1 if successful, 0 if not
-//  Purpose: adds a gage's rainfall record to rain interface file
+//  Input:   r = reader of a rain gage's data file
+//  Output:  none
+//  Purpose: reads a gage's rainfall record from its data file into the
+//           reader's buffer.
+//
+//  Note:    gages' data files are read in parallel, so any error is only
+//           noted in the reader and reported by saveGageData.
 //
 {
     FILE* f;                           // pointer to rain file
-    int   fileFormat;                  // file format code
-    int   hdrLines;                    // number of header lines skipped
+    int   i = r->gage;                 // rain gage index
 
-    // --- let StationID point to NULL
-    StationID = NULL;
+    memset(r, 0, sizeof(TRainReader));
+    r->gage = i;
+    r->sorted = TRUE;
 
     // --- check that rain file exists
     if ( (f = fopen(Gage[i].fname, "rt")) == NULL )
-        report_writeErrorMsg(ERR_RAIN_FILE_DATA, Gage[i].fname);
+    {
+        r->error = ERR_RAIN_FILE_DATA;
+        return;
+    }
+    setvbuf(f, NULL, _IOFBF, RAIN_READ_BUFFER);
+
+    // --- find file's format and read its data
+    r->fileFormat = findFileFormat(f, r);
+    if ( r->fileFormat == UNKNOWN_FORMAT ) r->error = ERR_RAIN_FILE_FORMAT;
+    else readFile(r, f);
+    fclose(f);
+}
+
+//=============================================================================
+
+void saveGageData(TRainReader* r, long long* entryPos, long long* dataPos)
+//
+//  Input:   r = reader holding a gage's rain records
+//           entryPos = starting byte of gage's header data
+//           dataPos = starting byte of gage's rain data
+//  Output:  entryPos = starting byte of next gage's header data
+//           dataPos = starting byte of next gage's rain data
+//  Purpose: writes a gage's rain records, date index & header data to the
+//           rain interface file, or reports the error met reading them.
+//
+{
+    int        i = r->gage;
+    long       b;
+    DateTime*  index = NULL;
+    TRainEntry entry;
+
+    // --- report any error met reading gage's data file
+    switch ( r->error )
+    {
+      case 0:
+        break;
+
+      case ERR_RAIN_FILE_SEQUENCE:
+        report_writeLine(
+            "ERROR 318: the following line is out of sequence in rainfall file ");
+        report_writeLine(Gage[i].fname);
+        if ( r->errLine ) report_writeLine(r->errLine);
+        ErrorCode = ERR_RAIN_FILE_SEQUENCE;
+        return;
+
+      case ERR_MEMORY:
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+
+      default:
+        report_writeErrorMsg(r->error, Gage[i].fname);
+        return;
+    }
+
+    // --- write gage's rain records in one piece
+    memset(&entry, 0, sizeof(entry));
+    _fseeki64(Frain.file, *dataPos, SEEK_SET);
+    fwrite(r->records, RAIN_RECORD_SIZE, r->count, Frain.file);
+
+    // --- write date of first record of each block as gage's date index
+    //     after its rain data (no index is written for out of order dates)
+    if ( r->sorted && r->count > 0 )
+    {
+        entry.nIndex = (r->count + RAIN_BLOCK_SIZE - 1) / RAIN_BLOCK_SIZE;
+        index = (DateTime *) malloc(entry.nIndex * sizeof(DateTime));
+        if ( index == NULL ) entry.nIndex = 0;
+        for (b = 0; b < entry.nIndex; b++)
+        {
+            memcpy(&index[b], r->records + b * RAIN_BLOCK_SIZE *
+                   (size_t)RAIN_RECORD_SIZE, sizeof(DateTime));
+        }
+        if ( entry.nIndex > 0 )
+            fwrite(index, sizeof(DateTime), entry.nIndex, Frain.file);
+        FREE(index);
+    }
+
+    // --- write header data for gage to beginning of rain file
+    sstrncpy(entry.staID, Gage[i].staID, MAXMSG);
+    entry.interval = r->interval;
+    entry.startPos = *dataPos;
+    entry.endPos = *dataPos + (long long)r->count * RAIN_RECORD_SIZE;
+    entry.indexPos = entry.endPos;
+    entry.stats = r->stats;
+    _fseeki64(Frain.file, *entryPos, SEEK_SET);
+    writeEntry(&entry);
+    *entryPos = _ftelli64(Frain.file);
+    *dataPos = entry.indexPos + entry.nIndex * sizeof(DateTime);
+    Gage[i].rainInterval = r->interval;
+    report_writeRainStats(i, &r->stats);
+}
+
+//=============================================================================
+
+unsigned long long findSourceHash(int count)
+//
+//  Input:   count = number of gages that use rain files
+//  Output:  returns a hash of the gages' data files & parameters
+//           (0 if any data file can't be read)
+//  Purpose: identifies the rain interface file that the project's rain
+//           gages would produce.
+//
+{
+    int    i, k, n = 0;
+    int*   gages;
+    unsigned long long* hashes;
+    unsigned long long  hash = FNV_OFFSET;
+
+    gages = (int *) malloc(count * sizeof(int));
+    hashes = (unsigned long long *)
+             malloc(count * sizeof(unsigned long long));
+    if ( gages == NULL || hashes == NULL ) hash = 0;
     else
     {
-        fileFormat = findFileFormat(f, i, &hdrLines);
-        if ( fileFormat == UNKNOWN_FORMAT )
+        // --- hash each gage's data file in parallel
+        for (i = 0; i < Nobjects[GAGE]; i++)
         {
-            report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, Gage[i].fname);
+            if ( Gage[i].dataSource == RAIN_FILE ) gages[n++] = i;
         }
-        else
+#pragma omp parallel for num_threads(NumThreads) schedule(dynamic)
+        for (k = 0; k < n; k++) hashes[k] = hashGageSource(gages[k]);
+
+        // --- combine the gages' hashes in gage order
+        for (k = 0; k < n; k++)
         {
-            GageIndex = i;
-            readFile(f, fileFormat, hdrLines, Gage[i].startFileDate,
-                     Gage[i].endFileDate);
+            if ( hashes[k] == 0 )
+            {
+                hash = 0;
+                break;
+            }
+            hash = hashBytes(hash, &hashes[k], sizeof(hashes[k]));
         }
-        fclose(f);
     }
-    if ( ErrorCode ) return 0;
-    else
-    return 1;
+    FREE(gages);
+    FREE(hashes);
+    return hash;
+}
+
+//=============================================================================
+
+unsigned long long hashGageSource(int i)
+//
+//  Input:   i = rain gage index
+//  Output:  returns hash of gage's data file & the parameters it is read
+//           with (0 if the file can't be read)
+//  Purpose: identifies the rain data a gage adds to the interface file.
+//
+{
+    FILE*  f;
+    char   buf[16384];
+    size_t n;
+    unsigned long long h = FNV_OFFSET;
+
+    f = fopen(Gage[i].fname, "rb");
+    if ( f == NULL ) return 0;
+    h = hashBytes(h, Gage[i].staID, strlen(Gage[i].staID) + 1);
+    h = hashBytes(h, Gage[i].fname, strlen(Gage[i].fname) + 1);
+    h = hashBytes(h, &Gage[i].startFileDate, sizeof(DateTime));
+    h = hashBytes(h, &Gage[i].endFileDate, sizeof(DateTime));
+    h = hashBytes(h, &Gage[i].rainType, sizeof(int));
+    h = hashBytes(h, &Gage[i].rainInterval, sizeof(int));
+    h = hashBytes(h, &Gage[i].rainUnits, sizeof(int));
+    while ( (n = fread(buf, 1, sizeof(buf), f)) > 0 ) h = hashBytes(h, buf, n);
+    fclose(f);
+    if ( h == 0 ) h = 1;
+    return h;
+}
+
+//=============================================================================
+
+int rainFileIsCurrent(int count, unsigned long long hash)
+//
+//  Input:   count = number of gages that use rain files
+//           hash = hash of the gages' data files & parameters
+//  Output:  returns TRUE if the rain interface file to be saved already
+//           holds the gages' data, FALSE if not
+//  Purpose: checks if a saved rain interface file was created from the
+//           same data files & gage parameters as the current project's.
+//
+{
+    FILE* f;
+    char  fStamp[] = "SWMM5-RAIN";
+    int   kount = 0;
+    int   blockSize = 0;
+    unsigned long long fileHash = 0;
+
+    if ( hash == 0 ) return FALSE;
+    if ( (f = fopen(Frain.name, "rb")) == NULL ) return FALSE;
+    fread(fStamp, sizeof(char), strlen(FileStamp2), f);
+    fread(&kount, sizeof(int), 1, f);
+    fread(&blockSize, sizeof(int), 1, f);
+    fread(&fileHash, sizeof(fileHash), 1, f);
+    fclose(f);
+    return ( strcmp(fStamp, FileStamp2) == 0 && kount == count &&
+             fileHash == hash );
+}
+
+//=============================================================================
+
+void reportSavedStats(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the summary of rain data saved in a rain interface file
+//           that is used as is to the report file.
+//
+{
+    int        i;
+    TRainEntry entry;
+
+    if ( ErrorCode || !Frain.file ) return;
+    _fseeki64(Frain.file, strlen(FileStamp2) + 2*sizeof(int) +
+              sizeof(unsigned long long), SEEK_SET);
+    report_writeRainStats(-1, NULL);
+    for ( i = 0; i < Nobjects[GAGE]; i++ )
+    {
+        if ( Gage[i].dataSource != RAIN_FILE ) continue;
+        readEntry(&entry, 2);
+        Gage[i].rainInterval = entry.interval;
+        report_writeRainStats(i, &entry.stats);
+    }
 }
 
 //=============================================================================
@@ -332,25 +742,42 @@ void initRainFile(void)
 //  Purpose: initializes rain interface file for reading.
 //
 {
-    char  fileStamp[] = "SWMM5-RAIN";
     char  fStamp[] = "SWMM5-RAIN";
     int   i;
     int   kount;
-    long  filePos;
+    int   version;
+    int   blockSize = 0;
+    unsigned long long hash;
+    long long filePos;
 
     // --- make sure interface file is open and no error condition
     if ( ErrorCode || !Frain.file ) return;
 
     // --- check that interface file contains proper file stamp
     rewind(Frain.file);
-    fread(fStamp, sizeof(char), strlen(fileStamp), Frain.file);
-    if ( strcmp(fStamp, fileStamp) != 0 )
+    fread(fStamp, sizeof(char), strlen(FileStamp1), Frain.file);
+    if      ( strcmp(fStamp, FileStamp1) == 0 ) version = 1;
+    else if ( strcmp(fStamp, FileStamp2) == 0 ) version = 2;
+    else
     {
         report_writeErrorMsg(ERR_RAIN_IFACE_FORMAT, "");
         return;
     }
     fread(&kount, sizeof(int), 1, Frain.file);
-    filePos = ftell(Frain.file);
+    if ( version == 2 )
+    {
+        fread(&blockSize, sizeof(int), 1, Frain.file);
+        fread(&hash, sizeof(hash), 1, Frain.file);
+    }
+    filePos = _ftelli64(Frain.file);
+
+    // --- create a read cursor for each rain gage
+    Cursors = (TRainCursor *) calloc(Nobjects[GAGE], sizeof(TRainCursor));
+    if ( Cursors == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
 
     // --- locate information for each raingage in interface file
     for ( i = 0; i < Nobjects[GAGE]; i++ )
@@ -358,8 +785,8 @@ void initRainFile(void)
         if ( ErrorCode || Gage[i].dataSource != RAIN_FILE ) continue;
 
         // --- match station ID for gage with one in file
-        fseek(Frain.file, filePos, SEEK_SET);
-        if ( !findGageInFile(i, (int)kount) ||
+        _fseeki64(Frain.file, filePos, SEEK_SET);
+        if ( !findGageInFile(i, (int)kount, version, blockSize) ||
              Gage[i].startFilePos == Gage[i].endFilePos )
         {
             report_writeErrorMsg(ERR_RAIN_FILE_GAGE, Gage[i].ID);
@@ -369,34 +796,31 @@ void initRainFile(void)
 
 //=============================================================================
 
-int findGageInFile(int i, int kount)
+int findGageInFile(int i, int kount, int version, int blockSize)
 //
 //  Input:   i     = rain gage index
 //           kount = number of rain gages stored on interface file
+//           version = format version of interface file (1 or 2)
+//           blockSize = rain records per date index block
 //  Output:  returns TRUE if successful, FALSE if not
 //  Purpose: checks if rain gage's station ID appears in interface file.
 //
 {
-    int   k;
-    int  interval;
-    int  filePos1, filePos2;
-    char  staID[MAXMSG+1];
+    int        k;
+    TRainEntry entry;
 
     for ( k = 1; k <= kount; k++ )
     {
-        fread(staID,      sizeof(char), MAXMSG+1, Frain.file);
-        fread(&interval,  sizeof(int), 1, Frain.file);
-        fread(&filePos1,  sizeof(int), 1, Frain.file);
-        fread(&filePos2,  sizeof(int), 1, Frain.file);
-        if ( strcmp(staID, Gage[i].staID) == 0 )
+        readEntry(&entry, version);
+        if ( strcmp(entry.staID, Gage[i].staID) == 0 )
         {
             // --- match found; save file parameters
             Gage[i].rainType     = RAINFALL_VOLUME;
-            Gage[i].rainInterval = interval;
-            Gage[i].startFilePos = (long)filePos1;
-            Gage[i].endFilePos   = (long)filePos2;
+            Gage[i].rainInterval = entry.interval;
+            Gage[i].startFilePos = entry.startPos;
+            Gage[i].endFilePos   = entry.endPos;
             Gage[i].currentFilePos = Gage[i].startFilePos;
-            return TRUE;
+            return readIndex(i, entry.indexPos, entry.nIndex, blockSize);
         }
     }
     return FALSE;
@@ -404,15 +828,111 @@ int findGageInFile(int i, int kount)
 
 //=============================================================================
 
-int findFileFormat(FILE *f, int i, int *hdrLines)
+void readEntry(TRainEntry* e, int version)
+//
+//  Input:   e = a gage's header data
+//           version = format version of interface file (1 or 2)
+//  Output:  none
+//  Purpose: reads a gage's header data from the rain interface file.
+//
+{
+    int pos1, pos2;
+    int periods[3];
+
+    memset(e, 0, sizeof(TRainEntry));
+    fread(e->staID,      sizeof(char), MAXMSG+1, Frain.file);
+    fread(&e->interval,  sizeof(int), 1, Frain.file);
+    if ( version == 1 )
+    {
+        fread(&pos1, sizeof(int), 1, Frain.file);
+        fread(&pos2, sizeof(int), 1, Frain.file);
+        e->startPos = pos1;
+        e->endPos   = pos2;
+        e->stats.startDate = NO_DATE;
+        e->stats.endDate   = NO_DATE;
+    }
+    else
+    {
+        fread(&e->startPos, sizeof(long long), 1, Frain.file);
+        fread(&e->endPos,   sizeof(long long), 1, Frain.file);
+        fread(&e->indexPos, sizeof(long long), 1, Frain.file);
+        fread(&e->nIndex,   sizeof(int), 1, Frain.file);
+        fread(&e->stats.startDate, sizeof(DateTime), 1, Frain.file);
+        fread(&e->stats.endDate,   sizeof(DateTime), 1, Frain.file);
+        fread(periods, sizeof(int), 3, Frain.file);
+        e->stats.periodsRain    = periods[0];
+        e->stats.periodsMissing = periods[1];
+        e->stats.periodsMalfunc = periods[2];
+    }
+}
+
+//=============================================================================
+
+void writeEntry(TRainEntry* e)
+//
+//  Input:   e = a gage's header data
+//  Output:  none
+//  Purpose: writes a gage's header data to the rain interface file.
+//
+{
+    int periods[3];
+
+    periods[0] = (int)e->stats.periodsRain;
+    periods[1] = (int)e->stats.periodsMissing;
+    periods[2] = (int)e->stats.periodsMalfunc;
+    fwrite(e->staID,      sizeof(char), MAXMSG+1, Frain.file);
+    fwrite(&e->interval,  sizeof(int), 1, Frain.file);
+    fwrite(&e->startPos,  sizeof(long long), 1, Frain.file);
+    fwrite(&e->endPos,    sizeof(long long), 1, Frain.file);
+    fwrite(&e->indexPos,  sizeof(long long), 1, Frain.file);
+    fwrite(&e->nIndex,    sizeof(int), 1, Frain.file);
+    fwrite(&e->stats.startDate, sizeof(DateTime), 1, Frain.file);
+    fwrite(&e->stats.endDate,   sizeof(DateTime), 1, Frain.file);
+    fwrite(periods, sizeof(int), 3, Frain.file);
+}
+
+//=============================================================================
+
+int readIndex(int i, long long indexPos, int nIndex, int blockSize)
+//
+//  Input:   i = rain gage index
+//           indexPos = starting byte of gage's date index
+//           nIndex = number of entries in date index
+//           blockSize = rain records per date index block
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: reads a gage's date index from the interface file into its
+//           read cursor.
+//
+{
+    TRainCursor* cursor = &Cursors[i];
+
+    cursor->blockSize = blockSize;
+    if ( nIndex <= 0 || blockSize <= 0 ) return TRUE;
+    cursor->index = (DateTime *) malloc(nIndex * sizeof(DateTime));
+    if ( cursor->index == NULL ) return TRUE;
+    _fseeki64(Frain.file, indexPos, SEEK_SET);
+    if ( fread(cursor->index, sizeof(DateTime), nIndex, Frain.file) !=
+         (size_t)nIndex )
+    {
+        FREE(cursor->index);
+        return FALSE;
+    }
+    cursor->nIndex = nIndex;
+    return TRUE;
+}
+
+//=============================================================================
+
+int findFileFormat(FILE *f, TRainReader* r)
 //
 //  Input:   f = ptr. to rain gage's rainfall data file
-//           i = rain gage index
-//  Output:  hdrLines  = number of header lines found in data file;
-//           returns type of format used in a rainfall data file
-//  Purpose: finds the format of a gage's rainfall data file.
+//           r = reader of the gage's data file
+//  Output:  returns type of format used in a rainfall data file
+//  Purpose: finds the format of a gage's rainfall data file and the
+//           number of header lines that precede its data.
 //
 {
+    int   i = r->gage;
     int   fileFormat;
     int   lineCount;
     int   maxCount = 5;
@@ -429,10 +949,10 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
     
     // --- check first few lines for known formats
     fileFormat = UNKNOWN_FORMAT;
-    hasStationName = FALSE;
-    UnitsFactor = 1.0;
-    Interval = 0;
-    *hdrLines = 0;
+    r->hasStationName = FALSE;
+    r->unitsFactor = 1.0;
+    r->interval = 0;
+    r->hdrLines = 0;
     for (lineCount = 1; lineCount <= maxCount; lineCount++)
     {
         if ( fgets(line, MAXLINE, f) == NULL ) return fileFormat;
@@ -441,9 +961,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6d %2d %4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_SPACE_DELIMITED;
                 break;
@@ -454,12 +974,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d %4s %2s %4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_SPACE_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;
                 break;
             }
         }
@@ -468,9 +988,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%6d,%2d,%4s", &sn2, &div, elemType);
         if ( n == 3 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_COMMA_DELIMITED;
                 break;
@@ -481,12 +1001,12 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(&line[37], "%2d,%4s,%2s,%4d", &div, elemType, recdType, &year);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_COMMA_DELIMITED;
-                hasStationName = TRUE;
+                r->hasStationName = TRUE;
                 break;
             }
         }
@@ -495,9 +1015,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%3s%6d%2d%4s", recdType, &sn2, &div, elemType);
         if ( n == 4 )
         {
-            Interval = getNWSInterval(elemType);
-            TimeOffset = Interval;
-            if ( Interval > 0 )
+            r->interval = getNWSInterval(elemType);
+            r->timeOffset = r->interval;
+            if ( r->interval > 0 )
             {
                 fileFormat = NWS_TAPE;
                 break;
@@ -508,7 +1028,7 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
         n = sscanf(line, "%5s%6d", coopID, &sn2);
         if ( n == 2 && strcmp(coopID, "COOP:") == 0 )
         {
-            fileFormat = findNWSOnlineFormat(f, line);
+            fileFormat = findNWSOnlineFormat(f, line, r);
             break;
         }
 
@@ -519,9 +1039,9 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 123 && strlen(line) >= 185 )
             {
                 fileFormat = AES_HLY;
-                Interval = 3600;
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->interval = 3600;
+                r->timeOffset = r->interval;
+                r->unitsFactor = 1.0/MMperINCH;
                 break;
             }
         }
@@ -533,45 +1053,46 @@ int findFileFormat(FILE *f, int i, int *hdrLines)
             if ( elem == 159 && strlen(line) >= 691 )
             {
                 fileFormat = CMC_FIF;
-                Interval = 900;
+                r->interval = 900;
             }
             else if ( elem == 123 && strlen(line) >= 186 )
             {
                 fileFormat = CMC_HLY;
-                Interval = 3600;
+                r->interval = 3600;
             }
             if ( fileFormat == CMC_FIF || fileFormat == CMC_HLY )
             {
-                TimeOffset = Interval;
-                UnitsFactor = 1.0/MMperINCH;
+                r->timeOffset = r->interval;
+                r->unitsFactor = 1.0/MMperINCH;
                 break;
             }
         }
 
         // --- check for standard format
-        if ( parseStdLine(line, &year, &month, &day, &hour, &minute, &x) )
+        if ( parseStdLine(line, r->stationID, &year, &month, &day, &hour,
+                          &minute, &x) )
         {
             fileFormat = STD_SPACE_DELIMITED;
-            RainType = Gage[i].rainType;
-            Interval = Gage[i].rainInterval;
-            if ( Gage[i].rainUnits == SI ) UnitsFactor = 1.0/MMperINCH;
-            TimeOffset = 0;
-            StationID = Gage[i].staID;
+            r->rainType = Gage[i].rainType;
+            r->interval = Gage[i].rainInterval;
+            if ( Gage[i].rainUnits == SI ) r->unitsFactor = 1.0/MMperINCH;
+            r->timeOffset = 0;
+            r->stationID = Gage[i].staID;
             break;         
         }
-        (*hdrLines)++;
+        r->hdrLines++;
 
     }
-    if ( fileFormat != UNKNOWN_FORMAT ) Gage[i].rainInterval = Interval;
     return fileFormat;
 }
 
 //=============================================================================
 
-int findNWSOnlineFormat(FILE *f, char *line)
+int findNWSOnlineFormat(FILE *f, char *line, TRainReader* r)
 //
 //  Input:   f = pointer to rainfall data file
 //           line = line read from rainfall data file
+//           r = reader of the data file
 //  Output:  
 //  Purpose: determines the file format for an NWS Online Retrieval data file.
 //
@@ -587,18 +1108,18 @@ int findNWSOnlineFormat(FILE *f, char *line)
     // --- if 'HPCP' appears then file is for hourly data
     if ( (str = strstr(line, "HPCP")) != NULL )
     {
-        Interval = 3600;
-        TimeOffset = Interval;
-        ValueOffset = str - line;
+        r->interval = 3600;
+        r->timeOffset = r->interval;
+        r->valueOffset = str - line;
         fileFormat = NWS_ONLINE_60;
     }
 
     // --- if 'QPCP" appears then file is for 15 minute data
     else if ( (str = strstr(line, "QPCP")) != NULL )
     {
-        Interval = 900;
-        TimeOffset = Interval;
-        ValueOffset = str - line;
+        r->interval = 900;
+        r->timeOffset = r->interval;
+        r->valueOffset = str - line;
         fileFormat = NWS_ONLINE_15;
     }
     else return UNKNOWN_FORMAT;
@@ -617,7 +1138,7 @@ int findNWSOnlineFormat(FILE *f, char *line)
 
         // --- use pointer arithmetic to convert pointer to character position
         n = str - line;
-        DataOffset = n - 11;
+        r->dataOffset = n - 11;
         return fileFormat;
     }
     return UNKNOWN_FORMAT;
@@ -640,32 +1161,31 @@ int getNWSInterval(char *elemType)
 
 //=============================================================================
 
-void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
-              DateTime day2)
+void readFile(TRainReader* r, FILE *f)
 //
-//  Input:   f          = ptr. to gage's rainfall data file
-//           fileFormat = code of data file's format
-//           hdrLines   = number of header lines in data file
-//           day1       = starting day of record of interest
-//           day2       = ending day of record of interest
+//  Input:   r = reader of a gage's rainfall data file
+//           f = ptr. to gage's rainfall data file
 //  Output:  none
-//  Purpose: reads rainfall records from gage's data file to interface file.
+//  Purpose: reads rainfall records from gage's data file to reader's buffer.
 //
 {
     char line[MAXLINE];
     int  i, n;
+    int  fileFormat = r->fileFormat;
+    DateTime day1 = Gage[r->gage].startFileDate;
+    DateTime day2 = Gage[r->gage].endFileDate;
 
     rewind(f);
-    RainStats.startDate  = NO_DATE;
-    RainStats.endDate    = NO_DATE;
-    RainStats.periodsRain = 0;
-    RainStats.periodsMissing = 0;
-    RainStats.periodsMalfunc = 0;
-    RainAccum = 0.0;
-    AccumStartDate = NO_DATE;
-    PreviousDate = NO_DATE;
-
-    for (i = 1; i <= hdrLines; i++)
+    r->stats.startDate  = NO_DATE;
+    r->stats.endDate    = NO_DATE;
+    r->stats.periodsRain = 0;
+    r->stats.periodsMissing = 0;
+    r->stats.periodsMalfunc = 0;
+    r->rainAccum = 0.0;
+    r->accumStartDate = NO_DATE;
+    r->previousDate = NO_DATE;
+
+    for (i = 1; i <= r->hdrLines; i++)
     {
         if ( fgets(line, MAXLINE, f) == NULL ) return;
     }
@@ -674,7 +1194,7 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
        switch (fileFormat)
        {
          case STD_SPACE_DELIMITED:
-          n = readStdLine(line, day1, day2);
+          n = readStdLine(r, line, day1, day2);
           break;
 
          case NWS_TAPE:
@@ -682,35 +1202,37 @@ void readFile(FILE *f, int fileFormat, int hdrLines, DateTime day1,
          case NWS_COMMA_DELIMITED:
          case NWS_ONLINE_60:
          case NWS_ONLINE_15:
-           n = readNWSLine(line, fileFormat, day1, day2);
+           n = readNWSLine(r, line, fileFormat, day1, day2);
            break;
 
          case AES_HLY:
          case CMC_FIF:
          case CMC_HLY:
-           n = readCMCLine(line, fileFormat, day1, day2);
+           n = readCMCLine(r, line, fileFormat, day1, day2);
            break;
 
          default:
            n = -1;
            break;
        }
-       if ( n < 0 ) break;
+       if ( n < 0 || r->error ) break;
     }
 }
 
 //=============================================================================
 
-int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+int readNWSLine(TRainReader* r, char *line, int fileFormat, DateTime day1,
+                DateTime day2)
 //
-//  Input:   line       = line of data from rainfall data file
+//  Input:   r          = reader of a gage's rainfall data file
+//           line       = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1       = starting day of record of interest
 //           day2       = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
-//  Purpose: reads a line of data from a rainfall data file and writes its
-//           data to the rain interface file.
+//  Purpose: reads a line of data from a rainfall data file and adds its
+//           data to the reader's buffer.
 //
 {
     char     flag1, flag2, isMissing;
@@ -728,29 +1250,30 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     {
       case NWS_TAPE:
         if ( lineLength <= 30 ) return 0;
-        if (sscanf(&line[17], "%4d%2d%4d%3d", &y, &m, &d, &n) < 4) return 0;
+        if (scanFields(&line[17], "%4d%2d%4d%3d", &y, &m, &d, &n) < 4) return 0;
         k = 30;
         break;
 
       case NWS_SPACE_DELIMITED:
-        if ( hasStationName ) nameLength = 31;
+        if ( r->hasStationName ) nameLength = 31;
         if ( lineLength <= 28 + nameLength ) return 0;
         k = 18 + nameLength;
-        if (sscanf(&line[k], "%4d %2d %2d", &y, &m, &d) < 3) return 0;
+        if (scanFields(&line[k], "%4d %2d %2d", &y, &m, &d) < 3) return 0;
         k = k + 10;
         break;
 
       case NWS_COMMA_DELIMITED:
         if ( lineLength <= 28 ) return 0;
-        if ( sscanf(&line[18], "%4d,%2d,%2d", &y, &m, &d) < 3 ) return 0;
+        if ( scanFields(&line[18], "%4d,%2d,%2d", &y, &m, &d) < 3 ) return 0;
         k = 28;
         break;
 
       case NWS_ONLINE_60:
       case NWS_ONLINE_15:
-        if ( lineLength <= DataOffset + 23 ) return 0;
-        if ( sscanf(&line[DataOffset], "%4d%2d%2d", &y, &m, &d) < 3 ) return 0;
-        k = DataOffset + 8;
+        if ( lineLength <= r->dataOffset + 23 ) return 0;
+        if ( scanFields(&line[r->dataOffset], "%4d%2d%2d", &y, &m, &d) < 3 )
+            return 0;
+        k = r->dataOffset + 8;
         break;
       default: return 0;
     }
@@ -771,28 +1294,27 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         switch ( fileFormat )
         {
           case NWS_TAPE:
-            n = sscanf(&line[k], "%2d%2d%6d%c%c",
+            n = scanFields(&line[k], "%2d%2d%6ld%c%c",
                        &hour, &minute, &v, &flag1, &flag2);
             k += 12;
             break;
 
           case NWS_SPACE_DELIMITED:
-            n = sscanf(&line[k], " %2d%2d %6d %c %c",
+            n = scanFields(&line[k], " %2d%2d %6ld %c %c",
                        &hour, &minute, &v, &flag1, &flag2);
             k += 16;
             break;
 
           case NWS_COMMA_DELIMITED:
-            n = sscanf(&line[k], ",%2d%2d,%6d,%c,%c",
+            n = scanFields(&line[k], ",%2d%2d,%6ld,%c,%c",
                        &hour, &minute, &v, &flag1, &flag2);
             k += 16;
             break;
 
           case NWS_ONLINE_60:
           case NWS_ONLINE_15:
-              n = sscanf(&line[k], " %2d:%2d", &hour, &minute);
-              n += sscanf(&line[ValueOffset], "%8d                %c",
-                          &v, &flag1);
+              n = scanFields(&line[k], " %2d:%2d", &hour, &minute);
+              n += scanFields(&line[r->valueOffset], "%8ld %c", &v, &flag1);
 
               // --- ending hour 0 is really hour 24 of previous day
               if ( hour == 0 )
@@ -812,9 +1334,9 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
         // --- set special condition code & update daily & hourly counts
 
-        setCondition(flag1);
-        if ( Condition == DELETED_PERIOD ||
-             Condition == MISSING_PERIOD ||
+        setCondition(r, flag1);
+        if ( r->condition == DELETED_PERIOD ||
+             r->condition == MISSING_PERIOD ||
              flag1 == 'M' ) isMissing = TRUE;
         else if ( v >= 9999 ) isMissing = TRUE;
         else isMissing = FALSE;
@@ -822,11 +1344,11 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         // --- handle accumulation codes 
         if ( flag1 == 'a' )
         {
-            AccumStartDate = date1 + datetime_encodeTime(hour, minute, 0);
+            r->accumStartDate = date1 + datetime_encodeTime(hour, minute, 0);
         }
         else if ( flag1 == 'A' )
         {
-            saveAccumRainfall(date1, hour, minute, v);
+            saveAccumRainfall(r, date1, hour, minute, v);
         } 
 
         // --- handle all other conditions
@@ -835,50 +1357,52 @@ int readNWSLine(char *line, int fileFormat, DateTime day1, DateTime day2)
             // --- convert rain measurement to inches & save it
             x = (float)v / 100.0f; 
             if ( x > 0 || isMissing )
-                saveRainfall(date1, hour, minute, x, isMissing);
+                saveRainfall(r, date1, hour, minute, x, isMissing);
         } 
 
         // --- reset condition code if special condition period ended
-        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') Condition = 0;
+        if ( flag1 == 'A' || flag1 == '}' || flag1 == ']') r->condition = 0;
     }
     return result;
 }
 
 //=============================================================================
 
-void  setCondition(char flag)
+void  setCondition(TRainReader* r, char flag)
 {
     switch ( flag )
     {
       case 'a': 
       case 'A':
-        Condition = ACCUMULATED_PERIOD;
+        r->condition = ACCUMULATED_PERIOD;
         break;
       case '{':
       case '}':
-        Condition = DELETED_PERIOD;
+        r->condition = DELETED_PERIOD;
         break;
       case '[':
       case ']':
-        Condition = MISSING_PERIOD;
+        r->condition = MISSING_PERIOD;
         break;
       default:
-        Condition = NO_CONDITION;
+        r->condition = NO_CONDITION;
     }
 }
 
 //=============================================================================
 
-int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
+int readCMCLine(TRainReader* r, char *line, int fileFormat, DateTime day1,
+                DateTime day2)
 //
-//  Input:   line = line of data from rainfall data file
+//  Input:   r = reader of a gage's rainfall data file
+//           line = line of data from rainfall data file
 //           fileFormat = code of data file's format
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from an AES or CMC rainfall data file and
-//           writes its data to the rain interface file.
+//           adds its data to the reader's buffer.
 //
 {
     char     flag, isMissing;
@@ -890,7 +1414,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     // --- get year, month, day & element code from line
     if ( fileFormat == AES_HLY )
     {
-        if ( sscanf(line, "%7d%3d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
+        if ( scanFields(line, "%7ld%3d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
             return 0;
         if ( y < 100 ) y = y + 2000;
         else           y = y + 1000;
@@ -898,7 +1422,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     }
     else
     {
-        if ( sscanf(line, "%7d%4d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
+        if ( scanFields(line, "%7ld%4d%2d%2d%3d", &sn, &y, &m, &d, &elem) < 5 )
             return 0;
         col = 18;
     }
@@ -920,7 +1444,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
     if ( fileFormat == CMC_FIF ) jMax = 96;
     for (j=1; j<=jMax; j++)
     {
-        if ( sscanf(&line[col], "%6d%c", &v, &flag) < 2 ) return 0;
+        if ( scanFields(&line[col], "%6ld%c", &v, &flag) < 2 ) return 0;
         col += 7;
         if ( v == -99999 ) isMissing = TRUE;
         else               isMissing = FALSE;
@@ -929,7 +1453,7 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
         x = (float)( (double)v / 10.0 / MMperINCH);
         if ( x > 0 || isMissing)
         {
-            saveRainfall(date1, hour, minute, x, isMissing);
+            saveRainfall(r, date1, hour, minute, x, isMissing);
         }
 
         // --- update hour & minute for next interval
@@ -949,15 +1473,16 @@ int readCMCLine(char *line, int fileFormat, DateTime day1, DateTime day2)
 
 //=============================================================================
 
-int readStdLine(char *line, DateTime day1, DateTime day2)
+int readStdLine(TRainReader* r, char *line, DateTime day1, DateTime day2)
 //
-//  Input:   line = line of data from a standard rainfall data file
+//  Input:   r = reader of a gage's rainfall data file
+//           line = line of data from a standard rainfall data file
 //           day1 = starting day of record of interest
 //           day2 = ending day of record of interest
 //  Output:  returns -1 if past end of desired record, 0 if data line could
 //           not be read successfully or 1 if line read successfully
 //  Purpose: reads a line of data from a standard rainfall data file and
-//           writes its data to the rain interface file.
+//           adds its data to the reader's buffer.
 //
 {
     DateTime date1;
@@ -966,7 +1491,8 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
     float    x;
 
     // --- parse data from input line
-    if (!parseStdLine(line, &year, &month, &day, &hour, &minute, &x)) return 0;
+    if (!parseStdLine(line, r->stationID, &year, &month, &day, &hour, &minute,
+                      &x)) return 0;
 
     // --- see if date is within period of record requested
     date1 = datetime_encodeDate(year, month, day);
@@ -975,45 +1501,46 @@ int readStdLine(char *line, DateTime day1, DateTime day2)
 
     // --- see if record is out of sequence
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    if ( date2 <= PreviousDate )
+    //     (the line is kept so it can be reported once the gage's
+    //     data is saved)
+    if ( date2 <= r->previousDate )
     {
-        report_writeLine(
-            "ERROR 318: the following line is out of sequence in rainfall file ");
-        report_writeLine(Gage[GageIndex].fname);
-        report_writeLine(line);
-        ErrorCode = ERR_RAIN_FILE_SEQUENCE;
+        r->error = ERR_RAIN_FILE_SEQUENCE;
+        r->errLine = (char *) malloc(strlen(line) + 1);
+        if ( r->errLine ) strcpy(r->errLine, line);
         return -1;
     }
-    PreviousDate = date2;
+    r->previousDate = date2;
 
-    switch (RainType)
+    switch (r->rainType)
     {
       case RAINFALL_INTENSITY:
-        x = x * Interval / 3600.0f;
+        x = x * r->interval / 3600.0f;
         break;
 
       case CUMULATIVE_RAINFALL:
-        if ( x >= RainAccum )
+        if ( x >= r->rainAccum )
         {
-            x = x - RainAccum;
-            RainAccum += x;
+            x = x - r->rainAccum;
+            r->rainAccum += x;
         }
-        else RainAccum = x;
+        else r->rainAccum = x;
         break;
     }
-    x *= (float)UnitsFactor;
+    x *= (float)r->unitsFactor;
 
-    // --- save rainfall to binary interface file
-    saveRainfall(date1, hour, minute, x, FALSE);
+    // --- save rainfall to reader's buffer
+    saveRainfall(r, date1, hour, minute, x, FALSE);
     return 1;
 }
 
 //=============================================================================
 
-int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
-                 int *minute, float *value)
+int parseStdLine(char *line, char *staID, int *year, int *month, int *day,
+                 int *hour, int *minute, float *value)
 //
 //  Input:   line = line of data from a standard rainfall data file
+//           staID = station ID the line must have (NULL if any will do)
 //  Output:  *year = year when rainfall occurs
 //           *month = month of year when rainfall occurs
 //           *day = day of month when rainfall occurs
@@ -1028,24 +1555,27 @@ int parseStdLine(char *line, int *year, int *month, int *day, int *hour,
     int n;
     char token[MAXLINE];
 
-    n = sscanf(line, "%s %d %d %d %d %d %f", token, year, month, day, hour, minute, value);
+    n = scanFields(line, "%s %d %d %d %d %d %f", token, year, month, day, hour,
+                   minute, value);
     if ( n < 7 ) return 0;
-    if ( StationID != NULL && !strcomp(token, StationID) ) return 0;
+    if ( staID != NULL && !strcomp(token, staID) ) return 0;
     return 1;
 }
 
 //=============================================================================
 
-void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
+void saveAccumRainfall(TRainReader* r, DateTime date1, int hour, int minute,
+                       long v)
 //
-//  Input:   date1 = date of latest rainfall reading (in DateTime format)
+//  Input:   r = reader of a gage's rainfall data file
+//           date1 = date of latest rainfall reading (in DateTime format)
 //           hour = hour of day of latest rain reading
 //           minute = minute of hour of latest rain reading
 //           v = accumulated rainfall reading in hundreths of inches
 //  Output:  none
 //  Purpose: divides accumulated rainfall evenly into individual recording
-//           periods over the accumulation period and writes each period's
-//           rainfall to the binary rainfall file.
+//           periods over the accumulation period and adds each period's
+//           rainfall to the reader's buffer.
 //
 {
     DateTime date2;
@@ -1053,19 +1583,19 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
     float    x;
 
     // --- return if accumulated start date is missing
-    if ( AccumStartDate == NO_DATE ) return;
+    if ( r->accumStartDate == NO_DATE ) return;
 
     // --- find number of recording intervals over accumulation period
     date2 = date1 + datetime_encodeTime(hour, minute, 0);
-    n = (datetime_timeDiff(date2, AccumStartDate) / Interval) + 1;
+    n = (datetime_timeDiff(date2, r->accumStartDate) / r->interval) + 1;
 
     // --- update count of rain or missing periods
     if ( v == 99999 )
     {
-        RainStats.periodsMissing += n;
+        r->stats.periodsMissing += n;
         return;
     }
-    RainStats.periodsRain += n;
+    r->stats.periodsRain += n;
 
     // --- divide accumulated amount evenly into each period
     x = (float)v / (float)n / 100.0f;
@@ -1073,55 +1603,255 @@ void saveAccumRainfall(DateTime date1, int hour, int minute, long v)
     // --- save this amount to file for each period
     if ( x > 0.0f )
     {
-        date2 = datetime_addSeconds(AccumStartDate, -TimeOffset);
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
+        date2 = datetime_addSeconds(r->accumStartDate, -r->timeOffset);
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;
         for (j = 0; j < n; j++)
         {
-            fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-            fwrite(&x, sizeof(float), 1, Frain.file);
-            date2 = datetime_addSeconds(date2, Interval);
-            RainStats.endDate = date2;
+            addRainRecord(r, date2, x);
+            date2 = datetime_addSeconds(date2, r->interval);
+            r->stats.endDate = date2;
         }
     }
 
     // --- reset start of accumulation period
-    AccumStartDate = NO_DATE;
+    r->accumStartDate = NO_DATE;
 }
 
 
 //=============================================================================
 
-void saveRainfall(DateTime date1, int hour, int minute, float x, char isMissing)
+void saveRainfall(TRainReader* r, DateTime date1, int hour, int minute,
+                  float x, char isMissing)
 //
-//  Input:   date1 = date of rainfall reading (in DateTime format)
+//  Input:   r = reader of a gage's rainfall data file
+//           date1 = date of rainfall reading (in DateTime format)
 //           hour = hour of day of current rain reading
 //           minute = minute of hour of current rain reading
 //           x = rainfall reading in inches
 //           isMissing = TRUE if rainfall value is missing
 //  Output:  none
-//  Purpose: writes current rainfall reading from an external rainfall file
-//           to project's binary rainfall file.
+//  Purpose: adds current rainfall reading from an external rainfall file
+//           to the reader's buffer.
 //
 {
     DateTime date2;
     double   seconds;
 
-    if ( isMissing ) RainStats.periodsMissing++;
-    else             RainStats.periodsRain++;
+    if ( isMissing ) r->stats.periodsMissing++;
+    else             r->stats.periodsRain++;
 
-    // --- if rainfall not missing then save it to rainfall interface file
+    // --- if rainfall not missing then save it to reader's buffer
     if ( !isMissing )
     {
-        seconds = 3600*hour + 60*minute - TimeOffset;
+        seconds = 3600*hour + 60*minute - r->timeOffset;
         date2 = datetime_addSeconds(date1, seconds);
 
-        // --- write date & value (in inches) to interface file
-        fwrite(&date2, sizeof(DateTime), 1, Frain.file);
-        fwrite(&x, sizeof(float), 1, Frain.file);
+        // --- add date & value (in inches) to buffer
+        addRainRecord(r, date2, x);
 
         // --- update actual start & end of record dates
-        if ( RainStats.startDate == NO_DATE ) RainStats.startDate = date2;
-        RainStats.endDate = date2;
+        if ( r->stats.startDate == NO_DATE ) r->stats.startDate = date2;
+        r->stats.endDate = date2;
+    }
+}
+
+//=============================================================================
+
+void addRainRecord(TRainReader* r, DateTime date, float x)
+//
+//  Input:   r = reader of a gage's rainfall data file
+//           date = start date of rain period
+//           x = rain depth over period (inches)
+//  Output:  none
+//  Purpose: adds a rain record to the reader's buffer, enlarging the
+//           buffer when it is full.
+//
+{
+    char* records;
+    char* p;
+
+    if ( r->error ) return;
+    if ( r->count == r->size )
+    {
+        r->size = (r->size == 0) ? RAIN_BLOCK_SIZE : 2 * r->size;
+        records = (char *) realloc(r->records,
+                                   (size_t)r->size * RAIN_RECORD_SIZE);
+        if ( records == NULL )
+        {
+            r->error = ERR_MEMORY;
+            return;
+        }
+        r->records = records;
+    }
+    if ( r->count > 0 && date < r->lastDate ) r->sorted = FALSE;
+    r->lastDate = date;
+    p = r->records + (size_t)r->count * RAIN_RECORD_SIZE;
+    memcpy(p, &date, sizeof(DateTime));
+    memcpy(p + sizeof(DateTime), &x, sizeof(float));
+    r->count++;
+}
+
+//=============================================================================
+
+int scanFields(char *s, const char *fmt, ...)
+//
+//  Input:   s = line of data from a rainfall data file
+//           fmt = format of the line's fields
+//           ... = addresses where the fields' values are stored
+//  Output:  returns number of fields read (or EOF if the line ends before
+//           the first one)
+//  Purpose: reads the fields of a line of rainfall data the same way as
+//           sscanf would but without its overhead.
+//
+//  Note:    only formats made of white space, other characters to be
+//           matched, and the conversions %d, %ld (both with an optional
+//           field width), %f, %c and %s are supported.
+//
+{
+    va_list ap;
+    int     n = 0;
+    int     width, isLong, digits, sign;
+    int     matched = TRUE;
+    char    type;
+    char*   t;
+    long    v;
+    float   x;
+
+    va_start(ap, fmt);
+    while ( *fmt )
+    {
+        // --- white space in format matches any amount of white space
+        if ( isspace((unsigned char)*fmt) )
+        {
+            while ( isspace((unsigned char)*s) ) s++;
+            fmt++;
+            continue;
+        }
+
+        // --- any other character except % must be matched
+        if ( *fmt != '%' )
+        {
+            if ( *s == '\0' && n == 0 ) n = EOF;
+            if ( *s != *fmt ) break;
+            s++;
+            fmt++;
+            continue;
+        }
+
+        // --- read field width & type of conversion
+        fmt++;
+        width = 0;
+        while ( isdigit((unsigned char)*fmt) )
+        {
+            width = 10 * width + (*fmt - '0');
+            fmt++;
+        }
+        isLong = ( *fmt == 'l' );
+        if ( isLong ) fmt++;
+        type = *fmt++;
+
+        // --- all conversions but %c skip leading white space
+        if ( type != 'c' ) while ( isspace((unsigned char)*s) ) s++;
+        if ( *s == '\0' )
+        {
+            if ( n == 0 ) n = EOF;
+            break;
+        }
+
+        switch ( type )
+        {
+          case 'd':
+            if ( width == 0 ) width = MAXLINE;
+            t = s;
+            sign = 1;
+            if ( *t == '-' || *t == '+' )
+            {
+                if ( *t == '-' ) sign = -1;
+                t++;
+                width--;
+            }
+            v = 0;
+            digits = 0;
+            while ( width > 0 && isdigit((unsigned char)*t) )
+            {
+                v = 10 * v + (*t - '0');
+                t++;
+                width--;
+                digits++;
+            }
+            if ( digits == 0 )
+            {
+                matched = FALSE;
+                break;
+            }
+            if ( isLong ) *va_arg(ap, long*) = sign * v;
+            else          *va_arg(ap, int*) = (int)(sign * v);
+            s = t;
+            break;
+
+          case 'f':
+            x = strtof(s, &t);
+            if ( t == s )
+            {
+                matched = FALSE;
+                break;
+            }
+            *va_arg(ap, float*) = x;
+            s = t;
+            break;
+
+          case 'c':
+            *va_arg(ap, char*) = *s++;
+            break;
+
+          case 's':
+            t = va_arg(ap, char*);
+            while ( *s && !isspace((unsigned char)*s) ) *t++ = *s++;
+            *t = '\0';
+            break;
+
+          default:
+            matched = FALSE;
+        }
+        if ( !matched ) break;
+        n++;
+    }
+    va_end(ap);
+    return n;
+}
+
+//=============================================================================
+
+int fillBuffer(int i, long long pos)
+//
+//  Input:   i = rain gage index
+//           pos = file position of a gage's rain record
+//  Output:  returns TRUE if any records were read, FALSE if not
+//  Purpose: reads a block of a gage's rain records, starting with the
+//           one at pos, into the gage's read cursor.
+//
+{
+    TRainCursor* cursor = &Cursors[i];
+    long long    n = (Gage[i].endFilePos - Gage[i].startFilePos) /
+                     RAIN_RECORD_SIZE;
+
+    // --- allocate buffer for a block of records (or fewer if the
+    //     gage doesn't have that many)
+    if ( cursor->buffer == NULL )
+    {
+        cursor->size = (int)MIN(n, RAIN_BLOCK_SIZE);
+        if ( cursor->size <= 0 ) return FALSE;
+        cursor->buffer = (char *) malloc(cursor->size * RAIN_RECORD_SIZE);
+        if ( cursor->buffer == NULL ) return FALSE;
     }
+
+    // --- read as many records as buffer holds up to end of gage's data
+    n = (Gage[i].endFilePos - pos) / RAIN_RECORD_SIZE;
+    if ( n > cursor->size ) n = cursor->size;
+    _fseeki64(Frain.file, pos, SEEK_SET);
+    cursor->start = pos;
+    cursor->count = (int)fread(cursor->buffer, RAIN_RECORD_SIZE, (size_t)n,
+                               Frain.file);
+    return cursor->count > 0;
 }
 //=============================================================================
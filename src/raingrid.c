@@ -0,0 +1,551 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   raingrid.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   Gridded (e.g., radar) rainfall.
+//
+//   A rain gage whose data source is GRID reads a sequence of rainfall grids
+//   from a binary file instead of a single value per time period. Each
+//   subcatchment that uses the gage is given the weights of the grid cells
+//   it covers in the [GRIDWEIGHTS] section of the input file:
+//       Subcatch  Row  Column  Fraction
+//   where Fraction is the fraction of the subcatchment's area lying in the
+//   cell (default 1.0). The weights of each subcatchment are scaled to sum
+//   to 1 and stored as a sparse matrix (one row per subcatchment) when the
+//   project is validated. Each grid read from the file is then turned into
+//   the rainfall on all of the gage's subcatchments with one sparse
+//   matrix-vector product. The gage's own rainfall is the area-weighted
+//   mean of its subcatchments' rainfall (or the mean of all grid cells if
+//   no subcatchment uses the gage) and drives the wet/dry time step, the
+//   gage's reported results and any RDII that uses the gage.
+//
+//   The layout of a rainfall grid file is:
+//     File stamp ("SWMM5-GRID") (10 bytes)
+//     Number of rows in grid (4-byte int)
+//     Number of columns in grid (4-byte int)
+//     For each time period with rainfall:
+//       Date/time for start of period (8-byte double)
+//       Rain value of each cell, row by row (4-byte floats)
+//   Rain values are intensities or volumes (as set by the gage's rain type)
+//   in the project's units. Negative values (missing data) count as no rain.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "headers.h"
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+static const char FileStamp[] = "SWMM5-GRID";
+
+enum GridFrameType {CURRENT_FRAME, NO_FRAME, NEXT_FRAME};
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    int        subcatch;          // subcatchment index
+    int        row;               // grid row (starting from 1)
+    int        col;               // grid column (starting from 1)
+    double     fraction;          // fraction of subcatchment area in cell
+}  TGridWeight;
+
+typedef struct
+{
+    FILE*      file;              // rainfall grid file
+    int        nRows;             // number of grid rows
+    int        nCols;             // number of grid columns
+    int        nSubcatch;         // number of subcatchments using grid
+    double*    areaFrac;          // fraction of total area of each subcatch
+    int*       rowStart;          // start of each subcatch's cell weights
+    int*       cell;              // grid cell of each weight
+    double*    weight;            // weight of each cell
+    float*     frame;             // cell values of last grid read
+    double*    curRain;           // subcatch rainfall for current grid
+    double*    nextRain;          // subcatch rainfall for next grid
+    int        reportFrame;       // grid used for reported rainfall
+}  TRainGrid;
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TGridWeight* Weights;      // cell weights read from input file
+static int          NumWeights;   // number of cell weights
+static int          WeightSize;   // capacity of Weights array
+static TRainGrid*   Grids;        // grid data for each rain gage
+static int*         GridEntry;    // position of each subcatch in its grid
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  raingrid_readWeights     (called by parseLine in input.c)
+//  raingrid_validate        (called by project_validate)
+//  raingrid_delete          (called by project_close)
+//  raingrid_initState       (called by gage_initState)
+//  raingrid_readFrame       (called by getFirstRainfall & getNextRainfall)
+//  raingrid_swapFrames      (called by gage_initState & gage_setState)
+//  raingrid_getRainfall     (called by gage_getPrecip)
+//  raingrid_setReportDate   (called by gage_setReportRainfall)
+//  raingrid_getReportRainfall (called by subcatch_getResults)
+//  raingrid_snapshot        (called by copyState in snapshot.c)
+
+//-----------------------------------------------------------------------------
+//  Local functions
+//-----------------------------------------------------------------------------
+static int  openGrid(int j);
+static int  createWeights(int j);
+
+//=============================================================================
+
+int raingrid_readWeights(char* tok[], int ntoks)
+//
+//  Input:   tok[] = array of string tokens
+//           ntoks = number of tokens
+//  Output:  returns an error code
+//  Purpose: reads the weight of a rainfall grid cell for a subcatchment
+//           from a line of input data.
+//
+//  Data format is:
+//    Subcatch  Row  Column  (Fraction)
+//
+{
+    int    j, row, col;
+    double fraction = 1.0;
+    TGridWeight* w;
+
+    // --- check for enough tokens & an existing subcatchment
+    if ( ntoks < 3 ) return error_setInpError(ERR_ITEMS, "");
+    j = project_findObject(SUBCATCH, tok[0]);
+    if ( j < 0 ) return error_setInpError(ERR_NAME, tok[0]);
+
+    // --- read cell's row & column and fraction of area in it
+    if ( !getInt(tok[1], &row) || row < 1 )
+        return error_setInpError(ERR_NUMBER, tok[1]);
+    if ( !getInt(tok[2], &col) || col < 1 )
+        return error_setInpError(ERR_NUMBER, tok[2]);
+    if ( ntoks > 3 && (!getDouble(tok[3], &fraction) || fraction < 0.0) )
+        return error_setInpError(ERR_NUMBER, tok[3]);
+
+    // --- add weight to list of weights
+    if ( NumWeights == WeightSize )
+    {
+        WeightSize = (WeightSize == 0) ? 64 : 2 * WeightSize;
+        w = (TGridWeight *) realloc(Weights, WeightSize * sizeof(TGridWeight));
+        if ( w == NULL ) return error_setInpError(ERR_MEMORY, "");
+        Weights = w;
+    }
+    w = &Weights[NumWeights];
+    w->subcatch = j;
+    w->row = row;
+    w->col = col;
+    w->fraction = fraction;
+    NumWeights++;
+    return 0;
+}
+
+//=============================================================================
+
+void raingrid_validate(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: opens the grid file of each gridded rain gage and creates the
+//           sparse matrix of cell weights for the gage's subcatchments.
+//
+{
+    int j;
+
+    for (j = 0; j < Nobjects[GAGE]; j++)
+    {
+        if ( Gage[j].dataSource != RAIN_GRID ) continue;
+        if ( Grids == NULL )
+        {
+            Grids = (TRainGrid *) calloc(Nobjects[GAGE], sizeof(TRainGrid));
+            GridEntry = (int *) calloc(Nobjects[SUBCATCH] + 1, sizeof(int));
+            if ( Grids == NULL || GridEntry == NULL )
+            {
+                report_writeErrorMsg(ERR_MEMORY, "");
+                return;
+            }
+        }
+        if ( openGrid(j) ) createWeights(j);
+        if ( ErrorCode ) return;
+    }
+}
+
+//=============================================================================
+
+void raingrid_delete(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: closes all rainfall grid files and frees memory they use.
+//
+{
+    int j;
+    TRainGrid* grid;
+
+    if ( Grids )
+    {
+        for (j = 0; j < Nobjects[GAGE]; j++)
+        {
+            grid = &Grids[j];
+            if ( grid->file ) fclose(grid->file);
+            FREE(grid->areaFrac);
+            FREE(grid->rowStart);
+            FREE(grid->cell);
+            FREE(grid->weight);
+            FREE(grid->frame);
+            FREE(grid->curRain);
+            FREE(grid->nextRain);
+        }
+        FREE(Grids);
+    }
+    FREE(GridEntry);
+    FREE(Weights);
+    NumWeights = 0;
+    WeightSize = 0;
+}
+
+//=============================================================================
+
+void raingrid_initState(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  none
+//  Purpose: positions a gage's rainfall grid file at its first grid.
+//
+{
+    TRainGrid* grid = &Grids[j];
+    int i;
+
+    if ( grid->file == NULL ) return;
+    _fseeki64(grid->file, strlen(FileStamp) + 2 * sizeof(int), SEEK_SET);
+    for (i = 0; i < grid->nSubcatch; i++)
+    {
+        grid->curRain[i] = 0.0;
+        grid->nextRain[i] = 0.0;
+    }
+    grid->reportFrame = NO_FRAME;
+}
+
+//=============================================================================
+
+int raingrid_readFrame(int j, DateTime* date, double scale, double* mean)
+//
+//  Input:   j = rain gage index
+//           scale = factor that converts grid values to rainfall intensity
+//  Output:  date = start date of grid's time period
+//           mean = area-weighted mean rainfall over gage's subcatchments
+//                  (or mean over all grid cells if it has none)
+//           returns TRUE if a grid was read, FALSE if at end of file
+//  Purpose: reads the next grid from a gage's rainfall grid file and
+//           computes the rainfall it places on each of the gage's
+//           subcatchments.
+//
+{
+    TRainGrid* grid = &Grids[j];
+    int    i, k;
+    size_t n = (size_t)grid->nRows * grid->nCols;
+    float  v;
+    double r;
+
+    // --- read grid's date & cell values
+    *mean = 0.0;
+    if ( grid->file == NULL ) return FALSE;
+    if ( fread(date, sizeof(DateTime), 1, grid->file) != 1 ) return FALSE;
+    if ( fread(grid->frame, sizeof(float), n, grid->file) != n ) return FALSE;
+
+    // --- a gage that no subcatchment uses (e.g., one used only by RDII
+    //     unit hydrographs) gets the mean rainfall of all grid cells
+    if ( grid->nSubcatch == 0 )
+    {
+        r = 0.0;
+        for (k = 0; k < (int)n; k++)
+        {
+            v = grid->frame[k];
+            if ( v > 0.0f ) r += v;
+        }
+        *mean = scale * r / n;
+        return TRUE;
+    }
+
+    // --- multiply cell values by each subcatchment's cell weights
+    for (i = 0; i < grid->nSubcatch; i++)
+    {
+        r = 0.0;
+        for (k = grid->rowStart[i]; k < grid->rowStart[i+1]; k++)
+        {
+            v = grid->frame[grid->cell[k]];
+            if ( v > 0.0f ) r += grid->weight[k] * v;
+        }
+        r *= scale;
+        grid->nextRain[i] = r;
+        *mean += grid->areaFrac[i] * r;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void raingrid_swapFrames(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  none
+//  Purpose: makes a gage's next grid of subcatchment rainfall its current
+//           one (and vice versa).
+//
+{
+    TRainGrid* grid = &Grids[j];
+    double*    r = grid->curRain;
+
+    grid->curRain = grid->nextRain;
+    grid->nextRain = r;
+}
+
+//=============================================================================
+
+double raingrid_getRainfall(int j, int i)
+//
+//  Input:   j = rain gage index
+//           i = subcatchment index
+//  Output:  returns current rainfall on subcatchment (in/hr or mm/hr)
+//  Purpose: retrieves the rainfall a gridded rain gage places on one of
+//           its subcatchments.
+//
+{
+    if ( Gage[j].rainfall == 0.0 ) return 0.0;
+    return Grids[j].curRain[GridEntry[i]];
+}
+
+//=============================================================================
+
+void raingrid_setReportDate(int j, DateTime reportDate)
+//
+//  Input:   j = rain gage index
+//           reportDate = date/time value of current reporting time
+//  Output:  none
+//  Purpose: selects which of a gridded rain gage's grids supplies the
+//           rainfall reported for its subcatchments.
+//
+//  Note: the choice is the one made for the gage's own reported rainfall
+//        by gage_setReportRainfall (which has already added a second to
+//        reportDate).
+//
+{
+    TRainGrid* grid = &Grids[j];
+
+    if ( reportDate < Gage[j].endDate ) grid->reportFrame = CURRENT_FRAME;
+    else if ( reportDate < Gage[j].nextDate ) grid->reportFrame = NO_FRAME;
+    else grid->reportFrame = NEXT_FRAME;
+}
+
+//=============================================================================
+
+double raingrid_getReportRainfall(int j, int i)
+//
+//  Input:   j = rain gage index
+//           i = subcatchment index
+//  Output:  returns rainfall reported for subcatchment (in/hr or mm/hr)
+//  Purpose: retrieves the rainfall on a subcatchment at the current
+//           reporting time from its gridded rain gage.
+//
+{
+    TRainGrid* grid = &Grids[j];
+
+    switch ( grid->reportFrame )
+    {
+      case CURRENT_FRAME:
+        if ( Gage[j].rainfall == 0.0 ) return 0.0;
+        return grid->curRain[GridEntry[i]];
+      case NEXT_FRAME:
+        if ( Gage[j].nextRainfall == 0.0 ) return 0.0;
+        return grid->nextRain[GridEntry[i]];
+      default: return 0.0;
+    }
+}
+
+//=============================================================================
+
+void raingrid_snapshot(void)
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of the rainfall grids in a
+//           simulation state snapshot.
+//
+{
+    int j;
+    TRainGrid* grid;
+
+    if ( Grids == NULL ) return;
+    for (j = 0; j < Nobjects[GAGE]; j++)
+    {
+        grid = &Grids[j];
+        if ( grid->file == NULL ) continue;
+        snapshot_copy(grid->curRain, grid->nSubcatch * sizeof(double));
+        snapshot_copy(grid->nextRain, grid->nSubcatch * sizeof(double));
+        snapshot_copy(&grid->reportFrame, sizeof(int));
+        snapshot_copyFilePos(grid->file);
+    }
+}
+
+//=============================================================================
+
+int openGrid(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: opens a gage's rainfall grid file and reads its dimensions.
+//
+{
+    TRainGrid* grid = &Grids[j];
+    char  fStamp[] = "SWMM5-GRID";
+    int   n[2];
+
+    grid->file = fopen(Gage[j].fname, "rb");
+    if ( grid->file == NULL )
+    {
+        report_writeErrorMsg(ERR_RAIN_FILE_DATA, Gage[j].fname);
+        return FALSE;
+    }
+    if ( fread(fStamp, sizeof(char), strlen(FileStamp), grid->file) !=
+             strlen(FileStamp) ||
+         strcmp(fStamp, FileStamp) != 0 ||
+         fread(n, sizeof(int), 2, grid->file) != 2 ||
+         n[0] <= 0 || n[1] <= 0 )
+    {
+        report_writeErrorMsg(ERR_RAIN_FILE_FORMAT, Gage[j].fname);
+        return FALSE;
+    }
+    grid->nRows = n[0];
+    grid->nCols = n[1];
+    grid->frame = (float *) malloc((size_t)n[0] * n[1] * sizeof(float));
+    if ( grid->frame == NULL )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int createWeights(int j)
+//
+//  Input:   j = rain gage index
+//  Output:  returns TRUE if successful, FALSE if not
+//  Purpose: creates the sparse matrix of grid cell weights for the
+//           subcatchments that use a gridded rain gage.
+//
+{
+    TRainGrid* grid = &Grids[j];
+    int    i, k, m, n;
+    int*   pos;
+    double total, area;
+
+    // --- assign each subcatchment using gage a row of the matrix
+    n = 0;
+    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    {
+        if ( Subcatch[i].gage == j ) GridEntry[i] = n++;
+    }
+
+    // --- allocate memory
+    grid->nSubcatch = n;
+    grid->areaFrac = (double *) calloc(n + 1, sizeof(double));
+    grid->rowStart = (int *) calloc(n + 1, sizeof(int));
+    grid->curRain = (double *) calloc(n + 1, sizeof(double));
+    grid->nextRain = (double *) calloc(n + 1, sizeof(double));
+    pos = (int *) calloc(n + 1, sizeof(int));
+    if ( !grid->areaFrac || !grid->rowStart || !grid->curRain ||
+         !grid->nextRain || !pos )
+    {
+        FREE(pos);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+
+    // --- find where each row's cell weights start
+    for (k = 0; k < NumWeights; k++)
+    {
+        i = Weights[k].subcatch;
+        if ( Subcatch[i].gage == j ) pos[GridEntry[i]+1]++;
+    }
+    for (n = 0; n < grid->nSubcatch; n++) pos[n+1] += pos[n];
+    m = pos[grid->nSubcatch];
+    for (n = 0; n <= grid->nSubcatch; n++) grid->rowStart[n] = pos[n];
+    grid->cell = (int *) calloc(m + 1, sizeof(int));
+    grid->weight = (double *) calloc(m + 1, sizeof(double));
+    if ( !grid->cell || !grid->weight )
+    {
+        FREE(pos);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
+
+    // --- place each cell weight in its subcatchment's row
+    for (k = 0; k < NumWeights; k++)
+    {
+        i = Weights[k].subcatch;
+        if ( Subcatch[i].gage != j ) continue;
+        if ( Weights[k].row > grid->nRows || Weights[k].col > grid->nCols )
+        {
+            FREE(pos);
+            report_writeErrorMsg(ERR_RAIN_GRID, Subcatch[i].ID);
+            return FALSE;
+        }
+        m = pos[GridEntry[i]]++;
+        grid->cell[m] = (Weights[k].row - 1) * grid->nCols +
+                        Weights[k].col - 1;
+        grid->weight[m] = Weights[k].fraction;
+    }
+    FREE(pos);
+
+    // --- scale each subcatchment's weights so that they sum to 1
+    area = 0.0;
+    for (i = 0; i < Nobjects[SUBCATCH]; i++)
+    {
+        if ( Subcatch[i].gage != j ) continue;
+        n = GridEntry[i];
+        total = 0.0;
+        for (k = grid->rowStart[n]; k < grid->rowStart[n+1]; k++)
+        {
+            total += grid->weight[k];
+        }
+        if ( total <= 0.0 )
+        {
+            report_writeErrorMsg(ERR_RAIN_GRID, Subcatch[i].ID);
+            return FALSE;
+        }
+        for (k = grid->rowStart[n]; k < grid->rowStart[n+1]; k++)
+        {
+            grid->weight[k] /= total;
+        }
+        grid->areaFrac[n] = Subcatch[i].area;
+        area += Subcatch[i].area;
+    }
+
+    // --- find each subcatchment's share of the gage's total area
+    for (n = 0; n < grid->nSubcatch; n++)
+    {
+        if ( area > 0.0 ) grid->areaFrac[n] /= area;
+        else grid->areaFrac[n] = 1.0 / grid->nSubcatch;
+    }
+    return TRUE;
+}
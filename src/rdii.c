@@ -27,10 +27,19 @@
 //   Note: RDII means rainfall dependent infiltration/inflow,
 //         UH means unit hydrograph.
 //
+//   When no RDII interface file is named the RDII inflows are computed
+//   while the simulation runs, one RDII time step at a time as routing
+//   needs them, instead of being written to a scratch file before it
+//   starts. The rain gages used by the UHs then keep a second state of
+//   their own for RDII processing, which is swapped in while RDII is
+//   computed. Gages with rainfall grids, and time series not held in
+//   arrays, still use a scratch file.
+//
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <math.h>
+#include <stddef.h>
 #include <string.h>
 #include <malloc.h>
 #include "headers.h"
@@ -60,9 +69,12 @@ typedef struct                         // Data for a single unit hydrograph
    char*     pastMonth;                // month in which past rainfall occurred
    int       period;                   // current UH time period
    int       hasPastRain;              // true if > 0 past periods with rain
+   int       nPeriods;                 // periods saved since RDII event began
    int       maxPeriods;               // max. past rainfall periods
    long      drySeconds;               // time since last nonzero rainfall
    double    iaUsed;                   // initial abstraction used (in or mm)
+   double*   ordinates[12];            // UH ordinates x R-value each month
+   int       sameMonths;               // true if all months share ordinates
 }  TUHData;
 
 typedef struct                         // Data for a unit hydrograph group
@@ -90,6 +102,14 @@ static DateTime   RdiiEndDate;         // end date of RDII inflow period
 static double     TotalRainVol;        // total rainfall volume (ft3)
 static double     TotalRdiiVol;        // total RDII volume (ft3)
 static int        RdiiFileType;        // type (binary/text) of RDII file
+static int        RdiiInline;          // TRUE if RDII computed during the run
+static double     RdiiElapsed;         // elapsed time of next RDII step (sec)
+static int        NumRdiiGages;        // number of rain gages used by UHs
+static int*       RdiiGageIndex;       // indexes of rain gages used by UHs
+static TGage*     RdiiGage;            // RDII processing state of UH gages
+static int*       RdiiSeriesPoint;     // position in UH gages' time series
+
+static const size_t RdiiGagePtrs[] = {offsetof(TGage, ID)};
 
 //-----------------------------------------------------------------------------
 // Imported Variables
@@ -114,6 +134,8 @@ const double Qcf[6] =                  // Flow Conversion Factors:
 //  rdii_closeRdii          (called from rain_close)
 //  rdii_getNumRdiiFlows    (called from addRdiiInflows in routing.c)
 //  rdii_getRdiiFlow        (called from addRdiiInflows in routing.c)
+//  rdii_snapshot           (called from copyState in snapshot.c)
+//  rdii_reportStats        (called from swmm_end in swmm5.c)
 
 //-----------------------------------------------------------------------------
 // Function Declarations
@@ -129,16 +151,24 @@ static void   openRdiiProcessor(void);
 static int    allocRdiiMemory(void);
 static int    getRainInterval(int i);
 static int    getMaxPeriods(int i, int k);
+static int    setOrdinates(int i, int k);
+static int    sameUnitHyd(int i, int k, int m1, int m2);
+static void   freeOrdinates(TUHData* uh);
 static void   initGageData(void);
 static void   initUnitHydData(void);
 static int    openNewRdiiFile(void);
+static int    canComputeInline(void);
+static void   openInlineRdii(void);
+static void   readInlineFlows(void);
+static void   swapGageStates(void);
+static void   copyInlineState(void);
 static void   getRainfall(DateTime currentDate);
 
 static double applyIA(int j, int k, DateTime aDate, double dt,
               double rainDepth);
 static void   updateDryPeriod(int j, int k, double rain, int gageInterval);
 static void   getUnitHydRdii(DateTime currentDate);
-static double getUnitHydConvol(int j, int k, int gageInterval);
+static double getUnitHydConvol(int j, int k);
 static double getUnitHydOrd(int j, int m, int k, double t);
 
 static int    getNodeRdii(void);
@@ -427,10 +457,13 @@ void rdii_openRdii()
     NumRdiiNodes = 0;
     RdiiStartDate = NO_DATE;
 
+    RdiiInline = FALSE;
+
     // --- create the RDII file if existing file not being used
+    //     (or prepare to compute RDII during the run)
     if ( IgnoreRDII ) return;                                                  //(5.1.004)
     if ( Frdii.mode != USE_FILE ) createRdiiFile();
-    if ( Frdii.mode == NO_FILE || ErrorCode ) return;
+    if ( Frdii.mode == NO_FILE || RdiiInline || ErrorCode ) return;
 
     // --- try to open the RDII file in binary mode
     Frdii.file = fopen(Frdii.name, "rb");
@@ -511,12 +544,38 @@ void rdii_closeRdii()
 {
     if ( Frdii.file ) fclose(Frdii.file);
     if ( Frdii.mode == SCRATCH_FILE ) remove(Frdii.name);
+    if ( RdiiInline )
+    {
+        freeRdiiMemory();
+        FREE(RdiiGageIndex);
+        FREE(RdiiGage);
+        FREE(RdiiSeriesPoint);
+        RdiiInline = FALSE;
+    }
     FREE(RdiiNodeIndex);
     FREE(RdiiNodeFlow);
 }
 
 //=============================================================================
 
+void rdii_reportStats()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: writes the rainfall & RDII totals to the report file when RDII
+//           was computed during the run.
+//
+//  Note:    RDII is first computed for the rest of the simulation period,
+//           so the totals are the same as when it is computed beforehand.
+//
+{
+    if ( !RdiiInline || ErrorCode ) return;
+    while ( RdiiStartDate != NO_DATE && !ErrorCode ) readInlineFlows();
+    if ( !ErrorCode ) report_writeRdiiStats(TotalRainVol, TotalRdiiVol);
+}
+
+//=============================================================================
+
 int rdii_getNumRdiiFlows(DateTime aDate)
 //
 //  Input:   aDate = current date/time
@@ -526,6 +585,18 @@ int rdii_getNumRdiiFlows(DateTime aDate)
 {
     // --- default result is 0 indicating no RDII inflow at specified date
     if ( NumRdiiNodes == 0 ) return 0;
+
+    // --- compute RDII at successive time steps as need be
+    if ( RdiiInline )
+    {
+        while ( RdiiStartDate != NO_DATE )
+        {
+            if ( aDate < RdiiStartDate ) return 0;
+            if ( aDate < RdiiEndDate ) return NumRdiiNodes;
+            readInlineFlows();
+        }
+        return 0;
+    }
     if ( !Frdii.file ) return 0;
 
     // --- keep reading RDII file as need be
@@ -565,6 +636,24 @@ void rdii_getRdiiFlow(int i, int* j, double* q)
 
 //=============================================================================
 
+void rdii_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the current RDII inflows and the position
+//           reached in the RDII file in a simulation state snapshot.
+//
+{
+    if ( NumRdiiNodes == 0 || ( !Frdii.file && !RdiiInline ) ) return;
+    snapshot_copy(&RdiiStartDate, sizeof(RdiiStartDate));
+    snapshot_copy(&RdiiEndDate, sizeof(RdiiEndDate));
+    snapshot_copy(RdiiNodeFlow, NumRdiiNodes * sizeof(REAL4));
+    if ( RdiiInline ) copyInlineState();
+    else snapshot_copyFilePos(Frdii.file);
+}
+
+//=============================================================================
+
 int readRdiiFileHeader()
 //
 //  Input:   none
@@ -744,14 +833,21 @@ void createRdiiFile()
         return;
     }
 
-    // --- otherwise set file usage to SCRATCH if originally set to NO_FILE
-    else if ( Frdii.mode == NO_FILE ) Frdii.mode = SCRATCH_FILE;
-
     // --- validate RDII data
     validateRdii();
     initGageData();
     if ( ErrorCode ) return;
 
+    // --- compute RDII during the run if no RDII file was named
+    if ( Frdii.mode == NO_FILE && canComputeInline() )
+    {
+        openInlineRdii();
+        return;
+    }
+
+    // --- otherwise set file usage to SCRATCH if originally set to NO_FILE
+    if ( Frdii.mode == NO_FILE ) Frdii.mode = SCRATCH_FILE;
+
     // --- open RDII processing system
     openRdiiProcessor();
     if ( !ErrorCode )
@@ -900,8 +996,8 @@ void openRdiiProcessor()
         return;
     }
 
-    // --- open & initialize RDII file
-    if ( !openNewRdiiFile() )
+    // --- open & initialize RDII file (unless RDII computed during the run)
+    if ( !RdiiInline && !openNewRdiiFile() )
     {
         report_writeErrorMsg(ERR_RDII_FILE_SCRATCH, "");
         return;
@@ -955,6 +1051,7 @@ int  allocRdiiMemory()
                 UHGroup[i].uh[k].pastMonth =
                     (char *) calloc(n, sizeof(char));
                 if ( !UHGroup[i].uh[k].pastMonth ) return FALSE;
+                if ( !setOrdinates(i, k) ) return FALSE;
             }
         }
     }
@@ -1033,6 +1130,94 @@ int  getMaxPeriods(int i, int k)
 
 //=============================================================================
 
+int  setOrdinates(int i, int k)
+//
+//  Input:   i = UH group index
+//           k = UH index
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: computes the ordinates of a UH, multiplied by its R-value, at
+//           the mid-point of each past rainfall period for each month.
+//
+//  Note:    months with the same UH parameters share one set of ordinates.
+//
+{
+    int     m, m2, p;
+    int     n = UHGroup[i].uh[k].maxPeriods;
+    int     ri = UHGroup[i].rainInterval;
+    double* u;
+    TUHData* uh = &UHGroup[i].uh[k];
+
+    uh->sameMonths = TRUE;
+    for (m=0; m<12; m++)
+    {
+        // --- re-use ordinates of an earlier month with the same UH
+        for (m2=0; m2<m; m2++)
+        {
+            if ( sameUnitHyd(i, k, m, m2) ) break;
+        }
+        if ( m2 < m )
+        {
+            uh->ordinates[m] = uh->ordinates[m2];
+            if ( m2 > 0 ) uh->sameMonths = FALSE;
+            continue;
+        }
+        if ( m > 0 ) uh->sameMonths = FALSE;
+
+        // --- ordinate of period p is found at time (p - 1/2) * ri
+        u = (double *) calloc(n, sizeof(double));
+        if ( !u ) return FALSE;
+        for (p=1; p<n; p++)
+        {
+            u[p] = getUnitHydOrd(i, m, k, ((double)(p) - 0.5) * (double)ri) *
+                   UnitHyd[i].r[m][k];
+        }
+        uh->ordinates[m] = u;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int  sameUnitHyd(int i, int k, int m1, int m2)
+//
+//  Input:   i = UH group index
+//           k = UH index
+//           m1, m2 = month indexes
+//  Output:  returns TRUE if the UH has the same shape & R-value in both
+//           months
+//  Purpose: checks if two months of a UH have the same ordinates.
+//
+{
+    return UnitHyd[i].tBase[m1][k] == UnitHyd[i].tBase[m2][k] &&
+           UnitHyd[i].tPeak[m1][k] == UnitHyd[i].tPeak[m2][k] &&
+           UnitHyd[i].r[m1][k] == UnitHyd[i].r[m2][k];
+}
+
+//=============================================================================
+
+void freeOrdinates(TUHData* uh)
+//
+//  Input:   uh = UH data
+//  Output:  none
+//  Purpose: frees the UH's ordinates, once for each set shared by several
+//           months.
+//
+{
+    int m, m2;
+
+    for (m=0; m<12; m++)
+    {
+        for (m2=0; m2<m; m2++)
+        {
+            if ( uh->ordinates[m2] == uh->ordinates[m] ) break;
+        }
+        if ( m2 == m ) free(uh->ordinates[m]);
+    }
+    for (m=0; m<12; m++) uh->ordinates[m] = NULL;
+}
+
+//=============================================================================
+
 void initGageData()
 //
 //  Input:   none
@@ -1100,6 +1285,7 @@ void initUnitHydData()
                 (UHGroup[i].uh[k].maxPeriods * UHGroup[i].rainInterval) + 1;
             UHGroup[i].uh[k].period = UHGroup[i].uh[k].maxPeriods + 1;
             UHGroup[i].uh[k].hasPastRain = FALSE;
+            UHGroup[i].uh[k].nPeriods = 0;
 
             // --- assign initial abstraction used
             UHGroup[i].uh[k].iaUsed = UnitHyd[i].iaInit[month][k];
@@ -1165,6 +1351,211 @@ int openNewRdiiFile()
 
 //=============================================================================
 
+int canComputeInline()
+//
+//  Input:   none
+//  Output:  returns TRUE if RDII can be computed during the run
+//  Purpose: checks that the rain gages used by the UHs can keep a state of
+//           their own for RDII processing.
+//
+{
+    int i, g, k;
+
+    for (i = 0; i < Nobjects[UNITHYD]; i++)
+    {
+        g = UnitHyd[i].rainGage;
+        if ( g < 0 ) continue;
+        if ( Gage[g].dataSource == RAIN_GRID ) return FALSE;
+        k = Gage[g].tSeries;
+        if ( Gage[g].dataSource == RAIN_TSERIES && k >= 0 &&
+             Tseries[k].xData == NULL ) return FALSE;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void openInlineRdii()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: prepares to compute RDII during the run and computes the first
+//           set of RDII inflows.
+//
+{
+    int i, g, n;
+
+    // --- open RDII processing system without a RDII file
+    RdiiInline = TRUE;
+    RdiiGageIndex = NULL;
+    RdiiGage = NULL;
+    RdiiSeriesPoint = NULL;
+    NumRdiiGages = 0;
+    openRdiiProcessor();
+    if ( ErrorCode ) return;
+    initUnitHydData();
+    RdiiElapsed = 0.0;
+
+    // --- list the rain gages used by the UHs
+    RdiiGageIndex = (int *) calloc(Nobjects[GAGE], sizeof(int));
+    if ( !RdiiGageIndex )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
+    }
+    for (i = 0; i < Nobjects[UNITHYD]; i++)
+    {
+        g = UnitHyd[i].rainGage;
+        if ( g < 0 ) continue;
+        for (n = 0; n < NumRdiiGages; n++)
+        {
+            if ( RdiiGageIndex[n] == g ) break;
+        }
+        if ( n == NumRdiiGages ) RdiiGageIndex[NumRdiiGages++] = g;
+    }
+
+    // --- save the gages' initial state for RDII processing
+    //     (the gages are initialized again for runoff by project_init)
+    if ( NumRdiiGages > 0 )
+    {
+        RdiiGage = (TGage *) calloc(NumRdiiGages, sizeof(TGage));
+        RdiiSeriesPoint = (int *) calloc(NumRdiiGages, sizeof(int));
+        if ( !RdiiGage || !RdiiSeriesPoint )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return;
+        }
+    }
+    for (n = 0; n < NumRdiiGages; n++)
+    {
+        g = RdiiGageIndex[n];
+        RdiiGage[n] = Gage[g];
+        if ( Gage[g].dataSource == RAIN_TSERIES && Gage[g].tSeries >= 0 )
+            RdiiSeriesPoint[n] = Tseries[Gage[g].tSeries].thisPoint;
+    }
+
+    // --- compute the first set of RDII inflows
+    readInlineFlows();
+}
+
+//=============================================================================
+
+void readInlineFlows()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: computes RDII inflows at successive RDII time steps until one
+//           with some RDII inflow is reached (in place of reading the next
+//           set of RDII inflows from a RDII file).
+//
+{
+    int      hasRdii = FALSE;          // true when total RDII > 0
+    double   duration;                 // duration being analyzed (sec)
+    double   rainFactor;               // current rainfall adjustment factor
+    DateTime currentDate = NO_DATE;    // current calendar date/time
+
+    RdiiStartDate = NO_DATE;
+    RdiiEndDate = NO_DATE;
+    duration = TotalDuration / 1000.0;
+    if ( RdiiElapsed > duration ) return;
+
+    // --- switch rain gages to their RDII processing state
+    rainFactor = Adjust.rainFactor;
+    swapGageStates();
+
+    // --- same steps as when a RDII file is created
+    while ( RdiiElapsed <= duration && !ErrorCode && !hasRdii )
+    {
+        currentDate = StartDateTime + RdiiElapsed / SECperDAY;
+        getRainfall(currentDate);
+        getUnitHydRdii(currentDate);
+        hasRdii = getNodeRdii();
+        RdiiElapsed += RdiiStep;
+    }
+
+    // --- restore the rain gages' state for runoff
+    swapGageStates();
+    Adjust.rainFactor = rainFactor;
+
+    if ( hasRdii )
+    {
+        RdiiStartDate = currentDate;
+        RdiiEndDate = datetime_addSeconds(RdiiStartDate, RdiiStep);
+    }
+}
+
+//=============================================================================
+
+void swapGageStates()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: exchanges the current state of the rain gages used by UHs
+//           (including their position in any time series) with the state
+//           saved for the other of runoff or RDII processing.
+//
+{
+    int   n, g, k, p;
+    TGage gage;
+
+    for (n = 0; n < NumRdiiGages; n++)
+    {
+        g = RdiiGageIndex[n];
+        gage = Gage[g];
+        Gage[g] = RdiiGage[n];
+        RdiiGage[n] = gage;
+        k = Gage[g].tSeries;
+        if ( Gage[g].dataSource == RAIN_TSERIES && k >= 0 )
+        {
+            p = Tseries[k].thisPoint;
+            Tseries[k].thisPoint = RdiiSeriesPoint[n];
+            RdiiSeriesPoint[n] = p;
+        }
+    }
+}
+
+//=============================================================================
+
+void copyInlineState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of RDII processing during the run
+//           in a simulation state snapshot.
+//
+{
+    int       j, k;
+    TUHGroup* group;
+    TUHData*  uh;
+
+    snapshot_copy(&RdiiElapsed, sizeof(RdiiElapsed));
+    snapshot_copy(&TotalRainVol, sizeof(TotalRainVol));
+    snapshot_copy(&TotalRdiiVol, sizeof(TotalRdiiVol));
+    snapshot_copyObjects(RdiiGage, NumRdiiGages, sizeof(TGage),
+                         RdiiGagePtrs, 1);
+    snapshot_copy(RdiiSeriesPoint, NumRdiiGages * sizeof(int));
+    for (j = 0; j < Nobjects[UNITHYD]; j++)
+    {
+        group = &UHGroup[j];
+        snapshot_copy(&group->rdii, sizeof(group->rdii));
+        snapshot_copy(&group->gageDate, sizeof(group->gageDate));
+        snapshot_copy(&group->lastDate, sizeof(group->lastDate));
+        for (k = 0; k < 3; k++)
+        {
+            uh = &group->uh[k];
+            snapshot_copy(&uh->period, sizeof(uh->period));
+            snapshot_copy(&uh->hasPastRain, sizeof(uh->hasPastRain));
+            snapshot_copy(&uh->nPeriods, sizeof(uh->nPeriods));
+            snapshot_copy(&uh->drySeconds, sizeof(uh->drySeconds));
+            snapshot_copy(&uh->iaUsed, sizeof(uh->iaUsed));
+            snapshot_copy(uh->pastRain, uh->maxPeriods * sizeof(double));
+            snapshot_copy(uh->pastMonth, uh->maxPeriods * sizeof(char));
+        }
+    }
+}
+
+//=============================================================================
+
 void getRainfall(DateTime currentDate)
 //
 //  Input:   currentDate = current calendar date/time
@@ -1225,6 +1616,8 @@ void getRainfall(DateTime currentDate)
                 UHGroup[j].uh[k].pastRain[i] = excessDepth;
                 UHGroup[j].uh[k].pastMonth[i] = (char)month;
                 UHGroup[j].uh[k].period = i + 1;
+                if ( UHGroup[j].uh[k].nPeriods < UHGroup[j].uh[k].maxPeriods )
+                    UHGroup[j].uh[k].nPeriods++;
             }
 
             // --- advance rain date by gage recording interval
@@ -1305,6 +1698,7 @@ void updateDryPeriod(int j, int k, double rainDepth, int rainInterval)
                 UHGroup[j].uh[k].pastRain[i] = 0.0;
             }
             UHGroup[j].uh[k].period = 0;
+            UHGroup[j].uh[k].nPeriods = 0;
         }
         UHGroup[j].uh[k].drySeconds = 0;
         UHGroup[j].uh[k].hasPastRain = TRUE; 
@@ -1334,9 +1728,12 @@ void getUnitHydRdii(DateTime currentDate)
 {
     int   j;                           // UH group index
     int   k;                           // UH index
-    int   rainInterval;                // rainfall time interval (sec)
 
     // --- examine each UH group
+    //     (each group only updates its own data so groups can be
+    //      processed in parallel)
+#pragma omp parallel for num_threads(NumThreads) schedule(dynamic, 16) \
+        private(k)
     for (j=0; j<Nobjects[UNITHYD]; j++)
     {
         // --- skip calculation if group not used by any RDII node or if
@@ -1348,13 +1745,12 @@ void getUnitHydRdii(DateTime currentDate)
         UHGroup[j].lastDate = UHGroup[j].gageDate;
 
         // --- perform convolution for each UH in the group
-        rainInterval = UHGroup[j].rainInterval;
         UHGroup[j].rdii = 0.0;
         for (k=0; k<3; k++)
         {
             if ( UHGroup[j].uh[k].hasPastRain )
             {
-                UHGroup[j].rdii += getUnitHydConvol(j, k, rainInterval);
+                UHGroup[j].rdii += getUnitHydConvol(j, k);
             }
         }
     }
@@ -1362,52 +1758,64 @@ void getUnitHydRdii(DateTime currentDate)
 
 //=============================================================================
 
-double getUnitHydConvol(int j, int k, int rainInterval)
+double getUnitHydConvol(int j, int k)
 //
 //  Input:   j = UH group index
 //           k = UH index
-//           rainInterval = rainfall time interval (sec)
 //  Output:  returns a RDII flow value
 //  Purpose: computes convolution of Unit Hydrographs with past rainfall.
 //
+//  Note:    the UH ordinates were computed in advance by setOrdinates.
+//           Only the periods between the most recent one with rainfall and
+//           the start of the RDII event are summed. Periods without
+//           rainfall add nothing to the sum, so it is the same as when only
+//           periods with rainfall were summed.
+//
 {
     int    i;                          // previous rainfall period index
-    int    m;                          // month of year index
+    int    n;                          // number of periods before wrap-around
     int    p;                          // UH time period index
+    int    q;                          // period counter
     int    pMax;                       // max. number of periods
-    double t;                          // UH time value (sec)
-    double u;                          // UH ordinate
-    double v;                          // rainfall volume
+    int    pLast;                      // last period since RDII event began
+    double* u;                         // UH ordinates
+    double* v;                         // rainfall volumes
+    char*   m;                         // months of rainfall volumes
     double rdii;                       // RDII flow
     TUHData* uh;                       // UH data
 
-    // --- initialize RDII, rain period index and UH period index
+    // --- initialize RDII, UH period index (skipping the dry periods since
+    //     the last rainfall) and rain period index
     rdii = 0.0;
     uh = &UHGroup[j].uh[k];
-    i = uh->period - 1;
-    if ( i < 0 ) i = uh->maxPeriods - 1;
     pMax = uh->maxPeriods;
-    p = 1;
-
-    // --- evaluate each time period of UH's
-    while ( p < pMax )
+    pLast = MIN(pMax - 1, uh->nPeriods);
+    p = 1 + uh->drySeconds / UHGroup[j].rainInterval;
+    if ( p > pLast ) return 0.0;
+    i = uh->period - p;
+    while ( i < 0 ) i += pMax;
+    v = uh->pastRain;
+    m = uh->pastMonth;
+
+    // --- evaluate each time period of UH's, moving back through the
+    //     past rainfall array in runs that end where its index wraps around
+    while ( p <= pLast )
     {
-        // --- if rain period has rainfall
-        v = uh->pastRain[i];
-        m = uh->pastMonth[i];
-        if ( v > 0.0 )
+        n = MIN(i + 1, pLast + 1 - p);
+        if ( uh->sameMonths )
         {
-            // --- find mid-point time of UH period in seconds
-            t = ((double)(p) - 0.5) * (double)rainInterval;
-
-            // --- convolute rain volume with UH ordinate
-            u = getUnitHydOrd(j, m, k, t) * UnitHyd[j].r[m][k];
-            rdii += u * v;
+            u = uh->ordinates[0] + p;
+            for (q=0; q<n; q++) rdii += u[q] * v[i-q];
+        }
+        else
+        {
+            for (q=0; q<n; q++)
+                rdii += uh->ordinates[(int)m[i-q]][p+q] * v[i-q];
         }
 
         // --- move to next UH period & previous rainfall period
-        p = p + 1;
-        i = i - 1;
+        p = p + n;
+        i = i - n;
         if ( i < 0 ) i = uh->maxPeriods - 1;
     }
     return rdii;
@@ -1537,6 +1945,7 @@ void freeRdiiMemory()
             {
                 FREE(UHGroup[i].uh[k].pastRain);
                 FREE(UHGroup[i].uh[k].pastMonth);
+                freeOrdinates(&UHGroup[i].uh[k]);
             }
         }
         FREE(UHGroup);
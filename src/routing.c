@@ -91,6 +91,7 @@ void routing_close(int routingModel)
 
     // --- free allocated memory
     flowrout_close(routingModel);
+    qualrout_close();
     treatmnt_close();
     FREE(SortedLinks);
 }
@@ -129,13 +130,17 @@ void routing_execute(int routingModel, double routingStep)
     // --- update continuity with current state
     //     applied over 1/2 of time step
     if ( ErrorCode ) return;
+    profile_start(PROF_MASSBAL);
     massbal_updateRoutingTotals(routingStep/2.);
+    profile_stop(PROF_MASSBAL);
 
     // --- evaluate control rules at current date and elapsed time
     currentDate = getDateTime(NewRoutingTime);
     for (j=0; j<Nobjects[LINK]; j++) link_setTargetSetting(j);
+    profile_start(PROF_CONTROLS);
     controls_evaluate(currentDate, currentDate - StartDateTime,
                       routingStep/SECperDAY);
+    profile_stop(PROF_CONTROLS);
     for (j=0; j<Nobjects[LINK]; j++)
     {
         if ( Link[j].targetSetting != Link[j].setting )
@@ -206,7 +211,9 @@ void routing_execute(int routingModel, double routingStep)
     // --- route quality through the drainage network
     if ( Nobjects[POLLUT] > 0 && !IgnoreQuality ) 
     {
+        profile_start(PROF_QUALITY);
         qualrout_execute(routingStep);
+        profile_stop(PROF_QUALITY);
     }
 
     // --- remove evaporation, infiltration & outflows from system
@@ -216,7 +223,9 @@ void routing_execute(int routingModel, double routingStep)
 	
     // --- update continuity with new totals
     //     applied over 1/2 of routing step
+    profile_start(PROF_MASSBAL);
     massbal_updateRoutingTotals(routingStep/2.);
+    profile_stop(PROF_MASSBAL);
 
     // --- update summary statistics
     if ( RptFlags.flowStats && Nobjects[LINK] > 0 )
@@ -45,6 +45,7 @@ extern float* SubcatchResults;         // Results vector defined in OUTPUT.C
 // runoff_open     (called from swmm_start in swmm5.c)
 // runoff_execute  (called from swmm_step in swmm5.c)
 // runoff_close    (called from swmm_end in swmm5.c)
+// runoff_snapshot (called from copyState in snapshot.c)
 
 //-----------------------------------------------------------------------------
 // Local functions
@@ -92,7 +93,10 @@ int runoff_open()
         else runoff_initFile();
         break;
       case SAVE_FILE:
-        if ( (Frunoff.file = fopen(Frunoff.name, "w+b")) == NULL)
+        if ( checkpoint_isResuming() )
+            Frunoff.file = fopen(Frunoff.name, "r+b");
+        else Frunoff.file = fopen(Frunoff.name, "w+b");
+        if ( Frunoff.file == NULL )
             report_writeErrorMsg(ERR_RUNOFF_FILE_OPEN, Frunoff.name);
         else runoff_initFile();
         break;
@@ -131,7 +135,24 @@ void runoff_close()
     }
 
     // --- close climate file if in use
-    if ( Fclimate.file ) fclose(Fclimate.file);
+    climate_closeFile();
+}
+
+//=============================================================================
+
+void runoff_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of the runoff analyzer in a
+//           simulation state snapshot.
+//
+{
+    snapshot_copy(&IsRaining, sizeof(IsRaining));
+    snapshot_copy(&HasRunoff, sizeof(HasRunoff));
+    snapshot_copy(&HasSnow, sizeof(HasSnow));
+    snapshot_copy(&Nsteps, sizeof(Nsteps));
+    snapshot_copyFilePos(Frunoff.file);
 }
 
 //=============================================================================
@@ -209,6 +230,9 @@ void runoff_execute()
         subcatch_getRunon(j);
         if ( !IgnoreSnowmelt ) snow_plowSnow(j, runoffStep);
     }
+
+    // --- find snow melt from all subcatchment snow packs
+    if ( !IgnoreSnowmelt ) snow_meltSnowpacks(runoffStep);
     
     // --- determine runoff and pollutant buildup/washoff in each subcatchment
     HasSnow = FALSE;
@@ -10,9 +10,17 @@
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
+#include <stdlib.h>
 #include <math.h>
 #include "headers.h"
 
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+static const double MAX_TBL_ERROR = 0.001;  // max. interpolation error of
+                                            // area & hyd. radius tables
+                                            // (fraction of full value)
+
 //-----------------------------------------------------------------------------
 //  Shared variables
 //-----------------------------------------------------------------------------
@@ -23,11 +31,14 @@ static double Ptotal;
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //  shape_validate                (called from project_validate in project.c)
+//  shape_delete                  (called from deleteObjects in project.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static int    computeShapeTables(TShape *shape, TTable *curve);
+static int    refineShapeTables(TShape *shape, TTable *curve);
+static int    allocShapeTables(TShape *shape, int n);
 static void   getSmax(TShape *shape);
 static int    normalizeShapeTables(TShape *shape);
 static int    getNextInterval(TTable *curve, double y, double yLast,
@@ -48,13 +59,102 @@ int  shape_validate(TShape *shape, TTable *curve)
 //           tables from its user-supplied width v. height curve.
 //
 {
+    if ( !allocShapeTables(shape, N_SHAPE_TBL) )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return FALSE;
+    }
     if ( !computeShapeTables(shape, curve) ) return FALSE;
+    if ( !refineShapeTables(shape, curve) ) return FALSE;
     if ( !normalizeShapeTables(shape) ) return FALSE;
     return TRUE;
 }
 
 //=============================================================================
 
+void shape_delete(TShape *shape)
+//
+//  Input:   shape = pointer to a custom x-section TShape object
+//  Output:  none
+//  Purpose: frees the memory used by a shape's geometry tables.
+//
+{
+    FREE(shape->areaTbl);
+    FREE(shape->hradTbl);
+    FREE(shape->widthTbl);
+    shape->nTbl = 0;
+}
+
+//=============================================================================
+
+int  allocShapeTables(TShape *shape, int n)
+//
+//  Input:   shape = pointer to a TShape object
+//           n = number of entries in each geometry table
+//  Output:  returns TRUE if successful. FALSE if not
+//  Purpose: allocates memory for a shape's geometry tables.
+//
+{
+    shape->nTbl = n;
+    shape->areaTbl  = (double *) calloc(n, sizeof(double));
+    shape->hradTbl  = (double *) calloc(n, sizeof(double));
+    shape->widthTbl = (double *) calloc(n, sizeof(double));
+    if ( shape->areaTbl && shape->hradTbl && shape->widthTbl ) return TRUE;
+    shape_delete(shape);
+    return FALSE;
+}
+
+//=============================================================================
+
+int  refineShapeTables(TShape *shape, TTable *curve)
+//
+//  Input:   shape = pointer to a TShape object with un-normalized tables
+//           curve = pointer to shape's table of width v. depth
+//  Output:  returns TRUE if successful. FALSE if not
+//  Purpose: halves the height interval of a shape's geometry tables until
+//           linear interpolation of area and hyd. radius is accurate to
+//           within MAX_TBL_ERROR (or the tables reach N_SHAPE_TBL_MAX).
+//
+//  Note:    top width is not tested since it jumps wherever the shape
+//           curve has a step in it, no matter how fine the table is.
+{
+    TShape fine;
+    double err;
+
+    if ( shape->aFull == 0.0 || shape->rFull == 0.0 ) return TRUE;
+    while ( shape->nTbl < N_SHAPE_TBL_MAX )
+    {
+        // --- compute tables with twice as many intervals
+        fine = *shape;
+        if ( !allocShapeTables(&fine, 2 * shape->nTbl - 1) )
+        {
+            report_writeErrorMsg(ERR_MEMORY, "");
+            return FALSE;
+        }
+        if ( !computeShapeTables(&fine, curve) )
+        {
+            shape_delete(&fine);
+            return FALSE;
+        }
+
+        // --- keep current tables if they interpolate the finer ones
+        err = MAX(table_getIntervalError(shape->areaTbl, fine.areaTbl,
+                                         shape->nTbl) / fine.aFull,
+                  table_getIntervalError(shape->hradTbl, fine.hradTbl,
+                                         shape->nTbl) / fine.rFull);
+        if ( err <= MAX_TBL_ERROR )
+        {
+            shape_delete(&fine);
+            break;
+        }
+        shape_delete(shape);
+        *shape = fine;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
 int  computeShapeTables(TShape *shape, TTable *curve)
 //
 //  Input:   shape = pointer to a TShape object
@@ -94,8 +194,7 @@ int  computeShapeTables(TShape *shape, TTable *curve)
         if ( w2 > wMax ) wMax = w2;
     }
 
-    // --- determine number of entries & interval size in geom. tables
-    shape->nTbl = N_SHAPE_TBL;
+    // --- determine interval size in geom. tables
     n = shape->nTbl - 1;
     dy = 1.0 / (double)(n);
 
@@ -0,0 +1,630 @@
+//-----------------------------------------------------------------------------
+// 	  This file is part of a modified version of EPA SWMM called ecSWMM with RPN
+//    (reverse polish notation) control rules.
+//
+//    ecSWMM is provided as free software: under the terms of the BSD free
+//    software license included in the file repository.
+//
+//-----------------------------------------------------------------------------
+//    ecSWMM 5.1.007.03
+//-----------------------------------------------------------------------------
+//   snapshot.c
+//
+//   Project:  EPA SWMM5
+//   Version:  5.1
+//
+//   In-memory snapshots of a running simulation's state.
+//
+//   swmm_saveState() copies everything that changes as a simulation runs
+//   into a numbered slot in memory and swmm_restoreState() copies it back,
+//   so that a calling program can run ahead of the current time (e.g., to
+//   compare alternative control strategies) and then resume from where it
+//   left off without re-opening the project.
+//
+//   The same function, copyState(), is used in both directions. Each call
+//   it makes to snapshot_copy() either appends an item to the slot being
+//   saved or reads the item back from the slot being restored, so the two
+//   can never get out of step. Modules that keep their state in file-scope
+//   variables supply an xxx_snapshot() function that passes those variables
+//   to snapshot_copy().
+//
+//   The positions of files that are read or written sequentially are saved
+//   as well, so results written to the binary output and report files by a
+//   look-ahead run are overwritten once the run resumes from a snapshot.
+//
+//   A snapshot can also be taken as an image that is written to a
+//   checkpoint file (see checkpoint.c) and restored by a later process
+//   running the same project. Restoring never changes the pointers held in
+//   an object array (see snapshot_copyObjects) and an image stores the
+//   current entry of each time series or curve as a position in its list of
+//   entries rather than as an address.
+//-----------------------------------------------------------------------------
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "headers.h"
+#include "infil.h"
+#include "exfil.h"
+#include "lid.h"
+
+//-----------------------------------------------------------------------------
+//  Constants
+//-----------------------------------------------------------------------------
+#define MAX_SNAPSHOTS 64          // number of snapshot slots
+#define MAX_OBJ_PTRS  16          // most pointers held by a single object
+
+#define COUNT(x) (sizeof(x) / sizeof(x[0]))
+
+//-----------------------------------------------------------------------------
+//  Data Structures
+//-----------------------------------------------------------------------------
+typedef struct
+{
+    char*   data;                 // saved state
+    size_t  size;                 // bytes of saved state (0 if slot empty)
+    size_t  capacity;             // bytes allocated for data
+}  TSnapshot;
+
+//-----------------------------------------------------------------------------
+//  Pointers held by each type of object (left unchanged on restore)
+//-----------------------------------------------------------------------------
+static const size_t GagePtrs[] = {offsetof(TGage, ID)};
+
+static const size_t SnowmeltPtrs[] = {offsetof(TSnowmelt, ID)};
+
+static const size_t TablePtrs[] =
+    {offsetof(TTable, ID), offsetof(TTable, firstEntry),
+     offsetof(TTable, lastEntry), offsetof(TTable, thisEntry),
+     offsetof(TTable, file.file), offsetof(TTable, xData),
+     offsetof(TTable, yData)};
+
+static const size_t SubcatchPtrs[] =
+    {offsetof(TSubcatch, ID), offsetof(TSubcatch, initBuildup),
+     offsetof(TSubcatch, landFactor), offsetof(TSubcatch, groundwater),
+     offsetof(TSubcatch, gwLatFlowExpr), offsetof(TSubcatch, gwDeepFlowExpr),
+     offsetof(TSubcatch, snowpack), offsetof(TSubcatch, oldQual),
+     offsetof(TSubcatch, newQual), offsetof(TSubcatch, pondedQual),
+     offsetof(TSubcatch, totalLoad)};
+
+static const size_t LandFactorPtrs[] = {offsetof(TLandFactor, buildup)};
+
+static const size_t NodePtrs[] =
+    {offsetof(TNode, ID), offsetof(TNode, extInflow),
+     offsetof(TNode, dwfInflow), offsetof(TNode, rdiiInflow),
+     offsetof(TNode, treatment), offsetof(TNode, oldQual),
+     offsetof(TNode, newQual)};
+
+static const size_t StoragePtrs[] = {offsetof(TStorage, exfil)};
+
+static const size_t LinkPtrs[] =
+    {offsetof(TLink, ID), offsetof(TLink, oldQual), offsetof(TLink, newQual),
+     offsetof(TLink, totalLoad)};
+
+static const size_t ConduitPtrs[] =
+    {offsetof(TConduit, yNormTbl.y), offsetof(TConduit, yCritTbl.y)};
+
+static const size_t PumpPtrs[] =
+    {offsetof(TPump, curve.x), offsetof(TPump, curve.y)};
+
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TSnapshot  Slots[MAX_SNAPSHOTS];
+static TSnapshot  Image;          // snapshot written to a checkpoint file
+static TSnapshot* Current;        // slot being saved or restored
+static size_t     Pos;            // bytes of Current copied so far
+static int        Saving;         // TRUE if saving, FALSE if restoring
+static int        Failed;         // TRUE if a copy could not be made
+static int        Portable;       // TRUE if copying an image
+
+//-----------------------------------------------------------------------------
+//  External functions (declared in funcs.h)
+//-----------------------------------------------------------------------------
+//  snapshot_save         (called by swmm_saveState)
+//  snapshot_restore      (called by swmm_restoreState)
+//  snapshot_delete       (called by swmm_deleteState)
+//  snapshot_saveImage    (called by checkpoint_step)
+//  snapshot_restoreImage (called by checkpoint_resume)
+//  snapshot_close        (called by swmm_end)
+//  snapshot_copy         (called by each module's xxx_snapshot function)
+//  snapshot_copyObjects  (called by each module's xxx_snapshot function)
+//  snapshot_copyFilePos  (called by each module's xxx_snapshot function)
+
+//-----------------------------------------------------------------------------
+//  Function declarations
+//-----------------------------------------------------------------------------
+static int  isValidHandle(int handle);
+static int  saveSlot(TSnapshot* slot, int portable);
+static int  restoreSlot(TSnapshot* slot, int portable);
+static void copyState(void);
+static void copyTables(TTable* tables, int n);
+static void copySubcatchState(void);
+static void copyNodeState(void);
+static void copyLinkState(void);
+
+//=============================================================================
+
+int snapshot_save(int handle)
+//
+//  Input:   handle = index of the slot to save the current state in
+//  Output:  returns an error code
+//  Purpose: saves the current state of a simulation in memory.
+//
+//  Note:    a slot's memory is kept when it is saved over so that repeated
+//           saves to the same slot don't need to re-allocate it.
+{
+    if ( !isValidHandle(handle) ) return ErrorCode;
+    return saveSlot(&Slots[handle], FALSE);
+}
+
+//=============================================================================
+
+int snapshot_restore(int handle)
+//
+//  Input:   handle = index of the slot to restore the state from
+//  Output:  returns an error code
+//  Purpose: returns a simulation to the state saved in a snapshot.
+//
+{
+    char s[16];
+
+    if ( !isValidHandle(handle) ) return ErrorCode;
+    if ( restoreSlot(&Slots[handle], FALSE) ) return 0;
+    sprintf(s, "%d", handle);
+    report_writeErrorMsg(ERR_SNAPSHOT, s);
+    return ErrorCode;
+}
+
+//=============================================================================
+
+int snapshot_delete(int handle)
+//
+//  Input:   handle = index of a snapshot slot
+//  Output:  returns an error code
+//  Purpose: frees the memory used by a snapshot.
+//
+{
+    if ( !isValidHandle(handle) ) return ErrorCode;
+    FREE(Slots[handle].data);
+    Slots[handle].size = 0;
+    Slots[handle].capacity = 0;
+    return 0;
+}
+
+//=============================================================================
+
+int snapshot_saveImage(char** data, size_t* size)
+//
+//  Input:   none
+//  Output:  data = address of the saved image
+//           size = size of the saved image (bytes)
+//           returns an error code
+//  Purpose: saves the current state of a simulation as an image that can be
+//           restored by another process running the same project.
+//
+//  Note:    the image's memory is re-used by the next call, so it must not
+//           be saved again while the previous image is still being written.
+{
+    *data = NULL;
+    *size = 0;
+    if ( saveSlot(&Image, TRUE) ) return ErrorCode;
+    *data = Image.data;
+    *size = Image.size;
+    return 0;
+}
+
+//=============================================================================
+
+int snapshot_restoreImage(char* data, size_t size)
+//
+//  Input:   data = image saved by snapshot_saveImage
+//           size = size of the image (bytes)
+//  Output:  returns TRUE if the image was restored
+//  Purpose: returns a simulation to the state saved in an image.
+//
+{
+    TSnapshot image;
+
+    image.data = data;
+    image.size = size;
+    image.capacity = size;
+    return restoreSlot(&image, TRUE);
+}
+
+//=============================================================================
+
+void snapshot_close()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees all snapshots at the end of a simulation.
+//
+//  Note:    a snapshot only applies to the run it was taken from.
+{
+    int i;
+    for (i = 0; i < MAX_SNAPSHOTS; i++)
+    {
+        FREE(Slots[i].data);
+        Slots[i].size = 0;
+        Slots[i].capacity = 0;
+    }
+    FREE(Image.data);
+    Image.size = 0;
+    Image.capacity = 0;
+}
+
+//=============================================================================
+
+void snapshot_copy(void* x, size_t size)
+//
+//  Input:   x = address of an item of simulation state
+//           size = size of the item (bytes)
+//  Output:  none
+//  Purpose: saves an item to the current snapshot or restores it from there.
+//
+{
+    size_t n;
+    char*  p;
+
+    if ( x == NULL || size == 0 || Failed ) return;
+    if ( Saving )
+    {
+        // --- grow the slot's memory by doubling it
+        if ( Pos + size > Current->capacity )
+        {
+            n = MAX(2 * Current->capacity, Pos + size);
+            p = (char *) realloc(Current->data, n);
+            if ( p == NULL )
+            {
+                Failed = TRUE;
+                return;
+            }
+            Current->data = p;
+            Current->capacity = n;
+        }
+        memcpy(Current->data + Pos, x, size);
+    }
+    else
+    {
+        if ( Pos + size > Current->size )
+        {
+            Failed = TRUE;
+            return;
+        }
+        memcpy(x, Current->data + Pos, size);
+    }
+    Pos += size;
+}
+
+//=============================================================================
+
+void snapshot_copyObjects(void* x, int n, size_t size, const size_t ptrs[],
+                          int nPtrs)
+//
+//  Input:   x = address of an array of objects
+//           n = number of objects in the array
+//           size = size of each object (bytes)
+//           ptrs = offsets of the pointers held by each object
+//           nPtrs = number of pointers held by each object
+//  Output:  none
+//  Purpose: saves an array of objects to the current snapshot or restores
+//           it from there without changing the pointers the objects hold.
+//
+{
+    int   j, k;
+    char* obj;
+    void* p[MAX_OBJ_PTRS];
+
+    if ( x == NULL || n <= 0 ) return;
+    if ( Saving )
+    {
+        snapshot_copy(x, n * size);
+        return;
+    }
+    for (j = 0; j < n; j++)
+    {
+        obj = (char *)x + j * size;
+        for (k = 0; k < nPtrs; k++) memcpy(&p[k], obj + ptrs[k], sizeof(void*));
+        snapshot_copy(obj, size);
+        for (k = 0; k < nPtrs; k++) memcpy(obj + ptrs[k], &p[k], sizeof(void*));
+    }
+}
+
+//=============================================================================
+
+void snapshot_copyFilePos(FILE* f)
+//
+//  Input:   f = an open file
+//  Output:  none
+//  Purpose: saves the current position of a file to the current snapshot or
+//           moves the file back to the position stored there.
+//
+//  Note:    a file is never moved past its end, so a file re-created by a
+//           run resumed from a checkpoint simply carries on from there.
+{
+    long long pos, end;
+
+    if ( f == NULL ) return;
+    if ( Saving ) pos = _ftelli64(f);
+    snapshot_copy(&pos, sizeof(pos));
+    if ( Saving || Failed ) return;
+    _fseeki64(f, 0, SEEK_END);
+    end = _ftelli64(f);
+    _fseeki64(f, MIN(pos, end), SEEK_SET);
+}
+
+//=============================================================================
+
+int isValidHandle(int handle)
+//
+//  Input:   handle = index of a snapshot slot
+//  Output:  returns TRUE if handle is in range
+//  Purpose: checks the handle passed to a snapshot function.
+//
+{
+    char s[16];
+
+    if ( handle >= 0 && handle < MAX_SNAPSHOTS ) return TRUE;
+    sprintf(s, "%d", handle);
+    report_writeErrorMsg(ERR_SNAPSHOT, s);
+    return FALSE;
+}
+
+//=============================================================================
+
+int saveSlot(TSnapshot* slot, int portable)
+//
+//  Input:   slot = snapshot to save the current state in
+//           portable = TRUE if saving an image
+//  Output:  returns an error code
+//  Purpose: saves the current state of a simulation in a snapshot.
+//
+{
+    Current = slot;
+    Current->size = 0;
+    Pos = 0;
+    Saving = TRUE;
+    Failed = FALSE;
+    Portable = portable;
+    copyState();
+    if ( Failed )
+    {
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return ErrorCode;
+    }
+    Current->size = Pos;
+    return 0;
+}
+
+//=============================================================================
+
+int restoreSlot(TSnapshot* slot, int portable)
+//
+//  Input:   slot = snapshot to restore the state from
+//           portable = TRUE if restoring an image
+//  Output:  returns TRUE if the snapshot was restored
+//  Purpose: returns a simulation to the state saved in a snapshot.
+//
+{
+    if ( slot->size == 0 ) return FALSE;
+    Current = slot;
+    Pos = 0;
+    Saving = FALSE;
+    Failed = FALSE;
+    Portable = portable;
+    copyState();
+    return ( !Failed && Pos == Current->size );
+}
+
+//=============================================================================
+
+void copyState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the complete state of a simulation.
+//
+{
+    // --- simulation clock and counters
+    snapshot_copy(&ReportTime, sizeof(ReportTime));
+    snapshot_copy(&OldRunoffTime, sizeof(OldRunoffTime));
+    snapshot_copy(&NewRunoffTime, sizeof(NewRunoffTime));
+    snapshot_copy(&OldRoutingTime, sizeof(OldRoutingTime));
+    snapshot_copy(&NewRoutingTime, sizeof(NewRoutingTime));
+    snapshot_copy(&Nperiods, sizeof(Nperiods));
+    snapshot_copy(&StepCount, sizeof(StepCount));
+    snapshot_copy(&NonConvergeCount, sizeof(NonConvergeCount));
+
+    // --- climate, rain gages and time series (incl. their look-up brackets)
+    snapshot_copy(&Temp, sizeof(TTemp));
+    snapshot_copy(&Evap, sizeof(TEvap));
+    snapshot_copy(&Wind, sizeof(TWind));
+    snapshot_copy(&Snow, sizeof(TSnow));
+    snapshot_copy(&Adjust, sizeof(TAdjust));
+    climate_snapshot();
+    snapshot_copyObjects(Snowmelt, Nobjects[SNOWMELT], sizeof(TSnowmelt),
+                         SnowmeltPtrs, COUNT(SnowmeltPtrs));
+    snapshot_copyObjects(Gage, Nobjects[GAGE], sizeof(TGage),
+                         GagePtrs, COUNT(GagePtrs));
+    raingrid_snapshot();
+    copyTables(Tseries, Nobjects[TSERIES]);
+    copyTables(Curve, Nobjects[CURVE]);
+
+    // --- runoff
+    copySubcatchState();
+    infil_snapshot();
+    lid_snapshot();
+    runoff_snapshot();
+
+    // --- routing
+    copyNodeState();
+    copyLinkState();
+    dynwave_snapshot();
+    forcemain_snapshot();
+    rdii_snapshot();
+    iface_snapshot();
+    controls_snapshot();
+
+    // --- continuity and summary statistics
+    massbal_snapshot();
+    stats_snapshot();
+
+    // --- results files
+    snapshot_copyFilePos(Fout.file);
+    snapshot_copyFilePos(Frpt.file);
+}
+
+//=============================================================================
+
+void copyTables(TTable* tables, int n)
+//
+//  Input:   tables = array of time series or curves
+//           n = number of tables
+//  Output:  none
+//  Purpose: saves or restores the state of a set of time series or curves.
+//
+{
+    int          j, k;
+    TTableEntry* entry;
+
+    snapshot_copyObjects(tables, n, sizeof(TTable), TablePtrs,
+                         COUNT(TablePtrs));
+    for (j = 0; j < n; j++)
+    {
+        if ( !Portable )
+        {
+            snapshot_copy(&tables[j].thisEntry, sizeof(TTableEntry*));
+            continue;
+        }
+
+        // --- an image saves the current entry's position in the list
+        //     (-1 if there is no current entry)
+        k = -1;
+        if ( Saving )
+        {
+            k = 0;
+            entry = tables[j].firstEntry;
+            while ( entry && entry != tables[j].thisEntry )
+            {
+                entry = entry->next;
+                k++;
+            }
+            if ( entry == NULL ) k = -1;
+        }
+        snapshot_copy(&k, sizeof(int));
+        if ( Saving || Failed ) continue;
+        entry = NULL;
+        if ( k >= 0 )
+        {
+            entry = tables[j].firstEntry;
+            while ( entry && k > 0 )
+            {
+                entry = entry->next;
+                k--;
+            }
+        }
+        tables[j].thisEntry = entry;
+    }
+}
+
+//=============================================================================
+
+void copySubcatchState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of all subcatchments.
+//
+{
+    int    j, i;
+    int    np = Nobjects[POLLUT];
+    size_t qualSize = np * sizeof(double);
+    TSubcatch* s;
+
+    snapshot_copyObjects(Subcatch, Nobjects[SUBCATCH], sizeof(TSubcatch),
+                         SubcatchPtrs, COUNT(SubcatchPtrs));
+    for (j = 0; j < Nobjects[SUBCATCH]; j++)
+    {
+        s = &Subcatch[j];
+        snapshot_copy(s->oldQual, qualSize);
+        snapshot_copy(s->newQual, qualSize);
+        snapshot_copy(s->pondedQual, qualSize);
+        snapshot_copy(s->totalLoad, qualSize);
+        if ( s->landFactor )
+        {
+            snapshot_copyObjects(s->landFactor, Nobjects[LANDUSE],
+                sizeof(TLandFactor), LandFactorPtrs, COUNT(LandFactorPtrs));
+            for (i = 0; i < Nobjects[LANDUSE]; i++)
+                snapshot_copy(s->landFactor[i].buildup, qualSize);
+        }
+        snapshot_copy(s->groundwater, sizeof(TGroundwater));
+        snapshot_copy(s->snowpack, sizeof(TSnowpack));
+    }
+}
+
+//=============================================================================
+
+void copyNodeState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of all nodes.
+//
+{
+    int    j;
+    size_t qualSize = Nobjects[POLLUT] * sizeof(double);
+    TExfil* exfil;
+
+    snapshot_copyObjects(Node, Nobjects[NODE], sizeof(TNode),
+                         NodePtrs, COUNT(NodePtrs));
+    for (j = 0; j < Nobjects[NODE]; j++)
+    {
+        snapshot_copy(Node[j].oldQual, qualSize);
+        snapshot_copy(Node[j].newQual, qualSize);
+    }
+    snapshot_copy(Outfall, Nnodes[OUTFALL] * sizeof(TOutfall));
+    snapshot_copy(Divider, Nnodes[DIVIDER] * sizeof(TDivider));
+    snapshot_copyObjects(Storage, Nnodes[STORAGE], sizeof(TStorage),
+                         StoragePtrs, COUNT(StoragePtrs));
+    for (j = 0; j < Nnodes[STORAGE]; j++)
+    {
+        exfil = Storage[j].exfil;
+        if ( exfil == NULL ) continue;
+        snapshot_copy(exfil->btmExfil, sizeof(TGrnAmpt));
+        snapshot_copy(exfil->bankExfil, sizeof(TGrnAmpt));
+    }
+}
+
+//=============================================================================
+
+void copyLinkState()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores the state of all links.
+//
+{
+    int    j;
+    size_t qualSize = Nobjects[POLLUT] * sizeof(double);
+
+    snapshot_copyObjects(Link, Nobjects[LINK], sizeof(TLink),
+                         LinkPtrs, COUNT(LinkPtrs));
+    for (j = 0; j < Nobjects[LINK]; j++)
+    {
+        snapshot_copy(Link[j].oldQual, qualSize);
+        snapshot_copy(Link[j].newQual, qualSize);
+        snapshot_copy(Link[j].totalLoad, qualSize);
+    }
+    snapshot_copyObjects(Conduit, Nlinks[CONDUIT], sizeof(TConduit),
+                         ConduitPtrs, COUNT(ConduitPtrs));
+    snapshot_copyObjects(Pump, Nlinks[PUMP], sizeof(TPump),
+                         PumpPtrs, COUNT(PumpPtrs));
+    snapshot_copy(Orifice, Nlinks[ORIFICE] * sizeof(TOrifice));
+    snapshot_copy(Weir, Nlinks[WEIR] * sizeof(TWeir));
+    snapshot_copy(Outlet, Nlinks[OUTLET] * sizeof(TOutlet));
+}
+
+//=============================================================================
@@ -7,6 +7,9 @@
 //   Author:  L. Rossman
 //
 //   Models snow melt processes.
+//
+//   The snow packs of all subcatchments are held in a single block of
+//   memory and are melted together in one pass at each runoff time step.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -21,6 +24,14 @@
 // These symbolize the keywords listed in SnowmeltWords in keywords.c
 enum SnowKeywords {SNOW_PLOWABLE, SNOW_IMPERV, SNOW_PERV, SNOW_REMOVAL};
 
+//-----------------------------------------------------------------------------
+//  Shared variables
+//-----------------------------------------------------------------------------
+static TSnowpack* Snowpacks;           // snow packs of all subcatchments
+static int*       SnowpackSubcatch;    // subcatchment that owns each snow pack
+static int        NumSnowpacks;        // number of snow packs
+static double     Tipm;                // ATI weighting factor for time step
+
 //-----------------------------------------------------------------------------
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
@@ -31,13 +42,17 @@ enum SnowKeywords {SNOW_PLOWABLE, SNOW_IMPERV, SNOW_PERV, SNOW_REMOVAL};
 //  snow_readMeltParams  (called from parseLine in input.c)
 //  snow_setMeltCoeffs   (called from setTemp in climate.c)
 //  snow_plowSnow        (called from runoff_execute)
-//  snow_getSnowMelt     (called from subcatch_getRunoff)
+//  snow_meltSnowpacks   (called from runoff_execute)
 //  snow_getSnowCover    (called from massbal_open) 
+//  snow_freeSnowpacks   (called from deleteObjects in project.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
 //-----------------------------------------------------------------------------
 static void   setMeltParams(int i, int k, double x[]);
+static void   setStepMeltTerms(double tStep);
+static double getSnowMelt(TSnowpack* snowpack, int j, double rainfall,
+              double snowfall, double tStep);
 static double getRainmelt(double rainfall);
 static double getArealDepletion(TSnowpack* snowpack, int i, double snowfall,
               double tStep);
@@ -121,15 +136,45 @@ int snow_createSnowpack(int j, int k)
 //
 {
     TSnowpack* snowpack;
-    snowpack = (TSnowpack *) malloc(sizeof(TSnowpack));
-    if ( !snowpack ) return FALSE;
-    Subcatch[j].snowpack = snowpack;
+
+    // --- allocate room for a snow pack on every subcatchment in one block
+    if ( Snowpacks == NULL )
+    {
+        NumSnowpacks = 0;
+        Snowpacks = (TSnowpack *) calloc(Nobjects[SUBCATCH], sizeof(TSnowpack));
+        SnowpackSubcatch = (int *) calloc(Nobjects[SUBCATCH], sizeof(int));
+    }
+    if ( !Snowpacks || !SnowpackSubcatch ) return FALSE;
+
+    // --- assign the next snow pack in the block to the subcatchment
+    snowpack = Subcatch[j].snowpack;
+    if ( snowpack == NULL )
+    {
+        snowpack = &Snowpacks[NumSnowpacks];
+        SnowpackSubcatch[NumSnowpacks] = j;
+        NumSnowpacks++;
+        Subcatch[j].snowpack = snowpack;
+    }
     snowpack->snowmeltIndex = k;
     return TRUE;
 }
 
 //=============================================================================
 
+void snow_freeSnowpacks()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: frees the memory used by all subcatchment snow packs.
+//
+{
+    FREE(Snowpacks);
+    FREE(SnowpackSubcatch);
+    NumSnowpacks = 0;
+}
+
+//=============================================================================
+
 void snow_initSnowpack(int j)
 //
 //  Input:   j = subcatchment index
@@ -341,6 +386,33 @@ void snow_setMeltCoeffs(int j, double s)
     {
         Snowmelt[j].dhm[k] = 0.5 * (Snowmelt[j].dhmax[k] * (1.0 + s)
                              + Snowmelt[j].dhmin[k] * (1.0 - s));
+        Snowmelt[j].ccRate[k] = Snow.rnm * Snowmelt[j].dhm[k];
+    }
+}
+
+//=============================================================================
+
+void setStepMeltTerms(double tStep)
+//
+//  Input:   tStep = time step (sec)
+//  Output:  none
+//  Purpose: finds the melt terms for the current time step that are shared
+//           by all snow packs using the same snow melt parameter set.
+//
+{
+    int j, k;
+
+    // --- convert ATI weighting factor from 6-hr to tStep time basis
+    Tipm = 1.0 - pow(1.0 - Snow.tipm, tStep / (6.0*3600.0));
+
+    // --- degree-day melt rate at current air temperature
+    for (j = 0; j < Nobjects[SNOWMELT]; j++)
+    {
+        for (k=SNOW_PLOWABLE; k<=SNOW_PERV; k++)
+        {
+            Snowmelt[j].dmelt[k] = Snowmelt[j].dhm[k] *
+                                   (Temp.ta - Snowmelt[j].tbase[k]);
+        }
     }
 }
 
@@ -368,7 +440,7 @@ void snow_plowSnow(int j, double tStep)
     if ( !snowpack ) return;
 
     // --- see if there's any snowfall
-    gage_getPrecip(Subcatch[j].gage, &rainfall, &snowfall);
+    gage_getPrecip(Subcatch[j].gage, j, &rainfall, &snowfall);
 
     // --- add snowfall to snow pack
     for (i=SNOW_PLOWABLE; i<=SNOW_PERV; i++)
@@ -443,17 +515,53 @@ void snow_plowSnow(int j, double tStep)
 
 //=============================================================================
 
-double snow_getSnowMelt(int j, double rainfall, double snowfall, double tStep,
-                        double netPrecip[])
+void snow_meltSnowpacks(double tStep)
 //
-//  Input:   j = subcatchment index
+//  Input:   tStep = time step (sec)
+//  Output:  none
+//  Purpose: finds the snow melt from every subcatchment's snow pack and the
+//           net precipitation it leaves on the subcatchment's sub-areas.
+//
+//  Note:    once snow has been plowed the snow packs don't depend on each
+//           other, so they are all melted here (using NumThreads threads)
+//           before subcatch_getRunoff uses their net precipitation.
+{
+    int    n;                          // snow pack index
+    int    j;                          // subcatchment index
+    double rainfall;                   // rainfall (ft/sec)
+    double snowfall;                   // snowfall (ft/sec)
+
+    if ( NumSnowpacks == 0 ) return;
+    setStepMeltTerms(tStep);
+
+#pragma omp parallel for num_threads(NumThreads) schedule(static) \
+        private(j, rainfall, snowfall)
+    for (n = 0; n < NumSnowpacks; n++)
+    {
+        j = SnowpackSubcatch[n];
+        rainfall = 0.0;
+        snowfall = 0.0;
+        if ( Subcatch[j].gage >= 0 )
+            gage_getPrecip(Subcatch[j].gage, j, &rainfall, &snowfall);
+        Subcatch[j].newSnowDepth =
+            getSnowMelt(&Snowpacks[n], j, rainfall, snowfall, tStep);
+    }
+}
+
+//=============================================================================
+
+double getSnowMelt(TSnowpack* snowpack, int j, double rainfall,
+                   double snowfall, double tStep)
+//
+//  Input:   snowpack = ptr. to snowpack object
+//           j = subcatchment index
 //           rainfall = rainfall (ft/sec)
 //           snowfall = snowfall (ft/sec)
 //           tStep = time step (sec)
-//  Output:  netPrecip = rainfall + snowmelt on each runoff sub-area (ft/sec),
-//           returns new snow depth over subcatchment
-//  Purpose: modifies rainfall input to subcatchment's sub-areas based on
-//           possible snow melt and updates snow depth over entire subcatchment.
+//  Output:  returns new snow depth over subcatchment
+//  Purpose: finds the net precipitation (rainfall + snowmelt) on each of a
+//           subcatchment's runoff sub-areas based on possible snow melt and
+//           updates snow depth over entire subcatchment.
 //
 {
     int     i;                         // snow sub-area index
@@ -462,10 +570,9 @@ double snow_getSnowMelt(int j, double rainfall, double snowfall, double tStep,
     double  asc;                       // frac. of sub-area snow covered
     double  snowDepth = 0.0;           // snow depth on entire subcatchment (ft)
     double  impervPrecip;              // net precip. on imperv. area (ft/sec)
-    TSnowpack* snowpack;               // ptr. to snowpack object
+    double* netPrecip;                 // net precip. on each sub-area (ft/sec)
 
-    // --- get ptr. to subcatchment's snowpack
-    snowpack = Subcatch[j].snowpack;
+    netPrecip = snowpack->netPrecip;
 
     // --- compute snowmelt over entire subcatchment when rain falling
     rmelt = getRainmelt(rainfall);
@@ -683,7 +790,7 @@ double meltSnowpack(TSnowpack* snowpack, int i, double rmelt, double asc,
     // --- else if air temp. >= base melt temp. then use degree-day eqn.
     else if ( Temp.ta >= Snowmelt[k].tbase[i] )
     {
-         smelt = Snowmelt[k].dhm[i] * (Temp.ta - Snowmelt[k].tbase[i]);
+         smelt = Snowmelt[k].dmelt[i];
     }
 
     // --- otherwise alter cold content and return 0
@@ -744,7 +851,6 @@ void updateColdContent(TSnowpack* snowpack, int i, double asc, double snowfall,
     double ati;                        // antecdent temperature index (deg F)
     double cc;                         // snow pack cold content (ft)
     double ccMax;                      // max. possible cold content (ft)
-    double tipm;                       // adjusted ATI weighting factor
 	
     // --- retrieve ATI & CC from snowpack object
     ati = snowpack->ati[i];
@@ -754,11 +860,8 @@ void updateColdContent(TSnowpack* snowpack, int i, double asc, double snowfall,
     if ( snowfall * 43200.0 > 0.02) ati = Temp.ta;
 	else
 	{
-	    // convert ATI weighting factor from 6-hr to tStep time basis
-	    tipm = 1.0 - pow(1.0 - Snow.tipm, tStep / (6.0*3600.0));
-		
-		// update ATI
-		ati += tipm * (Temp.ta - ati);
+		// update ATI (using weighting factor for tStep time basis)
+		ati += Tipm * (Temp.ta - ati);
 	}
 
     // --- ATI cannot exceed snow melt base temperature
@@ -766,7 +869,7 @@ void updateColdContent(TSnowpack* snowpack, int i, double asc, double snowfall,
     ati = MIN(ati, Snowmelt[k].tbase[i]);
 
     // --- update cold content
-    cc += Snow.rnm * Snowmelt[k].dhm[i] * (ati - Temp.ta) * tStep * asc;
+    cc += Snowmelt[k].ccRate[i] * (ati - Temp.ta) * tStep * asc;
     cc = MAX(cc, 0.0);
 
     // --- maximum cold content based on assumed specific heat of snow
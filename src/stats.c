@@ -14,6 +14,7 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <stddef.h>
 #include "headers.h"
 
 //-----------------------------------------------------------------------------
@@ -53,6 +54,7 @@ extern double*         NodeOutflow;    // defined in massbal.c
 //  stats_updateSubcatchStats     (called from subcatch_getRunoff)
 //  stats_updateFlowStats         (called from routing_execute)
 //  stats_updateCriticalTimeCount (called from getVariableStep in dynwave.c)
+//  stats_snapshot                (called from copyState in snapshot.c)
 
 //-----------------------------------------------------------------------------
 //  Local functions
@@ -267,6 +269,43 @@ void  stats_close()
 
 //=============================================================================
 
+void  stats_snapshot()
+//
+//  Input:   none
+//  Output:  none
+//  Purpose: saves or restores all simulation statistics in a simulation
+//           state snapshot.
+//
+{
+    int j;
+    static const size_t OutfallPtrs[] = {offsetof(TOutfallStats, totalLoad)};
+
+    snapshot_copy(&SysStats, sizeof(TSysStats));
+    snapshot_copy(&SysOutfallFlow, sizeof(SysOutfallFlow));
+    snapshot_copy(&MaxOutfallFlow, sizeof(MaxOutfallFlow));
+    snapshot_copy(&MaxRunoffFlow, sizeof(MaxRunoffFlow));
+    if ( SubcatchStats ) snapshot_copy(SubcatchStats,
+        Nobjects[SUBCATCH] * sizeof(TSubcatchStats));
+    if ( NodeStats ) snapshot_copy(NodeStats,
+        Nobjects[NODE] * sizeof(TNodeStats));
+    if ( LinkStats ) snapshot_copy(LinkStats,
+        Nobjects[LINK] * sizeof(TLinkStats));
+    if ( StorageStats ) snapshot_copy(StorageStats,
+        Nnodes[STORAGE] * sizeof(TStorageStats));
+    if ( OutfallStats )
+    {
+        snapshot_copyObjects(OutfallStats, Nnodes[OUTFALL],
+            sizeof(TOutfallStats), OutfallPtrs, 1);
+        for ( j = 0; j < Nnodes[OUTFALL]; j++ )
+            snapshot_copy(OutfallStats[j].totalLoad,
+                          Nobjects[POLLUT] * sizeof(double));
+    }
+    if ( PumpStats ) snapshot_copy(PumpStats,
+        Nlinks[PUMP] * sizeof(TPumpStats));
+}
+
+//=============================================================================
+
 void  stats_report()
 //
 //  Input:   none
@@ -78,7 +78,7 @@ extern  double*    WashoffLoad;   // washoff pollutant mass from landuses
 //-----------------------------------------------------------------------------
 // Function declarations
 //-----------------------------------------------------------------------------
-static void   getNetPrecip(int j, double* netPrecip, double tStep);
+static void   getNetPrecip(int j, double* netPrecip);
 static void   getSubareaRunoff(int subcatch, int subarea, double rainfall,
               double evap, double tStep);
 static double getSubareaInfil(int j, TSubarea* subarea, double precip,
@@ -611,7 +611,7 @@ double subcatch_getRunoff(int j, double tStep)
 	Vponded = subcatch_getDepth(j) * Subcatch[j].area;
 
     // --- get net precipitation (rainfall + snowmelt) on subcatchment
-    getNetPrecip(j, netPrecip, tStep);
+    getNetPrecip(j, netPrecip);
     if ( Evap.dryOnly && Subcatch[j].rainfall > 0.0 ) evapRate = 0.0;
     else evapRate = Evap.rate;
 
@@ -687,12 +687,11 @@ double subcatch_getRunoff(int j, double tStep)
 
 //=============================================================================
 
-void getNetPrecip(int j, double* netPrecip, double tStep)
+void getNetPrecip(int j, double* netPrecip)
 {
 //
 //  Purpose: Finds combined rainfall + snowmelt on a subcatchment.
 //  Input:   j = subcatchment index
-//           tStep = time step (sec)
 //  Output:  netPrecip = rainfall + snowmelt over each type of subarea (ft/s)
 //
     int    i, k;
@@ -703,7 +702,7 @@ void getNetPrecip(int j, double* netPrecip, double tStep)
     k = Subcatch[j].gage;
     if ( k >= 0 )
     {
-        gage_getPrecip(k, &rainfall, &snowfall);
+        gage_getPrecip(k, j, &rainfall, &snowfall);
     }
 
     // --- assign total precip. rate to subcatch's rainfall property
@@ -711,11 +710,12 @@ void getNetPrecip(int j, double* netPrecip, double tStep)
 
     // --- determine net precipitation input (netPrecip) to each sub-area
 
-    // --- if subcatch has a snowpack, then base netPrecip on possible snow melt
+    // --- if subcatch has a snowpack, then use the netPrecip that includes
+    //     the snow melt found by snow_meltSnowpacks
     if ( Subcatch[j].snowpack && !IgnoreSnowmelt )
     {
-        Subcatch[j].newSnowDepth = 
-            snow_getSnowMelt(j, rainfall, snowfall, tStep, netPrecip);
+        for (i=IMPERV0; i<=PERV; i++)
+            netPrecip[i] = Subcatch[j].snowpack->netPrecip[i];
     }
 
     // --- otherwise netPrecip is just sum of rainfall & snowfall
@@ -1045,8 +1045,10 @@ void  subcatch_getResults(int j, double f, float x[])
 
     // --- retrieve rainfall for current report period
     k = Subcatch[j].gage;
-    if ( k >= 0 ) x[SUBCATCH_RAINFALL] = (float)Gage[k].reportRainfall;
-    else          x[SUBCATCH_RAINFALL] = 0.0f;
+    if ( k < 0 ) x[SUBCATCH_RAINFALL] = 0.0f;
+    else if ( Gage[k].dataSource == RAIN_GRID )
+        x[SUBCATCH_RAINFALL] = (float)raingrid_getReportRainfall(k, j);
+    else x[SUBCATCH_RAINFALL] = (float)Gage[k].reportRainfall;
 
     // --- retrieve snow depth
     z = ( f1 * Subcatch[j].oldSnowDepth +
@@ -38,7 +38,9 @@
 
 //2014-09-05:EMNET: compile sources as CONSOLE EXE, for testing -- so we can use the Development Environment for debugging
 
+#if !defined(SOL) && !defined(DLL)
 #define CLE     /* Compile as a command line executable */			
+#endif
 //#define SOL     /* Compile as a shared object library */
 //#define DLL     /* Compile as a Windows DLL */
 
@@ -85,6 +87,7 @@
 #include "swmm5.h"                     // declaration of exportable functions
                                        //   callable from other programs
 #define  MAX_EXCEPTIONS 100            // max. number of exceptions handled
+#define  FNV_PRIME  1099511628211ULL   // 64-bit FNV-1a hash multiplier
 
 //-----------------------------------------------------------------------------
 //  Unit conversion factors
@@ -390,6 +393,9 @@ int DLLEXPORT swmm_start(int saveResults)
         if ( Nobjects[NODE] > 0 && !IgnoreRouting ) DoRouting = TRUE;
         else DoRouting = FALSE;
 
+        // --- see if the run resumes from a checkpoint
+        checkpoint_open();
+
         // --- open all computing systems (order is important!)
         output_open();
         if ( DoRunoff ) runoff_open();
@@ -406,9 +412,13 @@ int DLLEXPORT swmm_start(int saveResults)
         // --- initialize mass balance and statistics processors
         massbal_open();
         stats_open();
+        profile_open();
 
         // --- write Control Actions heading to report file
         if ( RptFlags.controls ) report_writeControlActionsHeading();
+
+        // --- restore the state saved in a checkpoint file
+        checkpoint_resume();
     }
 
 #ifdef WINDOWS
@@ -458,10 +468,18 @@ int DLLEXPORT swmm_step(DateTime* elapsedTime)
         // --- save results at next reporting time
         if ( NewRoutingTime >= ReportTime )
         {
-            if ( SaveResultsFlag ) output_saveResults(ReportTime);
+            if ( SaveResultsFlag )
+            {
+                profile_start(PROF_OUTPUT);
+                output_saveResults(ReportTime);
+                profile_stop(PROF_OUTPUT);
+            }
             ReportTime = ReportTime + (double)(1000 * ReportStep);
         }
 
+        // --- write a checkpoint file if one is due
+        checkpoint_step();
+
         // --- update elapsed time (days)
         if ( NewRoutingTime < TotalDuration )
         {
@@ -513,7 +531,9 @@ void execRouting(DateTime elapsedTime)
         // --- compute runoff until next routing time reached or exceeded
         if ( DoRunoff ) while ( NewRunoffTime < nextRoutingTime )
         {
+            profile_start(PROF_RUNOFF);
             runoff_execute();
+            profile_stop(PROF_RUNOFF);
             if ( ErrorCode ) return;
         }
 
@@ -521,7 +541,12 @@ void execRouting(DateTime elapsedTime)
         else climate_setState(getDateTime(NewRoutingTime));
   
         // --- route flows through drainage system over current time step
-        if ( DoRouting ) routing_execute(RouteModel, routingStep);
+        if ( DoRouting )
+        {
+            profile_start(PROF_ROUTING);
+            routing_execute(RouteModel, routingStep);
+            profile_stop(PROF_ROUTING);
+        }
         else NewRoutingTime = nextRoutingTime;
     }
 
@@ -559,11 +584,16 @@ int DLLEXPORT swmm_end(void)
         // --- report mass balance results and system statistics
         if ( !ErrorCode )
         {
+            rdii_reportStats();
             massbal_report();
             stats_report();
+            profile_report();
         }
 
         // --- close all computing systems
+        checkpoint_close();
+        snapshot_close();
+        profile_close();
         stats_close();
         massbal_close();
         if ( !IgnoreRainfall ) rain_close();
@@ -646,6 +676,58 @@ int  DLLEXPORT swmm_getMassBalErr(float* runoffErr, float* flowErr,
 
 //=============================================================================
 
+int DLLEXPORT swmm_saveState(int handle)
+//
+//  Input:   handle = index (0 to 63) of the slot to save the state in
+//  Output:  returns an error code
+//  Purpose: saves the current state of a running simulation in memory,
+//           replacing any state previously saved under the same handle.
+//
+{
+    if ( ErrorCode ) return ErrorCode;
+    if ( !IsOpenFlag || !IsStartedFlag )
+    {
+        report_writeErrorMsg(ERR_NOT_OPEN, "");
+        return ErrorCode;
+    }
+    return snapshot_save(handle);
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_restoreState(int handle)
+//
+//  Input:   handle = index of a slot saved by swmm_saveState
+//  Output:  returns an error code
+//  Purpose: returns a running simulation to a state saved in memory.
+//
+//  Note:    the snapshot is kept so the simulation can be returned to the
+//           same state any number of times.
+{
+    if ( ErrorCode ) return ErrorCode;
+    if ( !IsOpenFlag || !IsStartedFlag )
+    {
+        report_writeErrorMsg(ERR_NOT_OPEN, "");
+        return ErrorCode;
+    }
+    return snapshot_restore(handle);
+}
+
+//=============================================================================
+
+int DLLEXPORT swmm_deleteState(int handle)
+//
+//  Input:   handle = index of a slot saved by swmm_saveState
+//  Output:  returns an error code
+//  Purpose: frees the memory used by a saved simulation state.
+//
+{
+    if ( ErrorCode ) return ErrorCode;
+    return snapshot_delete(handle);
+}
+
+//=============================================================================
+
 int  DLLEXPORT swmm_getVersion(void)
 //
 //  Input:   none
@@ -796,6 +878,46 @@ DateTime getDateTime(double elapsedMsec)
 
 //=============================================================================
 
+unsigned long long hashBytes(unsigned long long h, const void* x, size_t n)
+//
+//  Input:   h = hash of preceding bytes (FNV_OFFSET for the first block)
+//           x = array of bytes
+//           n = number of bytes
+//  Output:  returns updated hash
+//  Purpose: adds a block of bytes to a 64-bit FNV-1a hash.
+//
+{
+    const unsigned char* p = (const unsigned char *)x;
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+//=============================================================================
+
+int replaceFile(char* fname, char* newName)
+//
+//  Input:   fname = name of file to replace
+//           newName = name of file that replaces it
+//  Output:  returns TRUE if successful
+//  Purpose: renames a file, replacing any existing file of that name in a
+//           single step.
+//
+{
+#ifdef WINDOWS
+    return MoveFileExA(newName, fname,
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(newName, fname) == 0;
+#endif
+}
+
+//=============================================================================
+
 void  writecon(char *s)
 //
 //  Input:   s = a character string
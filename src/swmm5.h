@@ -50,6 +50,9 @@ int  DLLEXPORT   swmm_getMassBalErr(float* runoffErr, float* flowErr,
                  float* qualErr);
 int  DLLEXPORT   swmm_close(void);
 int  DLLEXPORT   swmm_getVersion(void);
+int  DLLEXPORT   swmm_saveState(int handle);
+int  DLLEXPORT   swmm_restoreState(int handle);
+int  DLLEXPORT   swmm_deleteState(int handle);
 
 #ifdef __cplusplus 
 }   // matches the linkage specification from above */ 
@@ -11,6 +11,15 @@
 //
 //   NOTE: Curve and Time Series objects in SWMM 5 are both modeled with
 //         TTable data structures.
+//
+//   Once a time series has been validated its data points (including
+//   those from an external file) are copied into arrays and its linked
+//   list is deleted. A lookup of a value in the series then starts from a
+//   cursor that holds the index of the data point ending the last time
+//   bracket used, and does a binary search when the time lies outside of
+//   that bracket and the next one. Each object that looks up values in a
+//   time series keeps a cursor of its own, so objects that share a series
+//   don't keep moving one another's bracket.
 //-----------------------------------------------------------------------------
 #define _CRT_SECURE_NO_DEPRECATE
 
@@ -24,6 +33,7 @@
 //-----------------------------------------------------------------------------
 int  table_getNextFileEntry(TTable* table, double* x, double* y);
 int  table_parseFileLine(char* line, TTable* table, double* x, double* y);
+static int findBracket(TTable* table, double x);
 
 
 //=============================================================================
@@ -44,6 +54,30 @@ double table_interpolate(double x, double x1, double y1, double x2, double y2)
 
 //=============================================================================
 
+double table_getIntervalError(double* coarse, double* fine, int n)
+//
+//  Input:   coarse = array of n values at evenly spaced x values
+//           fine = array of 2n-1 values at the same x values and at the
+//                  midpoint of each interval of coarse
+//           n = number of values in coarse
+//  Output:  returns the largest error of linear interpolation in coarse
+//  Purpose: estimates how accurately an evenly spaced table can be
+//           interpolated by comparing it with one of twice its resolution.
+//
+{
+    int    i;
+    double err, errMax = 0.0;
+
+    for (i = 1; i < n; i++)
+    {
+        err = fabs(fine[2*i-1] - 0.5 * (coarse[i-1] + coarse[i]));
+        if ( err > errMax ) errMax = err;
+    }
+    return errMax;
+}
+
+//=============================================================================
+
 int table_readCurve(char* tok[], int ntoks)
 //
 //  Input:   tok[] = array of string tokens
@@ -224,6 +258,9 @@ void   table_deleteEntries(TTable *table)
     table->firstEntry = NULL;
     table->lastEntry  = NULL;
     table->thisEntry  = NULL;
+    FREE(table->xData);
+    FREE(table->yData);
+    table->nPoints = 0;
 
     if (table->file.file)
     { 
@@ -255,6 +292,11 @@ void   table_init(TTable *table)
     table->file.mode = NO_FILE;
     table->file.file = NULL;
     table->curveType = -1;
+    table->nPoints = 0;
+    table->thisPoint = 0;
+    table->cursor = 0;
+    table->xData = NULL;
+    table->yData = NULL;
 }
 
 //=============================================================================
@@ -320,6 +362,15 @@ int table_getFirstEntry(TTable *table, double *x, double *y)
     *x = 0;
     *y = 0.0;
 
+    if ( table->xData )
+    {
+        if ( table->nPoints == 0 ) return FALSE;
+        *x = table->xData[0];
+        *y = table->yData[0];
+        table->thisPoint = 0;
+        return TRUE;
+    }
+
     if ( table->file.mode == USE_FILE )
     {
         if ( table->file.file == NULL ) return FALSE;
@@ -353,6 +404,15 @@ int table_getNextEntry(TTable *table, double *x, double *y)
 {
     TTableEntry *entry;
 
+    if ( table->xData )
+    {
+        if ( table->thisPoint + 1 >= table->nPoints ) return FALSE;
+        table->thisPoint++;
+        *x = table->xData[table->thisPoint];
+        *y = table->yData[table->thisPoint];
+        return TRUE;
+    }
+
     if ( table->file.mode == USE_FILE )
         return table_getNextFileEntry(table, x, y);
     
@@ -462,6 +522,25 @@ double table_intervalLookup(TTable *table, double x)
 //
 {
     double xx, yy;
+    int    n = table->nPoints;
+    int    lo, hi, mid;
+
+    // --- binary search for first data point beyond x in a series
+    //     held in arrays
+    if ( table->xData && n > 0 )
+    {
+        lo = 0;
+        hi = n - 1;
+        while ( lo < hi )
+        {
+            mid = (lo + hi) / 2;
+            if ( x < table->xData[mid] ) hi = mid;
+            else lo = mid + 1;
+        }
+        table->thisPoint = lo;
+        return table->yData[lo];
+    }
+
     table_getFirstEntry(table, &xx, &yy);
     if ( x < xx ) return yy;
     while ( table_getNextEntry(table, &xx, &yy) )
@@ -533,6 +612,64 @@ void   table_tseriesInit(TTable *table)
     table->x2 = table->x1;
     table->y2 = table->y1;
     table_getNextEntry(table, &(table->x2), &(table->y2));
+    table->cursor = 1;
+}
+
+//=============================================================================
+
+void   table_tseriesLoad(TTable *table)
+//
+//  Input:   table = pointer to a TTable structure
+//  Output:  none
+//  Purpose: copies the data points of a validated time series into arrays
+//           and deletes its linked list of data points (or closes its
+//           external file).
+//
+//  NOTE: if memory runs out the series is left as it was.
+//
+{
+    int     n = 0;
+    int     size = 0;
+    double  x, y;
+    double* xData = NULL;
+    double* yData = NULL;
+    double* p;
+    int     ok = TRUE;
+    int     more;
+
+    more = table_getFirstEntry(table, &x, &y);
+    while ( more )
+    {
+        // --- enlarge arrays when full
+        if ( n == size )
+        {
+            size = (size == 0) ? 64 : 2 * size;
+            p = (double *) realloc(xData, size * sizeof(double));
+            if ( p == NULL ) ok = FALSE;
+            else xData = p;
+            p = (double *) realloc(yData, size * sizeof(double));
+            if ( p == NULL ) ok = FALSE;
+            else yData = p;
+            if ( !ok ) break;
+        }
+        xData[n] = x;
+        yData[n] = y;
+        n++;
+        more = table_getNextEntry(table, &x, &y);
+    }
+
+    if ( !ok || n == 0 )
+    {
+        FREE(xData);
+        FREE(yData);
+        return;
+    }
+    table_deleteEntries(table);
+    table->xData = xData;
+    table->yData = yData;
+    table->nPoints = n;
+    table->thisPoint = 0;
+    table->cursor = 1;
 }
 
 //=============================================================================
@@ -551,6 +688,10 @@ double table_tseriesLookup(TTable *table, double x, char extend)
 //        returned.
 //
 {
+    // --- a series held in arrays uses its own cursor
+    if ( table->xData )
+        return table_tseriesCursorLookup(table, &table->cursor, x, extend);
+
     // --- x lies within current time bracket
     if ( table->x1 <= x
     &&   table->x2 >= x
@@ -593,6 +734,77 @@ double table_tseriesLookup(TTable *table, double x, char extend)
 
 //=============================================================================
 
+double table_tseriesCursorLookup(TTable *table, int *cursor, double x,
+                                 char extend)
+//
+//  Input:   table = pointer to a TTable structure
+//           cursor = index of data point ending caller's last time bracket
+//           x = a date/time value
+//           extend = TRUE if time series extended on either end
+//  Output:  cursor = index of data point ending time bracket containing x;
+//           returns a y-value
+//  Purpose: retrieves the y-value corresponding to a time series date,
+//           starting from a time bracket kept by the caller.
+//
+//  NOTE: the value found for a date doesn't depend on the cursor, so any
+//        index (e.g. 0) can be used to start with.
+//
+{
+    int     n = table->nPoints;
+    int     j = *cursor;
+    double* xx = table->xData;
+    double* yy = table->yData;
+
+    // --- series not held in arrays uses its own time bracket
+    if ( xx == NULL ) return table_tseriesLookup(table, x, extend);
+
+    // --- x lies before first or beyond last data point
+    if ( n <= 1 || x < xx[0] || x > xx[n-1] )
+    {
+        if ( extend == FALSE || n == 0 ) return 0.0;
+        if ( x < xx[0] ) return yy[0];
+        return yy[n-1];
+    }
+
+    // --- x lies outside of current time bracket (xx[j-1], xx[j]]
+    //     (the first bracket also includes xx[0])
+    if ( j < 1 || j >= n || x > xx[j] || x < xx[j-1] ||
+       ( x == xx[j-1] && j > 1 ) )
+    {
+        // --- check next bracket before searching the whole series
+        if ( j >= 1 && j < n-1 && x > xx[j] && x <= xx[j+1] ) j++;
+        else j = findBracket(table, x);
+        *cursor = j;
+    }
+    return table_interpolate(x, xx[j-1], yy[j-1], xx[j], yy[j]);
+}
+
+//=============================================================================
+
+int findBracket(TTable* table, double x)
+//
+//  Input:   table = pointer to a TTable structure
+//           x = a date/time value within the range of the table
+//  Output:  returns index of first data point at or beyond x (at least 1)
+//  Purpose: uses a binary search to find the time bracket that contains
+//           a date in a time series held in arrays.
+//
+{
+    int lo = 1;
+    int hi = table->nPoints - 1;
+    int mid;
+
+    while ( lo < hi )
+    {
+        mid = (lo + hi) / 2;
+        if ( x <= table->xData[mid] ) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+//=============================================================================
+
 double  table_getArea(TTable* table, double x)
 //
 //  Input:   table = pointer to a TTable structure
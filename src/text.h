@@ -67,6 +67,8 @@
 #define WARN08 "WARNING 08: elevation drop exceeds length for Conduit"
 #define WARN09 "WARNING 09: time series interval greater than recording interval for Rain Gage"
 #define WARN10 "WARNING 10: crest elevation is below downstream invert for regulator Link"
+#define WARN11 "WARNING 11: checkpoints are not written without a binary output file"
+#define WARN12 "WARNING 12: checkpoint file is incomplete or does not match project and was ignored:"
 
 // Analysis Option Keywords
 #define  w_FLOW_UNITS        "FLOW_UNITS"
@@ -108,6 +110,16 @@
 #define  w_SYS_FLOW_TOL      "SYS_FLOW_TOL"
 #define  w_LAT_FLOW_TOL      "LAT_FLOW_TOL"
 #define  w_IGNORE_RDII       "IGNORE_RDII"                                     //(5.1.004)
+#define  w_PROFILE_FILE      "PROFILE_FILE"
+#define  w_PROFILE           "PROFILE"
+#define  w_COST_FILE         "COST_FILE"
+#define  w_COST_STEP_LIMIT   "COST_STEP_LIMIT"
+#define  w_DEPTH_TABLES      "DEPTH_TABLES"
+#define  w_FORCE_MAIN_FRICTION "FORCE_MAIN_FRICTION"
+#define  w_CULVERT_TABLES    "CULVERT_TABLES"
+#define  w_THREADS           "THREADS"
+#define  w_CHECKPOINT        "CHECKPOINT"
+#define  w_EVERY             "EVERY"
 
 // Flow Units
 #define  w_CFS               "CFS"
@@ -150,6 +162,7 @@
 #define  w_TIMESERIES        "TIMESERIES"
 #define  w_TEMPERATURE       "TEMPERATURE"
 #define  w_FILE              "FILE"
+#define  w_GRID              "GRID"
 #define  w_RECOVERY          "RECOVERY"
 #define  w_DRYONLY           "DRY_ONLY"
 
@@ -236,6 +249,8 @@
 #define  w_FORCE_MAIN        "FORCE_MAIN"
 #define  w_H_W               "H-W"
 #define  w_D_W               "D-W" 
+#define  w_EXACT             "EXACT"
+#define  w_CACHED            "CACHED"
 
 // Link Offset Options
 #define  w_ELEVATION         "ELEVATION"
@@ -367,6 +382,7 @@
 #define  w_THEN              "THEN"
 #define  w_ELSE              "ELSE"
 #define  w_PRIORITY          "PRIORITY"
+#define  w_EVERY             "EVERY"
 
 // External Inflow Types
 #define  w_FLOW              "FLOW"
@@ -437,3 +453,4 @@
 #define  ws_GW_FLOW          "[GW_FLOW"     //Deprecated                       //(5.1.007)
 #define  ws_GWF              "[GWF"                                            //(5.1.007)
 #define  ws_ADJUST           "[ADJUSTMENT"                                     //(5.1.007)
+#define  ws_GRIDWEIGHT       "[GRIDWEIGHT"
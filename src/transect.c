@@ -19,6 +19,8 @@
 //  Constants
 //-----------------------------------------------------------------------------
 #define MAXSTATION 1500                // max. number of stations in a transect
+#define MAXTBLERROR 0.001              // max. interpolation error of area &
+                                       // hyd. radius tables (fraction of full)
 
 //-----------------------------------------------------------------------------
 //  Shared variables
@@ -51,7 +53,10 @@ static int    setParams(int transect, char* id, double x[]);
 static int    setManning(double n[]);
 static int    addStation(double x, double y);
 static double getFlow(int k, double a, double wp, int findFlow);
-static void   getGeometry(int i, int j, double y);
+static int    getTables(TTransect* transect, int n, double ymin, double ymax);
+static int    refineTables(int j, double ymin, double ymax);
+static void   deleteTables(TTransect* transect);
+static void   getGeometry(TTransect* transect, int i, double y);
 static void   getSliceGeom(int k, double y, double yu, double yd, double *w,
               double *a, double *wp);
 static void   setMaxSectionFactor(int transect);
@@ -85,7 +90,10 @@ void transect_delete(void)
 //  Purpose: deletes memory allocated for all transects.
 //
 {
+    int j;
+
     if ( Ntransects == 0 ) return;
+    for (j = 0; j < Ntransects; j++) deleteTables(&Transect[j]);
     FREE(Transect);
     Ntransects = 0;
 }
@@ -190,7 +198,7 @@ void  transect_validate(int j)
 //
 {
     int    i, nLast;
-    double dy, y, ymin, ymax;
+    double ymin, ymax;
     double oldNchannel = Nchannel;
 
     // --- check for valid transect data
@@ -243,25 +251,13 @@ void  transect_validate(int j)
     Station[Nstations] = Station[Nstations-1];
     Elev[Nstations] = Elev[0];
 
-    // --- determine size & depth increment for geometry tables
-    Transect[j].nTbl = N_TRANSECT_TBL;
-    dy = (ymax - ymin) / (double)(Transect[j].nTbl - 1);
-
-    // --- set 1st table entries to zero
-    Transect[j].areaTbl[0] = 0.0;
-    Transect[j].hradTbl[0] = 0.0;
-    Transect[j].widthTbl[0] = 0.0;
-
-    // --- compute geometry for each depth increment
-    y = ymin;
+    // --- compute geometry tables, refining them as needed
     Transect[j].wMax = 0.0;
-    for (i = 1; i < Transect[j].nTbl; i++)
+    if ( !getTables(&Transect[j], N_TRANSECT_TBL, ymin, ymax) ||
+         !refineTables(j, ymin, ymax) )
     {
-        y += dy;
-        Transect[j].areaTbl[i] = 0.0;
-        Transect[j].hradTbl[i] = 0.0;
-        Transect[j].widthTbl[i] = 0.0;
-        getGeometry(i, j, y);
+        report_writeErrorMsg(ERR_MEMORY, "");
+        return;
     }
 
     // --- determine max. section factor 
@@ -290,6 +286,108 @@ void  transect_validate(int j)
 
 //=============================================================================
 
+int  getTables(TTransect* transect, int n, double ymin, double ymax)
+//
+//  Input:   transect = a transect object
+//           n = number of entries in each geometry table
+//           ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: computes a transect's (un-normalized) geometry tables at n
+//           evenly spaced depths.
+//
+{
+    int    i;
+    double dy, y;
+
+    // --- allocate tables (entries at zero depth are zero)
+    transect->nTbl = n;
+    transect->areaTbl  = (double *) calloc(n, sizeof(double));
+    transect->hradTbl  = (double *) calloc(n, sizeof(double));
+    transect->widthTbl = (double *) calloc(n, sizeof(double));
+    if ( !transect->areaTbl || !transect->hradTbl || !transect->widthTbl )
+    {
+        deleteTables(transect);
+        return FALSE;
+    }
+
+    // --- compute geometry for each depth increment
+    dy = (ymax - ymin) / (double)(n - 1);
+    y = ymin;
+    for (i = 1; i < n; i++)
+    {
+        y += dy;
+        getGeometry(transect, i, y);
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+int  refineTables(int j, double ymin, double ymax)
+//
+//  Input:   j = transect index
+//           ymin = elevation of transect bottom
+//           ymax = elevation of transect top
+//  Output:  returns TRUE if successful, FALSE if out of memory
+//  Purpose: halves the depth interval of a transect's geometry tables
+//           until linear interpolation of area and hyd. radius is accurate
+//           to within MAXTBLERROR (or the tables reach N_TRANSECT_TBL_MAX).
+//
+//  Note:    top width is not tested since it jumps where the water level
+//           reaches a flat overbank no matter how fine the table is.
+{
+    TTransect fine;
+    int       n;
+    double    aFull, rFull, err;
+
+    while ( Transect[j].nTbl < N_TRANSECT_TBL_MAX )
+    {
+        // --- compute tables with twice as many intervals
+        fine = Transect[j];
+        if ( !getTables(&fine, 2 * Transect[j].nTbl - 1, ymin, ymax) )
+            return FALSE;
+
+        // --- keep current tables if they interpolate the finer ones
+        n = fine.nTbl - 1;
+        aFull = fine.areaTbl[n];
+        rFull = fine.hradTbl[n];
+        if ( aFull > 0.0 && rFull > 0.0 )
+        {
+            err = MAX(table_getIntervalError(Transect[j].areaTbl,
+                          fine.areaTbl, Transect[j].nTbl) / aFull,
+                      table_getIntervalError(Transect[j].hradTbl,
+                          fine.hradTbl, Transect[j].nTbl) / rFull);
+        }
+        else err = 0.0;
+        if ( err <= MAXTBLERROR )
+        {
+            deleteTables(&fine);
+            break;
+        }
+        deleteTables(&Transect[j]);
+        Transect[j] = fine;
+    }
+    return TRUE;
+}
+
+//=============================================================================
+
+void  deleteTables(TTransect* transect)
+//
+//  Input:   transect = a transect object
+//  Output:  none
+//  Purpose: frees the memory used by a transect's geometry tables.
+//
+{
+    FREE(transect->areaTbl);
+    FREE(transect->hradTbl);
+    FREE(transect->widthTbl);
+    transect->nTbl = 0;
+}
+
+//=============================================================================
+
 int  setManning(double n[])
 //
 //  Input:   n[] = array of Manning's n values
@@ -366,10 +464,10 @@ int  addStation(double y, double x)
 
 //=============================================================================
 
-void  getGeometry(int i, int j, double y)
+void  getGeometry(TTransect* transect, int i, double y)
 //
-//  Input:   i = index of current entry in geometry tables
-//           j = transect index
+//  Input:   transect = a transect object
+//           i = index of current entry in geometry tables
 //           y = depth of current entry in geometry tables
 //  Output:  none
 //  Purpose: computes entries in a transect's geometry tables at a given depth. 
@@ -417,8 +515,8 @@ void  getGeometry(int i, int j, double y)
         // --- update total transect values
         wpSum += wp;
         aSum += a;
-        Transect[j].areaTbl[i] += a;
-        Transect[j].widthTbl[i] += w;
+        transect->areaTbl[i] += a;
+        transect->widthTbl[i] += w;
 
         // --- must update flow if station elevation is above water level
         if ( Elev[k] >= y ) findFlow = TRUE;
@@ -437,9 +535,9 @@ void  getGeometry(int i, int j, double y)
 
     // --- find hyd. radius table entry solving Manning eq. with
     //     total flow, total area, and main channel n
-    aSum = Transect[j].areaTbl[i];
-    if ( aSum == 0.0 ) Transect[j].hradTbl[i] = Transect[j].hradTbl[i-1];
-    else Transect[j].hradTbl[i] = pow(qSum * Nchannel / 1.49 / aSum, 1.5);
+    aSum = transect->areaTbl[i];
+    if ( aSum == 0.0 ) transect->hradTbl[i] = transect->hradTbl[i-1];
+    else transect->hradTbl[i] = pow(qSum * Nchannel / 1.49 / aSum, 1.5);
 }
 
 //=============================================================================
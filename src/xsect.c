@@ -13,6 +13,7 @@
 //      getAofY   -- returns area given depth
 //      getWofY   -- returns top width given depth
 //      getRofY   -- returns hyd. radius given depth
+//      getAandRofY -- returns both area and hyd. radius given depth
 //      getYofA   -- returns flow depth given area
 //      getRofA   -- returns hyd. radius given area
 //      getSofA   -- returns section factor given area
@@ -82,9 +83,12 @@ typedef struct
 //  External functions (declared in funcs.h)
 //-----------------------------------------------------------------------------
 //  xsect_isOpen
+//  xsect_solvesForYnorm
+//  xsect_solvesForYcrit
 //  xsect_setParams
 //  xsect_setIrregXsectParams
 //  xsect_setCustomXsectParams
+//  xsect_isSame
 //  xsect_getAmax
 //  xsect_getSofA
 //  xsect_getYofA
@@ -104,6 +108,8 @@ static void   evalSofA(double a, double* f, double* df, void* p);
 static double tabular_getdSdA(TXsect* xsect, double a, double *table, int nItems);
 static double generic_getdSdA(TXsect* xsect, double a);
 static double lookup(double x, double *table, int nItems);
+static void   lookup2(double x, double *table1, double *table2, int nItems,
+              double *y1, double *y2);
 static double invLookup(double y, double *table, int nItems);
 static int    locate(double y, double *table, int nItems);
 
@@ -198,6 +204,58 @@ int xsect_isOpen(int type)
 
 //=============================================================================
 
+int xsect_solvesForYnorm(int type)
+//
+//  Input:   type = type of xsection shape
+//  Output:  returns 1 if normal depth requires a root finder, 0 if not
+//  Purpose: determines if the area at a given section factor is found
+//           iteratively (see generic_getAofS) for a xsection type.
+//
+{
+    switch ( type )
+    {
+      case DUMMY:
+      case CIRCULAR:
+      case FORCE_MAIN:
+      case EGGSHAPED:
+      case HORSESHOE:
+      case GOTHIC:
+      case CATENARY:
+      case SEMIELLIPTICAL:
+      case BASKETHANDLE:
+      case SEMICIRCULAR:
+        return 0;
+      default:
+        return 1;
+    }
+}
+
+//=============================================================================
+
+int xsect_solvesForYcrit(int type)
+//
+//  Input:   type = type of xsection shape
+//  Output:  returns 1 if critical depth requires a root finder, 0 if not
+//  Purpose: determines if critical depth has no analytical expression
+//           for a xsection type.
+//
+{
+    switch ( type )
+    {
+      case DUMMY:
+      case RECT_OPEN:
+      case RECT_CLOSED:
+      case TRIANGULAR:
+      case PARABOLIC:
+      case POWERFUNC:
+        return 0;
+      default:
+        return 1;
+    }
+}
+
+//=============================================================================
+
 int xsect_setParams(TXsect *xsect, int type, double p[], double ucf)
 //
 //  Input:   xsect = ptr. to a cross section data structure
@@ -634,11 +692,12 @@ void xsect_setIrregXsectParams(TXsect *xsect)
     xsect->sFull = xsect->aFull * pow(xsect->rFull, 2./3.);
     xsect->sMax = Transect[index].sMax;
     xsect->aBot = Transect[index].aMax;
+    if ( wTbl == NULL ) return;
     
     // Search transect's width table up to point where width decreases
     iMax = 0;
     wMax = wTbl[0];
-    for (i = 1; i < N_TRANSECT_TBL; i++)
+    for (i = 1; i < Transect[index].nTbl; i++)
     {
 	if ( wTbl[i] < wMax ) break;
 	wMax = wTbl[i];
@@ -646,7 +705,8 @@ void xsect_setIrregXsectParams(TXsect *xsect)
     }
 
     // Determine height at lowest widest point
-    xsect->ywMax = xsect->yFull * (double)iMax / (double)(N_TRANSECT_TBL-1);
+    xsect->ywMax = xsect->yFull * (double)iMax /
+                   (double)(Transect[index].nTbl-1);
 }
 
 //=============================================================================
@@ -670,11 +730,12 @@ void xsect_setCustomXsectParams(TXsect *xsect)
     xsect->sFull = xsect->aFull * pow(xsect->rFull, 2./3.);
     xsect->sMax  = Shape[index].sMax * yFull * yFull * pow(yFull, 2./3.);
     xsect->aBot  = Shape[index].aMax * yFull * yFull;
+    if ( wTbl == NULL ) return;
 
     // Search shape's width table up to point where width decreases
     iMax = 0;
     wMax = wTbl[0];
-    for (i = 1; i < N_SHAPE_TBL; i++)
+    for (i = 1; i < Shape[index].nTbl; i++)
     {
 	if ( wTbl[i] < wMax ) break;
 	wMax = wTbl[i];
@@ -682,7 +743,32 @@ void xsect_setCustomXsectParams(TXsect *xsect)
     }
 
     // Determine height at lowest widest point
-    xsect->ywMax = yFull * (double)iMax / (double)(N_SHAPE_TBL-1);
+    xsect->ywMax = yFull * (double)iMax / (double)(Shape[index].nTbl-1);
+}
+
+//=============================================================================
+
+int xsect_isSame(TXsect* x1, TXsect* x2)
+//
+//  Input:   x1, x2 = ptrs. to two cross section data structures
+//  Output:  returns TRUE if the cross sections are identical
+//  Purpose: compares every parameter of two cross sections.
+//
+{
+    return ( x1->type        == x2->type &&
+             x1->culvertCode == x2->culvertCode &&
+             x1->transect    == x2->transect &&
+             x1->yFull       == x2->yFull &&
+             x1->wMax        == x2->wMax &&
+             x1->ywMax       == x2->ywMax &&
+             x1->aFull       == x2->aFull &&
+             x1->rFull       == x2->rFull &&
+             x1->sFull       == x2->sFull &&
+             x1->sMax        == x2->sMax &&
+             x1->yBot        == x2->yBot &&
+             x1->aBot        == x2->aBot &&
+             x1->sBot        == x2->sBot &&
+             x1->rBot        == x2->rBot );
 }
 
 //=============================================================================
@@ -806,11 +892,13 @@ double xsect_getYofA(TXsect *xsect, double a)
 
       case IRREGULAR:
         return xsect->yFull * invLookup(alpha,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+            Transect[xsect->transect].areaTbl,
+            Transect[xsect->transect].nTbl);
 
       case CUSTOM:
         return xsect->yFull * invLookup(alpha,
-            Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
+            Shape[Curve[xsect->transect].refersTo].areaTbl,
+            Shape[Curve[xsect->transect].refersTo].nTbl);
 
       case ARCH:
         return xsect->yFull * invLookup(alpha, A_Arch, N_A_Arch);
@@ -890,11 +978,13 @@ double xsect_getAofY(TXsect *xsect, double y)
  
       case IRREGULAR:
         return xsect->aFull * lookup(yNorm,
-            Transect[xsect->transect].areaTbl, N_TRANSECT_TBL);
+            Transect[xsect->transect].areaTbl,
+            Transect[xsect->transect].nTbl);
  
       case CUSTOM:
         return xsect->aFull * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].areaTbl, N_SHAPE_TBL);
+            Shape[Curve[xsect->transect].refersTo].areaTbl,
+            Shape[Curve[xsect->transect].refersTo].nTbl);
 
      case RECT_CLOSED:  return y * xsect->wMax;
 
@@ -971,11 +1061,13 @@ double xsect_getWofY(TXsect *xsect, double y)
 
       case IRREGULAR:
         return xsect->wMax * lookup(yNorm,
-            Transect[xsect->transect].widthTbl, N_TRANSECT_TBL);
+            Transect[xsect->transect].widthTbl,
+            Transect[xsect->transect].nTbl);
 
       case CUSTOM:
         return xsect->wMax * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].widthTbl, N_SHAPE_TBL);
+            Shape[Curve[xsect->transect].refersTo].widthTbl,
+            Shape[Curve[xsect->transect].refersTo].nTbl);
 
       case RECT_CLOSED: return xsect->wMax;
 
@@ -1041,11 +1133,13 @@ double xsect_getRofY(TXsect *xsect, double y)
 
       case IRREGULAR:
         return xsect->rFull * lookup(yNorm,
-            Transect[xsect->transect].hradTbl, N_TRANSECT_TBL);
+            Transect[xsect->transect].hradTbl,
+            Transect[xsect->transect].nTbl);
 
       case CUSTOM:
         return xsect->rFull * lookup(yNorm,
-            Shape[Curve[xsect->transect].refersTo].hradTbl, N_SHAPE_TBL);
+            Shape[Curve[xsect->transect].refersTo].hradTbl,
+            Shape[Curve[xsect->transect].refersTo].nTbl);
 
       case RECT_TRIANG:  return rect_triang_getRofY(xsect, y);
 
@@ -1065,6 +1159,94 @@ double xsect_getRofY(TXsect *xsect, double y)
 
 //=============================================================================
 
+void xsect_getAandRofY(TXsect *xsect, double y, double *a, double *r)
+//
+//  Input:   xsect = ptr. to a cross section data structure
+//           y = depth (ft)
+//  Output:  a = area (ft2)
+//           r = hydraulic radius (ft)
+//  Purpose: computes xsection's area and hydraulic radius at a given depth.
+//
+//  Note:    gives the same results as xsect_getAofY and xsect_getRofY but
+//           locates the depth in a shape's geometry tables only once.
+//
+{
+    double  yNorm = y / xsect->yFull;
+    double* aTbl;
+    double* rTbl;
+    int     n;
+
+    if ( y <= 0.0 )
+    {
+        *a = 0.0;
+        *r = xsect_getRofY(xsect, y);
+        return;
+    }
+    switch ( xsect->type )
+    {
+      case FORCE_MAIN:
+      case CIRCULAR:
+        aTbl = A_Circ;  rTbl = R_Circ;  n = N_A_Circ;  break;
+
+      case EGGSHAPED:
+        aTbl = A_Egg;  rTbl = R_Egg;  n = N_A_Egg;  break;
+
+      case HORSESHOE:
+        aTbl = A_Horseshoe;  rTbl = R_Horseshoe;  n = N_A_Horseshoe;  break;
+
+      case BASKETHANDLE:
+        aTbl = A_Baskethandle;  rTbl = R_Baskethandle;
+        n = N_A_Baskethandle;
+        break;
+
+      case HORIZ_ELLIPSE:
+        aTbl = A_HorizEllipse;  rTbl = R_HorizEllipse;
+        n = N_A_HorizEllipse;
+        break;
+
+      case VERT_ELLIPSE:
+        aTbl = A_VertEllipse;  rTbl = R_VertEllipse;  n = N_A_VertEllipse;
+        break;
+
+      case ARCH:
+        aTbl = A_Arch;  rTbl = R_Arch;  n = N_A_Arch;  break;
+
+      case IRREGULAR:
+        aTbl = Transect[xsect->transect].areaTbl;
+        rTbl = Transect[xsect->transect].hradTbl;
+        n = Transect[xsect->transect].nTbl;
+        break;
+
+      case CUSTOM:
+        aTbl = Shape[Curve[xsect->transect].refersTo].areaTbl;
+        rTbl = Shape[Curve[xsect->transect].refersTo].hradTbl;
+        n = Shape[Curve[xsect->transect].refersTo].nTbl;
+        break;
+
+      // --- shapes whose hyd. radius is found from their area
+      case RECT_CLOSED:
+      case RECT_OPEN:
+      case MOD_BASKET:
+      case GOTHIC:
+      case CATENARY:
+      case SEMIELLIPTICAL:
+      case SEMICIRCULAR:
+        *a = xsect_getAofY(xsect, y);
+        *r = xsect_getRofA(xsect, *a);
+        return;
+
+      default:
+        *a = xsect_getAofY(xsect, y);
+        *r = xsect_getRofY(xsect, y);
+        return;
+    }
+    lookup2(yNorm, aTbl, rTbl, n, a, r);
+    *a = xsect->aFull * *a;
+    *r = xsect->rFull * *r;
+}
+
+//=============================================================================
+
 double xsect_getRofA(TXsect *xsect, double a)
 //
 //  Input:   xsect = ptr. to a cross section data structure
@@ -1439,6 +1621,54 @@ double lookup(double x, double *table, int nItems)
 
 //=============================================================================
 
+void lookup2(double x, double *table1, double *table2, int nItems,
+             double *y1, double *y2)
+//
+//  Input:   x = value of independent variable in two geometry tables
+//           table1, table2 = ptrs. to geometry tables
+//           nItems = number of equally spaced items in each table
+//  Output:  y1 = value looked up in table1
+//           y2 = value looked up in table2
+//  Purpose: performs the same lookup as lookup() in two tables that share
+//           the same x values.
+//
+{
+    double  delta, x0, x1, f, y;
+    int     i;
+
+    // --- find which segment of table contains x
+    delta = 1.0 / (nItems-1);
+    i = (int)(x / delta);
+    if ( i >= nItems - 1 )
+    {
+        *y1 = table1[nItems-1];
+        *y2 = table2[nItems-1];
+        return;
+    }
+
+    // --- compute x at start and end of segment
+    x0 = i * delta;
+    x1 = (i+1) * delta;
+
+    // --- linearly interpolate y-values
+    *y1 = table1[i] + (x - x0) * (table1[i+1] - table1[i]) / delta;
+    *y2 = table2[i] + (x - x0) * (table2[i+1] - table2[i]) / delta;
+
+    // --- use quadratic interpolation for low x value
+    if ( i < 2 )
+    {
+        f = (x - x0) * (x - x1) / (delta*delta);
+        y = *y1 + f * (table1[i]/2.0 - table1[i+1] + table1[i+2]/2.0);
+        if ( y > 0.0 ) *y1 = y;
+        y = *y2 + f * (table2[i]/2.0 - table2[i+1] + table2[i+2]/2.0);
+        if ( y > 0.0 ) *y2 = y;
+    }
+    if ( *y1 < 0.0 ) *y1 = 0.0;
+    if ( *y2 < 0.0 ) *y2 = 0.0;
+}
+
+//=============================================================================
+
 double invLookup(double y, double *table, int nItems)
 //
 //  Input:   y = value of dependent variable in a geometry table